@@ -0,0 +1,174 @@
+// src/background_model.cpp
+#include "background_model.h"
+#include "temperature_conversion.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    // 背景平面中未初始化像素的标记值 (首帧或运动补偿移入的边缘)
+    const float UNINITIALIZED_TEMPERATURE = -1000.0f;
+    const float UNINITIALIZED_THRESHOLD = -500.0f;
+    // 新像素的初始波动幅度取一个较大值，使其在学习充分前不会被判为稳定
+    const float INITIAL_DEVIATION = 100.0f;
+
+    // freeze 非零的像素保持原值 (未初始化的像素保持未初始化，不会被判为稳定背景)
+    void updateRow(const float *t, const uchar *freeze, float *bg, float *dev, int n, float lr)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 vlr = cv::vx_setall_f32(lr);
+        const cv::v_float32 vuninit = cv::vx_setall_f32(UNINITIALIZED_THRESHOLD);
+        const cv::v_float32 vinit_dev = cv::vx_setall_f32(INITIAL_DEVIATION);
+        const cv::v_uint32 vzero = cv::vx_setall_u32(0);
+        for (; x <= n - VL; x += VL)
+        {
+            cv::v_float32 vt = cv::vx_load(t + x);
+            cv::v_float32 vb0 = cv::vx_load(bg + x);
+            cv::v_float32 vd0 = cv::vx_load(dev + x);
+            cv::v_float32 fresh = cv::v_lt(vb0, vuninit);
+            cv::v_float32 vb = cv::v_select(fresh, vt, vb0);
+            cv::v_float32 vd = cv::v_select(fresh, vinit_dev, vd0);
+            cv::v_float32 diff = cv::v_sub(vt, vb);
+            vb = cv::v_fma(vlr, diff, vb);
+            vd = cv::v_fma(vlr, cv::v_sub(cv::v_abs(diff), vd), vd);
+            cv::v_float32 hold = cv::v_reinterpret_as_f32(cv::v_ne(cv::vx_load_expand_q(freeze + x), vzero));
+            cv::v_store(bg + x, cv::v_select(hold, vb0, vb));
+            cv::v_store(dev + x, cv::v_select(hold, vd0, vd));
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            if (freeze[x] != 0)
+                continue;
+            if (bg[x] < UNINITIALIZED_THRESHOLD)
+            {
+                bg[x] = t[x];
+                dev[x] = INITIAL_DEVIATION;
+            }
+            float diff = t[x] - bg[x];
+            bg[x] += lr * diff;
+            dev[x] += lr * (std::fabs(diff) - dev[x]);
+        }
+    }
+}
+
+BackgroundTemperatureModel::BackgroundTemperatureModel(float learning_rate, int warmup_frames)
+    : learning_rate_(learning_rate), warmup_frames_(warmup_frames), frames_learned_(0), compact_(false)
+{
+}
+
+void BackgroundTemperatureModel::reset()
+{
+    background_.release();
+    deviation_.release();
+    background_compact_.release();
+    deviation_compact_.release();
+    frames_learned_ = 0;
+    compact_ = false;
+}
+
+void BackgroundTemperatureModel::update(const cv::Mat &temp_matrix, const FrameMotion *motion, const cv::Mat &freeze_mask)
+{
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Background model input must be CV_32FC1 or CV_16SC1." << std::endl;
+        return;
+    }
+
+    if (background_.size() != temp_matrix.size())
+    {
+        background_.create(temp_matrix.size(), CV_32FC1);
+        background_.setTo(cv::Scalar(UNINITIALIZED_TEMPERATURE));
+        deviation_.create(temp_matrix.size(), CV_32FC1);
+        deviation_.setTo(cv::Scalar(INITIAL_DEVIATION));
+        frames_learned_ = 0;
+    }
+    else if (motion)
+    {
+        shiftStatePlane(background_, *motion, cv::Scalar(UNINITIALIZED_TEMPERATURE));
+        shiftStatePlane(deviation_, *motion, cv::Scalar(INITIAL_DEVIATION));
+    }
+
+    compact_ = isCompactTemperature(temp_matrix);
+    if (compact_)
+    {
+        background_compact_.create(temp_matrix.size(), CV_16SC1);
+        deviation_compact_.create(temp_matrix.size(), CV_16SC1);
+    }
+
+    const bool has_freeze = freeze_mask.size() == temp_matrix.size() && freeze_mask.type() == CV_8UC1;
+    std::vector<uchar> zero_row(temp_matrix.cols, 0);
+    std::vector<float> row_scratch;
+    for (int y = 0; y < temp_matrix.rows; ++y)
+    {
+        float *bg = background_.ptr<float>(y);
+        float *dev = deviation_.ptr<float>(y);
+        updateRow(temperatureRow(temp_matrix, y, row_scratch), has_freeze ? freeze_mask.ptr<uchar>(y) : zero_row.data(),
+                  bg, dev, temp_matrix.cols, learning_rate_);
+        if (compact_)
+        {
+            // 行仍在 L1 中，顺带写出定点副本 (未初始化像素的标记值在定点范围内，仍不会被判为稳定)
+            compactTemperatureRow(bg, background_compact_.ptr<short>(y), temp_matrix.cols);
+            compactTemperatureRow(dev, deviation_compact_.ptr<short>(y), temp_matrix.cols);
+        }
+    }
+
+    if (frames_learned_ < warmup_frames_)
+        ++frames_learned_;
+}
+
+bool loadBackgroundModelEnabled(const std::string &filename)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+    if (!fs["background_model_enabled"].isInt())
+    {
+        std::cout << "Warning: background_model_enabled not found in " << filename << std::endl;
+        return false;
+    }
+    return static_cast<int>(fs["background_model_enabled"]) != 0;
+}
+
+bool loadStaticExclusionMask(const std::string &filename, const cv::Size &image_size, cv::Mat &allow_mask)
+{
+    allow_mask.release();
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    cv::Mat rects;
+    fs["static_exclusion_rects"] >> rects;
+    fs.release();
+    if (rects.empty())
+        return false;
+    if (rects.cols != 4)
+    {
+        std::cout << "Warning: static_exclusion_rects must have 4 columns (x y width height)." << std::endl;
+        return false;
+    }
+
+    rects.convertTo(rects, CV_32S);
+    allow_mask.create(image_size, CV_8UC1);
+    allow_mask.setTo(cv::Scalar(255));
+    const cv::Rect frame(0, 0, image_size.width, image_size.height);
+    for (int i = 0; i < rects.rows; ++i)
+    {
+        cv::Rect r(rects.at<int>(i, 0), rects.at<int>(i, 1), rects.at<int>(i, 2), rects.at<int>(i, 3));
+        r &= frame;
+        if (r.area() > 0)
+            allow_mask(r).setTo(cv::Scalar(0));
+    }
+    std::cout << "Loaded " << rects.rows << " static exclusion regions." << std::endl;
+    return true;
+}
@@ -0,0 +1,78 @@
+// src/background_model.h
+#ifndef BACKGROUND_MODEL_H
+#define BACKGROUND_MODEL_H
+
+#include "utils.h"
+#include "ego_motion.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+
+// --- 逐像素背景温度模型 ---
+// 以很小的学习率跟踪每个像素缓慢变化的温度 (背景) 及其波动幅度。
+// 发动机、暖风机、灯具等稳定高温物体会被学进背景：背景高于火焰阈值、当前温度接近背景且波动小的像素
+// 在标记连通域之前就被剔除 (见 candidate_mask.h)，既不产生误报目标，也不再消耗后续轮廓处理。
+// 稳定燃烧的火焰 (尤其是 8 位输入中饱和的火焰核心) 同样波动很小，因此本帧检出的热点与已确认的火焰轨迹
+// 所在像素冻结学习 (见 update 的 freeze_mask)，只有从未被检出的区域才会学进背景。
+// 模型默认关闭，由参数文件 background_model_enabled 启用。
+// 学习状态始终为浮点 (学习率很小，0.1 °C 定点会截断每帧的增量)；输入为 CV_16SC1 时同一遍中另存一份 0.1 °C 定点副本，
+// 候选掩码的背景剔除因此可以留在 int16 内核中。
+
+class BackgroundTemperatureModel
+{
+public:
+    /**
+     * @param learning_rate 背景学习率 (每帧)，应远小于时域 EMA 系数
+     * @param warmup_frames 学习帧数不足时不做背景剔除
+     */
+    explicit BackgroundTemperatureModel(float learning_rate = BACKGROUND_LEARNING_RATE,
+                                        int warmup_frames = BACKGROUND_WARMUP_FRAMES);
+
+    /**
+     * @brief 用当前帧更新背景与波动幅度 (SIMD 单次遍历)
+     *
+     * @param temp_matrix 当前帧温度矩阵 (CV_32FC1，或 CV_16SC1 的 0.1 °C 定点)
+     * @param motion 可选帧间运动，非空时先把背景平移到当前帧坐标
+     * @param freeze_mask 可选 CV_8UC1 掩码 (与温度矩阵同尺寸)，非零像素保持原背景与波动幅度不学习
+     */
+    void update(const cv::Mat &temp_matrix, const FrameMotion *motion = nullptr, const cv::Mat &freeze_mask = cv::Mat());
+
+    bool isReady() const { return frames_learned_ >= warmup_frames_; }
+    // 与最近一次 update 的温度矩阵格式相同 (CV_32FC1 或 CV_16SC1)
+    const cv::Mat &background() const { return compact_ ? background_compact_ : background_; }
+    const cv::Mat &deviation() const { return compact_ ? deviation_compact_ : deviation_; }
+
+    void reset();
+
+private:
+    float learning_rate_;
+    int warmup_frames_;
+    int frames_learned_;
+    bool compact_;
+    cv::Mat background_; // CV_32FC1
+    cv::Mat deviation_;  // CV_32FC1，|T - 背景| 的滑动平均
+    cv::Mat background_compact_; // CV_16SC1 副本，只在定点输入时更新
+    cv::Mat deviation_compact_;
+};
+
+/**
+ * @brief 从参数文件读取是否启用背景温度模型 (background_model_enabled)
+ *
+ * @param filename 参数文件路径
+ * @return background_model_enabled=1 时返回 true
+ */
+bool loadBackgroundModelEnabled(const std::string &filename);
+
+/**
+ * @brief 从参数文件加载静态屏蔽区域
+ *
+ * @param filename 参数文件路径
+ * @param image_size 温度矩阵尺寸
+ * @param allow_mask 输出 CV_8UC1 掩码，255 为允许检测，0 为屏蔽
+ * @return 配置了屏蔽区域返回 true；未配置时 allow_mask 为空
+ *
+ * 读取 static_exclusion_rects (N x 4 矩阵，每行 x y width height，像素坐标)。
+ */
+bool loadStaticExclusionMask(const std::string &filename, const cv::Size &image_size, cv::Mat &allow_mask);
+
+#endif // BACKGROUND_MODEL_H
@@ -0,0 +1,233 @@
+// src/blob_classifier.cpp
+#include "blob_classifier.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void computeBlobFeatures(const HotSpot &spot, float *features)
+{
+    double area = std::max(spot.area_pixels, 1.0);
+    double perimeter = spot.contour_pixels.size() > 1 ? cv::arcLength(spot.contour_pixels, true) : 0.0;
+    double circularity = perimeter > 0.0 ? 4.0 * CV_PI * area / (perimeter * perimeter) : 0.0;
+
+    // 二阶中心矩给出等效椭圆的长短轴比，归一化中心矩给出 Hu φ1
+    double elongation = 1.0;
+    double hu1 = 0.0;
+    if (!spot.contour_pixels.empty())
+    {
+        cv::Moments m = cv::moments(spot.contour_pixels);
+        if (m.m00 > 0.0)
+        {
+            double common = std::sqrt(4.0 * m.mu11 * m.mu11 + (m.mu20 - m.mu02) * (m.mu20 - m.mu02));
+            double major = 0.5 * (m.mu20 + m.mu02 + common);
+            double minor = 0.5 * (m.mu20 + m.mu02 - common);
+            if (minor > 1e-9)
+                elongation = std::sqrt(major / minor);
+            hu1 = m.nu20 + m.nu02;
+        }
+    }
+
+    features[0] = static_cast<float>(std::log(area));
+    features[1] = spot.max_temperature;
+    features[2] = spot.mean_temperature;
+    features[3] = spot.temperature_stddev;
+    features[4] = spot.max_temperature - spot.mean_temperature;
+    features[5] = static_cast<float>(std::min(circularity, 1.0));
+    features[6] = static_cast<float>(std::min(elongation, 20.0));
+    features[7] = static_cast<float>(hu1);
+    features[8] = std::max(spot.flicker_score, 0.0f);
+    features[9] = spot.flicker_score >= 0.0f ? 1.0f : 0.0f;
+    features[10] = spot.area_growth_rate;
+    features[11] = spot.rate_of_rise;
+}
+
+void computeBlobFeatureMatrix(const std::vector<HotSpot> &hot_spots, cv::Mat &features)
+{
+    features.create(static_cast<int>(hot_spots.size()), BLOB_FEATURE_COUNT, CV_32FC1);
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+        computeBlobFeatures(hot_spots[i], features.ptr<float>(static_cast<int>(i)));
+}
+
+BlobClassifier::BlobClassifier()
+    : last_inference_us_(0.0),
+      max_inference_us_(0.0),
+      classified_frames_(0),
+      budget_overrun_frames_(0)
+{
+}
+
+bool BlobClassifier::setModel(const cv::Mat &feature_mean, const cv::Mat &feature_scale, const std::vector<Layer> &layers)
+{
+    if (feature_mean.total() != static_cast<size_t>(BLOB_FEATURE_COUNT) ||
+        feature_scale.total() != static_cast<size_t>(BLOB_FEATURE_COUNT) || layers.empty())
+    {
+        std::cerr << "Error: Blob classifier model does not match " << BLOB_FEATURE_COUNT << " features." << std::endl;
+        return false;
+    }
+
+    int inputs = BLOB_FEATURE_COUNT;
+    for (const auto &layer : layers)
+    {
+        if (layer.weights.cols != inputs || layer.bias.total() != static_cast<size_t>(layer.weights.rows))
+        {
+            std::cerr << "Error: Blob classifier layer dimensions are inconsistent." << std::endl;
+            return false;
+        }
+        inputs = layer.weights.rows;
+    }
+    if (inputs != 1)
+    {
+        std::cerr << "Error: Blob classifier output layer must have a single unit." << std::endl;
+        return false;
+    }
+
+    feature_mean.reshape(1, 1).convertTo(feature_mean_, CV_32F);
+    feature_scale.reshape(1, 1).convertTo(feature_scale_, CV_32F);
+    layers_.clear();
+    for (const auto &layer : layers)
+    {
+        Layer copy;
+        layer.weights.convertTo(copy.weights, CV_32F);
+        layer.bias.reshape(1, layer.weights.rows).convertTo(copy.bias, CV_32F);
+        layers_.push_back(copy);
+    }
+    return true;
+}
+
+bool BlobClassifier::load(const std::string &filename)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cout << "Warning: Could not open blob classifier model: " << filename << std::endl;
+        return false;
+    }
+
+    int feature_count = 0;
+    fs["feature_count"] >> feature_count;
+    if (feature_count != BLOB_FEATURE_COUNT)
+    {
+        std::cerr << "Error: Blob classifier expects " << BLOB_FEATURE_COUNT << " features, model has " << feature_count << std::endl;
+        return false;
+    }
+
+    cv::Mat mean, scale;
+    fs["feature_mean"] >> mean;
+    fs["feature_scale"] >> scale;
+    std::vector<Layer> layers;
+    cv::FileNode layers_node = fs["layers"];
+    for (cv::FileNodeIterator it = layers_node.begin(); it != layers_node.end(); ++it)
+    {
+        Layer layer;
+        (*it)["weights"] >> layer.weights;
+        (*it)["bias"] >> layer.bias;
+        layers.push_back(layer);
+    }
+    fs.release();
+
+    if (!setModel(mean, scale, layers))
+        return false;
+    std::cout << "Loaded blob classifier with " << layers_.size() << " layers from " << filename << std::endl;
+    return true;
+}
+
+bool BlobClassifier::save(const std::string &filename) const
+{
+    cv::FileStorage fs(filename, cv::FileStorage::WRITE);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not write blob classifier model: " << filename << std::endl;
+        return false;
+    }
+    fs << "feature_count" << BLOB_FEATURE_COUNT;
+    fs << "feature_mean" << feature_mean_;
+    fs << "feature_scale" << feature_scale_;
+    fs << "layers" << "[";
+    for (const auto &layer : layers_)
+        fs << "{" << "weights" << layer.weights << "bias" << layer.bias << "}";
+    fs << "]";
+    return true;
+}
+
+void BlobClassifier::predict(const cv::Mat &features, cv::Mat &probabilities) const
+{
+    if (!isLoaded() || features.empty())
+    {
+        probabilities.release();
+        return;
+    }
+
+    // 标准化：(x - mean) * scale，按行广播
+    cv::Mat activations(features.size(), CV_32FC1);
+    for (int i = 0; i < features.rows; ++i)
+    {
+        const float *src = features.ptr<float>(i);
+        const float *mean = feature_mean_.ptr<float>();
+        const float *scale = feature_scale_.ptr<float>();
+        float *dst = activations.ptr<float>(i);
+        for (int j = 0; j < features.cols; ++j)
+            dst[j] = (src[j] - mean[j]) * scale[j];
+    }
+
+    // 每层一次矩阵乘法 (N x in) * (out x in)^T，批量处理整帧热点
+    cv::Mat next;
+    for (size_t l = 0; l < layers_.size(); ++l)
+    {
+        const Layer &layer = layers_[l];
+        cv::gemm(activations, layer.weights, 1.0, cv::noArray(), 0.0, next, cv::GEMM_2_T);
+        const bool is_output = (l + 1 == layers_.size());
+        const float *bias = layer.bias.ptr<float>();
+        for (int i = 0; i < next.rows; ++i)
+        {
+            float *row = next.ptr<float>(i);
+            for (int j = 0; j < next.cols; ++j)
+            {
+                float v = row[j] + bias[j];
+                row[j] = is_output ? 1.0f / (1.0f + std::exp(-v)) : std::max(v, 0.0f);
+            }
+        }
+        std::swap(activations, next);
+    }
+    probabilities = activations;
+}
+
+void BlobClassifier::classify(std::vector<HotSpot> &hot_spots)
+{
+    last_inference_us_ = 0.0;
+    if (!isLoaded() || hot_spots.empty())
+        return;
+
+    int64 start = cv::getTickCount();
+    cv::Mat features, probabilities;
+    computeBlobFeatureMatrix(hot_spots, features);
+    predict(features, probabilities);
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+        hot_spots[i].fire_probability = probabilities.at<float>(static_cast<int>(i), 0);
+    last_inference_us_ = (cv::getTickCount() - start) * 1e6 / cv::getTickFrequency();
+
+    ++classified_frames_;
+    max_inference_us_ = std::max(max_inference_us_, last_inference_us_);
+    if (last_inference_us_ > BLOB_CLASSIFIER_BUDGET_MICROSECONDS)
+        ++budget_overrun_frames_;
+}
+
+bool loadBlobClassifier(const std::string &params_file, BlobClassifier &classifier)
+{
+    cv::FileStorage fs(params_file, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << params_file << std::endl;
+        return false;
+    }
+    std::string model_file;
+    if (fs["blob_classifier_model"].isString())
+        fs["blob_classifier_model"] >> model_file;
+    fs.release();
+
+    if (model_file.empty())
+    {
+        std::cout << "Warning: blob_classifier_model not found in " << params_file << ", classifier disabled." << std::endl;
+        return false;
+    }
+    return classifier.load(model_file);
+}
@@ -0,0 +1,105 @@
+// src/blob_classifier.h
+#ifndef BLOB_CLASSIFIER_H
+#define BLOB_CLASSIFIER_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 热点火焰/非火焰分类器 ---
+// 小型全连接网络 (MLP)，纯 C++ 实现，不依赖外部推理运行时。
+// 每帧把全部热点的特征拼成一个 N x BLOB_FEATURE_COUNT 矩阵，一次批量前向计算 (cv::gemm)。
+// 隐层 ReLU，输出层单个神经元 + sigmoid，输出火焰概率。
+//
+// 模型文件 (cv::FileStorage，yml/xml)：
+//   feature_count  特征维数，须等于 BLOB_FEATURE_COUNT
+//   feature_mean   1 x D 标准化均值
+//   feature_scale  1 x D 标准化系数 (1/标准差)
+//   layers         序列，每项 { weights: out x in, bias: out x 1 }
+// 模型由 tools/train_blob_classifier 离线训练生成。
+
+const int BLOB_FEATURE_COUNT = 12;
+
+/**
+ * @brief 计算单个热点的分类特征
+ *
+ * @param spot 热点 (需已经过 HotspotTracker 更新，以获得闪烁得分和面积增长率)
+ * @param features 输出 BLOB_FEATURE_COUNT 个特征
+ *
+ * 特征依次为：log(面积)、最高温度、平均温度、温度标准差、最高与平均温差、圆形度、
+ * 长短轴比、Hu 不变矩 φ1、闪烁得分、闪烁是否可判定、面积增长率、升温速率。
+ */
+void computeBlobFeatures(const HotSpot &spot, float *features);
+
+/**
+ * @brief 批量计算特征矩阵
+ *
+ * @param hot_spots 当前帧热点
+ * @param features 输出 N x BLOB_FEATURE_COUNT (CV_32FC1)
+ */
+void computeBlobFeatureMatrix(const std::vector<HotSpot> &hot_spots, cv::Mat &features);
+
+class BlobClassifier
+{
+public:
+    struct Layer
+    {
+        cv::Mat weights; // out x in, CV_32FC1
+        cv::Mat bias;    // out x 1, CV_32FC1
+    };
+
+    BlobClassifier();
+
+    bool load(const std::string &filename);
+    bool save(const std::string &filename) const;
+
+    /**
+     * @brief 直接设置模型参数 (训练工具使用)
+     */
+    bool setModel(const cv::Mat &feature_mean, const cv::Mat &feature_scale, const std::vector<Layer> &layers);
+
+    bool isLoaded() const { return !layers_.empty(); }
+
+    /**
+     * @brief 批量推理
+     *
+     * @param features N x BLOB_FEATURE_COUNT (CV_32FC1)
+     * @param probabilities 输出 N x 1 火焰概率 (CV_32FC1)
+     */
+    void predict(const cv::Mat &features, cv::Mat &probabilities) const;
+
+    /**
+     * @brief 对一帧的全部热点批量打分，写入 HotSpot::fire_probability
+     *
+     * 耗时记录在 lastInferenceMicroseconds()；超过 BLOB_CLASSIFIER_BUDGET_MICROSECONDS 的帧只计数，
+     * 不逐帧输出，由调用方在汇总时报告 (见 budgetOverrunFrames())。
+     */
+    void classify(std::vector<HotSpot> &hot_spots);
+
+    double lastInferenceMicroseconds() const { return last_inference_us_; }
+    double maxInferenceMicroseconds() const { return max_inference_us_; }
+    int classifiedFrames() const { return classified_frames_; }
+    int budgetOverrunFrames() const { return budget_overrun_frames_; }
+
+private:
+    cv::Mat feature_mean_;  // 1 x D
+    cv::Mat feature_scale_; // 1 x D
+    std::vector<Layer> layers_;
+    double last_inference_us_;
+    double max_inference_us_;
+    int classified_frames_;      // 有热点且做了推理的帧数
+    int budget_overrun_frames_;  // 其中超出预算的帧数
+};
+
+/**
+ * @brief 从参数文件读取分类器模型路径并加载
+ *
+ * @param params_file 参数文件路径，读取 blob_classifier_model
+ * @param classifier 输出分类器
+ * @return 成功加载模型返回 true；未配置或加载失败时分类器保持为空，检测流程不受影响
+ */
+bool loadBlobClassifier(const std::string &params_file, BlobClassifier &classifier);
+
+#endif // BLOB_CLASSIFIER_H
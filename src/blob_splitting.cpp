@@ -0,0 +1,205 @@
+// src/blob_splitting.cpp
+#include "blob_splitting.h"
+#include "temperature_conversion.h"
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+#include <queue>
+
+namespace
+{
+    struct Peak
+    {
+        cv::Point position; // 外接矩形内坐标
+        float temperature;
+    };
+
+    // 两峰值连线上的最低温度
+    float saddleTemperature(const cv::Mat &smooth, const cv::Point &a, const cv::Point &b)
+    {
+        float lowest = FLT_MAX;
+        cv::LineIterator it(smooth, a, b, 8);
+        for (int i = 0; i < it.count; ++i, ++it)
+            lowest = std::min(lowest, smooth.at<float>(it.pos()));
+        return lowest;
+    }
+
+    void findPeaks(const cv::Mat &smooth, const cv::Mat &roi_mask, float threshold,
+                   const BlobSplitConfig &config, std::vector<Peak> &peaks)
+    {
+        // 局部极大值：等于邻域膨胀结果的像素。饱和 (削顶) 火源的平台上每个像素都满足条件，
+        // 相邻的极大值像素温度必然相等，按连通域合并为一个候选 (取最靠近连通域质心的像素)，
+        // 否则每个平台像素都要沿连线求一次鞍点，代价为 面积 x 对角线
+        const int k = 2 * config.min_peak_separation_pixels + 1;
+        cv::Mat dilated;
+        cv::dilate(smooth, dilated, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(k, k)));
+
+        cv::Mat maxima(smooth.size(), CV_8UC1);
+        for (int y = 0; y < smooth.rows; ++y)
+        {
+            const float *s = smooth.ptr<float>(y);
+            const float *d = dilated.ptr<float>(y);
+            const uchar *m = roi_mask.ptr<uchar>(y);
+            uchar *out = maxima.ptr<uchar>(y);
+            for (int x = 0; x < smooth.cols; ++x)
+                out[x] = (m[x] && s[x] >= d[x] && s[x] > threshold) ? 255 : 0;
+        }
+        cv::Mat labels, stats, centroids;
+        const int count = cv::connectedComponentsWithStats(maxima, labels, stats, centroids, 8, CV_32S);
+        if (count <= 1)
+            return;
+
+        std::vector<Peak> candidates(count - 1);
+        std::vector<double> best_distance(count - 1, DBL_MAX);
+        for (int y = 0; y < smooth.rows; ++y)
+        {
+            const int *l = labels.ptr<int>(y);
+            const float *s = smooth.ptr<float>(y);
+            for (int x = 0; x < smooth.cols; ++x)
+            {
+                if (l[x] == 0)
+                    continue;
+                const double dx = x - centroids.at<double>(l[x], 0), dy = y - centroids.at<double>(l[x], 1);
+                const double distance = dx * dx + dy * dy;
+                if (distance < best_distance[l[x] - 1])
+                {
+                    best_distance[l[x] - 1] = distance;
+                    candidates[l[x] - 1] = {cv::Point(x, y), s[x]};
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Peak &a, const Peak &b)
+                  { return a.temperature > b.temperature; });
+
+        // 从最高峰开始，距离过近或鞍点不够深的峰值归入已接受的峰
+        const float min_sep2 = static_cast<float>(config.min_peak_separation_pixels * config.min_peak_separation_pixels);
+        for (const auto &candidate : candidates)
+        {
+            if (static_cast<int>(peaks.size()) >= config.max_peaks)
+                break;
+            bool distinct = true;
+            for (const auto &peak : peaks)
+            {
+                cv::Point d = candidate.position - peak.position;
+                if (d.x * d.x + d.y * d.y < min_sep2 ||
+                    candidate.temperature - saddleTemperature(smooth, candidate.position, peak.position) < config.min_peak_prominence_celsius)
+                {
+                    distinct = false;
+                    break;
+                }
+            }
+            if (distinct)
+                peaks.push_back(candidate);
+        }
+    }
+
+    // 种子泛洪：按温度从高到低扩展，每个像素归属于最先到达的峰值
+    void floodFromPeaks(const cv::Mat &smooth, const cv::Mat &roi_mask, const std::vector<Peak> &peaks, cv::Mat &labels)
+    {
+        struct Item
+        {
+            float temperature;
+            int x, y;
+            bool operator<(const Item &other) const { return temperature < other.temperature; }
+        };
+
+        labels = cv::Mat::zeros(smooth.size(), CV_32SC1);
+        std::priority_queue<Item> queue;
+        for (size_t i = 0; i < peaks.size(); ++i)
+        {
+            labels.at<int>(peaks[i].position) = static_cast<int>(i) + 1;
+            queue.push({peaks[i].temperature, peaks[i].position.x, peaks[i].position.y});
+        }
+
+        const int dx[4] = {1, -1, 0, 0};
+        const int dy[4] = {0, 0, 1, -1};
+        while (!queue.empty())
+        {
+            Item item = queue.top();
+            queue.pop();
+            const int label = labels.at<int>(item.y, item.x);
+            for (int n = 0; n < 4; ++n)
+            {
+                int nx = item.x + dx[n], ny = item.y + dy[n];
+                if (nx < 0 || ny < 0 || nx >= smooth.cols || ny >= smooth.rows)
+                    continue;
+                if (!roi_mask.at<uchar>(ny, nx) || labels.at<int>(ny, nx) != 0)
+                    continue;
+                labels.at<int>(ny, nx) = label;
+                queue.push({smooth.at<float>(ny, nx), nx, ny});
+            }
+        }
+    }
+}
+
+bool loadBlobSplitConfig(const std::string &filename, BlobSplitConfig &config)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["split_merged_blobs"].isInt())
+        config.enabled = static_cast<int>(fs["split_merged_blobs"]) != 0;
+    else
+        std::cout << "Warning: split_merged_blobs not found in " << filename << std::endl;
+    if (fs["split_min_blob_area_pixels"].isReal() || fs["split_min_blob_area_pixels"].isInt())
+        fs["split_min_blob_area_pixels"] >> config.min_blob_area_pixels;
+    if (fs["split_min_peak_separation_pixels"].isInt())
+        fs["split_min_peak_separation_pixels"] >> config.min_peak_separation_pixels;
+    if (fs["split_min_peak_prominence_celsius"].isReal())
+        fs["split_min_peak_prominence_celsius"] >> config.min_peak_prominence_celsius;
+    fs.release();
+    return true;
+}
+
+bool splitMergedBlob(const cv::Mat &temp_matrix,
+                     const cv::Rect &bounding_box,
+                     const cv::Mat &roi_mask,
+                     float threshold,
+                     const BlobSplitConfig &config,
+                     std::vector<std::vector<cv::Point>> &sub_contours)
+{
+    sub_contours.clear();
+    if (bounding_box.area() == 0 || roi_mask.size() != bounding_box.size())
+        return false;
+
+    // 轻微平滑，避免单像素噪声形成伪峰；定点温度在 ROI 内先换回浮点摄氏度
+    cv::Mat smooth;
+    if (isCompactTemperature(temp_matrix))
+    {
+        temp_matrix(bounding_box).convertTo(smooth, CV_32F, temperatureUnitCelsius(temp_matrix));
+        cv::GaussianBlur(smooth, smooth, cv::Size(5, 5), 0);
+    }
+    else
+    {
+        cv::GaussianBlur(temp_matrix(bounding_box), smooth, cv::Size(5, 5), 0);
+    }
+
+    std::vector<Peak> peaks;
+    findPeaks(smooth, roi_mask, threshold, config, peaks);
+    if (peaks.size() < 2)
+        return false;
+
+    cv::Mat labels;
+    floodFromPeaks(smooth, roi_mask, peaks, labels);
+
+    cv::Mat part_mask;
+    for (size_t i = 0; i < peaks.size(); ++i)
+    {
+        part_mask = (labels == static_cast<int>(i) + 1);
+        std::vector<std::vector<cv::Point>> part_contours;
+        cv::findContours(part_mask, part_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, bounding_box.tl());
+        if (part_contours.empty())
+            continue;
+        // 泛洪结果是四连通的单块区域，取最大轮廓即可
+        auto largest = std::max_element(part_contours.begin(), part_contours.end(),
+                                        [](const std::vector<cv::Point> &a, const std::vector<cv::Point> &b)
+                                        { return cv::contourArea(a) < cv::contourArea(b); });
+        sub_contours.push_back(*largest);
+    }
+    return sub_contours.size() >= 2;
+}
@@ -0,0 +1,51 @@
+// src/blob_splitting.h
+#ifndef BLOB_SPLITTING_H
+#define BLOB_SPLITTING_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 粘连热点拆分 ---
+// 形态学闭运算会把相邻但独立的火源连成一个轮廓，其质心落在两者之间，喷射时哪个都打不中。
+// 对面积较大的轮廓，在其外接矩形内寻找温度峰值作为种子，按温度从高到低做种子泛洪
+// (以温度取反为地形的分水岭)，把轮廓拆成多个子热点。
+// 两个峰值之间连线上的最低温度 (鞍点) 必须比较低的峰值低 min_peak_prominence，
+// 否则视为同一火源内部的温度起伏，不拆分。
+// 只处理大轮廓的外接矩形，计算量与轮廓面积成正比，与整帧尺寸无关。
+
+struct BlobSplitConfig
+{
+    bool enabled = false;
+    double min_blob_area_pixels = 400.0;     // 面积小于该值的轮廓不尝试拆分
+    int min_peak_separation_pixels = 8;      // 峰值之间的最小距离
+    float min_peak_prominence_celsius = 20.0f; // 峰值相对鞍点的最小高度
+    int max_peaks = 8;                       // 单个轮廓最多拆分数
+};
+
+/**
+ * @brief 从参数文件加载拆分配置 (split_* 键)
+ */
+bool loadBlobSplitConfig(const std::string &filename, BlobSplitConfig &config);
+
+/**
+ * @brief 尝试按温度峰值拆分一个粘连轮廓
+ *
+ * @param temp_matrix 整帧温度矩阵 (CV_32FC1)
+ * @param bounding_box 轮廓外接矩形
+ * @param roi_mask 外接矩形内的轮廓掩码 (CV_8UC1)
+ * @param threshold 峰值须高于该温度
+ * @param config 拆分配置
+ * @param sub_contours 输出子轮廓 (整帧像素坐标)
+ * @return 拆分为 2 个及以上子轮廓时返回 true
+ */
+bool splitMergedBlob(const cv::Mat &temp_matrix,
+                     const cv::Rect &bounding_box,
+                     const cv::Mat &roi_mask,
+                     float threshold,
+                     const BlobSplitConfig &config,
+                     std::vector<std::vector<cv::Point>> &sub_contours);
+
+#endif // BLOB_SPLITTING_H
@@ -0,0 +1,48 @@
+// src/camera_parameters.cpp
+#include "camera_parameters.h"
+#include <iostream>
+
+bool loadCameraParameters(const std::string &filename, CameraParams &params)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        std::cerr << "Using default/hardcoded parameters." << std::endl;
+        return false;
+    }
+
+    if (!fs["camera_matrix"].empty())
+        fs["camera_matrix"] >> params.camera_matrix;
+    else
+        std::cout << "Warning: camera_matrix not found in " << filename << ", using default intrinsics." << std::endl;
+
+    if (!fs["distortion_coefficients"].empty())
+        fs["distortion_coefficients"] >> params.dist_coeffs;
+    else
+        std::cout << "Warning: distortion_coefficients not found in " << filename << std::endl;
+
+    if (fs["HFOV_degrees"].isReal())
+        fs["HFOV_degrees"] >> params.hfov_degrees;
+    else
+        std::cout << "Warning: HFOV_degrees not found in " << filename << std::endl;
+
+    if (fs["VFOV_degrees"].isReal())
+        fs["VFOV_degrees"] >> params.vfov_degrees;
+    else
+        std::cout << "Warning: VFOV_degrees not found in " << filename << std::endl;
+
+    if (fs["nozzle_offset_azimuth_degrees"].isReal())
+        fs["nozzle_offset_azimuth_degrees"] >> params.nozzle_azimuth_offset;
+    else
+        std::cout << "Warning: nozzle_offset_azimuth_degrees not found in " << filename << std::endl;
+
+    if (fs["nozzle_offset_pitch_degrees"].isReal())
+        fs["nozzle_offset_pitch_degrees"] >> params.nozzle_pitch_offset;
+    else
+        std::cout << "Warning: nozzle_offset_pitch_degrees not found in " << filename << std::endl;
+
+    fs.release();
+    std::cout << "Parameters loaded from " << filename << std::endl;
+    return true;
+}
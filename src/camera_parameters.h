@@ -0,0 +1,33 @@
+// src/camera_parameters.h
+#ifndef CAMERA_PARAMETERS_H
+#define CAMERA_PARAMETERS_H
+
+#include <opencv2/core.hpp>
+#include <string>
+
+// 相机内参、视场角与喷嘴安装偏移，主程序与 tools/ 下的离线工具共用
+// 默认内参的主点位于 384x288 温度矩阵中心
+struct CameraParams
+{
+    cv::Mat camera_matrix = (cv::Mat_<double>(3, 3) << 500.0, 0.0, 192.0,
+                             0.0, 500.0, 144.0,
+                             0.0, 0.0, 1.0);
+    cv::Mat dist_coeffs = cv::Mat::zeros(4, 1, CV_64F);
+    float hfov_degrees = 60.0f;
+    float vfov_degrees = 45.0f;
+    float nozzle_azimuth_offset = 0.0f;
+    float nozzle_pitch_offset = 0.0f;
+};
+
+/**
+ * @brief 加载相机参数
+ *
+ * @param filename 参数文件路径
+ * @param params 相机参数输出，文件中缺失的项保持默认值
+ * @return 如果成功打开参数文件则返回true，否则返回false
+ *
+ * 此函数从指定的文件中加载相机参数，包括内参矩阵、畸变系数和视场角等。如果文件打开失败或某些参数缺失，则函数会输出错误或警告信息，并使用默认参数。
+ */
+bool loadCameraParameters(const std::string &filename, CameraParams &params);
+
+#endif // CAMERA_PARAMETERS_H
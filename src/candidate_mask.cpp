@@ -0,0 +1,266 @@
+// src/candidate_mask.cpp
+#include "candidate_mask.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    struct RowPointers
+    {
+        const float *t;
+        const float *thr;
+        const uchar *extra;
+        const uchar *allow;
+        const float *bg;
+        const float *dev;
+        uchar *out;
+    };
+
+    template <bool HasBackground>
+    void candidateRow(const RowPointers &p, int n, float tolerance)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 vtol = cv::vx_setall_f32(tolerance);
+        const cv::v_uint32 vall = cv::vx_setall_u32(0xFFFFFFFFu);
+
+        // 返回 (热, 保留) 两组按 u32 表示的布尔值
+        auto step = [&](int i, cv::v_uint32 &hot, cv::v_uint32 &keep)
+        {
+            cv::v_float32 vt = cv::vx_load(p.t + i);
+            cv::v_float32 vthr = cv::vx_load(p.thr + i);
+            hot = cv::v_reinterpret_as_u32(cv::v_gt(vt, vthr));
+            if (HasBackground)
+            {
+                cv::v_float32 vb = cv::vx_load(p.bg + i);
+                cv::v_float32 vd = cv::vx_load(p.dev + i);
+                cv::v_float32 stable = cv::v_and(cv::v_and(cv::v_gt(vb, vthr), cv::v_lt(cv::v_abs(cv::v_sub(vt, vb)), vtol)),
+                                                 cv::v_lt(vd, vtol));
+                keep = cv::v_reinterpret_as_u32(cv::v_not(stable));
+            }
+            else
+            {
+                keep = vall;
+            }
+        };
+
+        for (; x <= n - 4 * VL; x += 4 * VL)
+        {
+            cv::v_uint32 h0, h1, h2, h3, k0, k1, k2, k3;
+            step(x, h0, k0);
+            step(x + VL, h1, k1);
+            step(x + 2 * VL, h2, k2);
+            step(x + 3 * VL, h3, k3);
+            cv::v_uint8 hot = cv::v_or(cv::v_pack_b(h0, h1, h2, h3), cv::vx_load(p.extra + x));
+            cv::v_uint8 keep = cv::v_and(cv::v_pack_b(k0, k1, k2, k3), cv::vx_load(p.allow + x));
+            // extra/allow 可能是任意非零值，统一归一化为 0/255
+            cv::v_uint8 result = cv::v_and(cv::v_gt(hot, cv::vx_setall_u8(0)), cv::v_gt(keep, cv::vx_setall_u8(0)));
+            cv::v_store(p.out + x, result);
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            const float threshold = p.thr[x];
+            bool hot = p.t[x] > threshold || p.extra[x] != 0;
+            bool keep = p.allow[x] != 0;
+            if (HasBackground && keep)
+            {
+                bool stable = p.bg[x] > threshold && std::fabs(p.t[x] - p.bg[x]) < tolerance && p.dev[x] < tolerance;
+                keep = !stable;
+            }
+            p.out[x] = (hot && keep) ? 255 : 0;
+        }
+    }
+
+    struct CompactRowPointers
+    {
+        const short *t;
+        const short *thr;
+        const uchar *extra;
+        const uchar *allow;
+        const short *bg;
+        const short *dev;
+        uchar *out;
+    };
+
+    // 定点 (0.1 °C) 温度行：阈值比较与背景剔除直接在 int16 上完成，每个向量处理的像素数是浮点的两倍
+    template <bool HasBackground>
+    void candidateRowCompact(const CompactRowPointers &p, int n, short tolerance)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_int16>::vlanes();
+        const cv::v_uint8 vzero = cv::vx_setall_u8(0);
+        const cv::v_int16 vtol = cv::vx_setall_s16(tolerance);
+        const cv::v_uint16 vtol_u = cv::v_reinterpret_as_u16(vtol);
+        const cv::v_uint16 vall = cv::vx_setall_u16(0xFFFF);
+
+        // 返回 (热, 保留) 两组按 u16 表示的布尔值
+        auto step = [&](int i, cv::v_uint16 &hot, cv::v_uint16 &keep)
+        {
+            cv::v_int16 vt = cv::vx_load(p.t + i);
+            cv::v_int16 vthr = cv::vx_load(p.thr + i);
+            hot = cv::v_reinterpret_as_u16(cv::v_gt(vt, vthr));
+            if (HasBackground)
+            {
+                cv::v_int16 vb = cv::vx_load(p.bg + i);
+                cv::v_uint16 stable = cv::v_and(cv::v_and(cv::v_reinterpret_as_u16(cv::v_gt(vb, vthr)), cv::v_lt(cv::v_absdiff(vt, vb), vtol_u)),
+                                                cv::v_reinterpret_as_u16(cv::v_lt(cv::vx_load(p.dev + i), vtol)));
+                keep = cv::v_not(stable);
+            }
+            else
+            {
+                keep = vall;
+            }
+        };
+
+        for (; x <= n - 2 * VL; x += 2 * VL)
+        {
+            cv::v_uint16 h0, h1, k0, k1;
+            step(x, h0, k0);
+            step(x + VL, h1, k1);
+            cv::v_uint8 hot = cv::v_or(cv::v_pack_b(h0, h1), cv::vx_load(p.extra + x));
+            cv::v_uint8 keep = cv::v_and(cv::v_pack_b(k0, k1), cv::vx_load(p.allow + x));
+            cv::v_store(p.out + x, cv::v_and(cv::v_gt(hot, vzero), cv::v_gt(keep, vzero)));
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            const short threshold = p.thr[x];
+            bool hot = p.t[x] > threshold || p.extra[x] != 0;
+            bool keep = p.allow[x] != 0;
+            if (HasBackground && keep)
+            {
+                bool stable = p.bg[x] > threshold && std::abs(p.t[x] - p.bg[x]) < tolerance && p.dev[x] < tolerance;
+                keep = !stable;
+            }
+            p.out[x] = (hot && keep) ? 255 : 0;
+        }
+    }
+
+    // 区域统计：按编号直接索引，耗时与区域数量无关
+    template <typename T>
+    void accumulateZoneRow(const T *t, float unit, const uchar *out, const ushort *ids, int n, std::vector<ZoneFrameStats> &stats)
+    {
+        const size_t zone_count = stats.size();
+        for (int x = 0; x < n; ++x)
+        {
+            const ushort id = ids[x];
+            if (id == 0 || id > zone_count)
+                continue;
+            ZoneFrameStats &s = stats[id - 1];
+            const float celsius = t[x] * unit;
+            s.pixel_count++;
+            s.candidate_pixels += out[x] != 0;
+            s.temperature_sum += celsius;
+            s.max_temperature = std::max(s.max_temperature, celsius);
+        }
+    }
+}
+
+CandidateMaskInputs cropCandidateMaskInputs(const CandidateMaskInputs &inputs, const cv::Size &full_size, const cv::Rect &roi)
+{
+    auto crop = [&](const cv::Mat &m) { return m.size() == full_size ? m(roi) : cv::Mat(); };
+    CandidateMaskInputs cropped;
+    cropped.threshold_map = crop(inputs.threshold_map);
+    cropped.extra_candidates = crop(inputs.extra_candidates);
+    cropped.allow_mask = crop(inputs.allow_mask);
+    cropped.background = crop(inputs.background);
+    cropped.background_deviation = crop(inputs.background_deviation);
+    cropped.stable_tolerance = inputs.stable_tolerance;
+    return cropped;
+}
+
+void computeCandidateMask(const cv::Mat &temp_matrix,
+                          float threshold,
+                          const CandidateMaskInputs &inputs,
+                          cv::Mat &mask)
+{
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Candidate mask input must be CV_32FC1 or CV_16SC1." << std::endl;
+        mask.release();
+        return;
+    }
+
+    const cv::Size size = temp_matrix.size();
+    const bool has_extra = inputs.extra_candidates.size() == size && inputs.extra_candidates.type() == CV_8UC1;
+    const bool has_allow = inputs.allow_mask.size() == size && inputs.allow_mask.type() == CV_8UC1;
+    const bool has_threshold_map = inputs.threshold_map.size() == size && isTemperatureMatrix(inputs.threshold_map);
+    const bool has_zones = inputs.zone_stats && inputs.zone_ids.size() == size && inputs.zone_ids.type() == CV_16UC1;
+    // 定点背景只与定点温度配合使用；定点温度配浮点背景时逐行展开为浮点
+    const int background_type = inputs.background.type();
+    const bool has_background = inputs.background.size() == size && inputs.background_deviation.size() == size &&
+                                inputs.background_deviation.type() == background_type &&
+                                (background_type == CV_32FC1 || (background_type == CV_16SC1 && isCompactTemperature(temp_matrix)));
+    const bool native_compact = isCompactTemperature(temp_matrix) && (!has_background || background_type == CV_16SC1);
+
+    // 缺省的阈值图/extra/allow 用常量行代替，避免在内层循环中分支
+    std::vector<float> threshold_row(size.width, threshold);
+    std::vector<short> compact_threshold_row(size.width, toDeciCelsius(threshold));
+    std::vector<uchar> zero_row(size.width, 0), full_row(size.width, 255);
+    std::vector<float> temp_scratch, threshold_scratch;
+    std::vector<short> compact_threshold_scratch;
+
+    if (inputs.zone_stats)
+        std::fill(inputs.zone_stats->begin(), inputs.zone_stats->end(), ZoneFrameStats());
+
+    mask.create(size, CV_8UC1);
+    for (int y = 0; y < size.height; ++y)
+    {
+        const uchar *extra = has_extra ? inputs.extra_candidates.ptr<uchar>(y) : zero_row.data();
+        const uchar *allow = has_allow ? inputs.allow_mask.ptr<uchar>(y) : full_row.data();
+        uchar *out = mask.ptr<uchar>(y);
+
+        if (native_compact)
+        {
+            const short *t = temp_matrix.ptr<short>(y);
+            const short *thr = compact_threshold_row.data();
+            if (has_threshold_map && isCompactTemperature(inputs.threshold_map))
+            {
+                thr = inputs.threshold_map.ptr<short>(y);
+            }
+            else if (has_threshold_map)
+            {
+                compact_threshold_scratch.resize(size.width);
+                compactTemperatureRow(inputs.threshold_map.ptr<float>(y), compact_threshold_scratch.data(), size.width);
+                thr = compact_threshold_scratch.data();
+            }
+            CompactRowPointers p{t, thr, extra, allow, nullptr, nullptr, out};
+            if (has_background)
+            {
+                p.bg = inputs.background.ptr<short>(y);
+                p.dev = inputs.background_deviation.ptr<short>(y);
+                candidateRowCompact<true>(p, size.width, toDeciCelsius(inputs.stable_tolerance));
+            }
+            else
+            {
+                candidateRowCompact<false>(p, size.width, 0);
+            }
+            if (has_zones)
+                accumulateZoneRow(t, temperatureUnitCelsius(temp_matrix), out, inputs.zone_ids.ptr<ushort>(y), size.width, *inputs.zone_stats);
+            continue;
+        }
+
+        RowPointers p;
+        p.t = temperatureRow(temp_matrix, y, temp_scratch);
+        p.thr = has_threshold_map ? temperatureRow(inputs.threshold_map, y, threshold_scratch) : threshold_row.data();
+        p.extra = extra;
+        p.allow = allow;
+        p.bg = has_background ? inputs.background.ptr<float>(y) : nullptr;
+        p.dev = has_background ? inputs.background_deviation.ptr<float>(y) : nullptr;
+        p.out = out;
+
+        if (has_background)
+            candidateRow<true>(p, size.width, inputs.stable_tolerance);
+        else
+            candidateRow<false>(p, size.width, inputs.stable_tolerance);
+        if (has_zones)
+            accumulateZoneRow(p.t, 1.0f, p.out, inputs.zone_ids.ptr<ushort>(y), size.width, *inputs.zone_stats);
+    }
+}
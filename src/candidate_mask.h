@@ -0,0 +1,60 @@
+// src/candidate_mask.h
+#ifndef CANDIDATE_MASK_H
+#define CANDIDATE_MASK_H
+
+#include "temperature_conversion.h"
+#include "utils.h"
+#include "zone_map.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+// --- 候选像素掩码 ---
+// 热点检测中标记连通域之前的逐像素判定，全部条件在一次 SIMD 遍历中完成：
+//
+//   candidate = ((T > threshold) | extra) & allow & !static_hot
+//   static_hot = (背景 > threshold) & (|T - 背景| < tolerance) & (背景波动 < tolerance)
+//
+// threshold 为标量阈值，或逐像素阈值图 (见 threshold_map.h) 中的对应值。
+//
+// 所有可选输入为空时退化为普通的温度阈值。
+// 提供区域编号图时，同一遍中按编号累积各区域的像素数、候选像素数和温度统计。
+
+struct CandidateMaskInputs
+{
+    cv::Mat threshold_map;       // CV_32FC1 或 CV_16SC1 逐像素阈值，为空时使用标量阈值
+    cv::Mat extra_candidates;    // CV_8UC1，非零像素无论温度都作为候选 (如升温速率掩码)
+    cv::Mat allow_mask;          // CV_8UC1，0 为屏蔽区域
+    cv::Mat background;          // CV_32FC1 背景温度，定点温度矩阵时也可为 CV_16SC1 (0.1 °C)
+    cv::Mat background_deviation; // 背景波动幅度，格式与 background 相同
+    float stable_tolerance = BACKGROUND_STABLE_TOLERANCE_CELSIUS;
+    cv::Mat zone_ids;            // CV_16UC1 区域编号图 (ZoneMap::zoneIds)
+    std::vector<ZoneFrameStats> *zone_stats = nullptr; // 按区域下标输出统计，须由调用方预先设为区域数量
+};
+
+/**
+ * @brief 计算候选像素掩码
+ *
+ * @param temp_matrix 温度矩阵 (CV_32FC1，或 CV_16SC1 的 0.1 °C 定点)
+ * @param threshold 温度阈值 (未提供阈值图时使用)
+ * @param inputs 可选输入，尺寸与温度矩阵不一致的项被忽略
+ * @param mask 输出 CV_8UC1 掩码，候选为 255
+ *
+ * zone_stats 非空时各项先被清零再累积，编号超出其大小的像素不计入。
+ */
+void computeCandidateMask(const cv::Mat &temp_matrix,
+                          float threshold,
+                          const CandidateMaskInputs &inputs,
+                          cv::Mat &mask);
+
+/**
+ * @brief 截取输入中与 roi 对应的部分 (共享数据)，用于只在局部区域内计算候选掩码
+ *
+ * @param inputs 整帧输入，尺寸与 full_size 不一致的项保持为空
+ * @param full_size 整帧尺寸
+ * @param roi 局部区域，须位于整帧内
+ *
+ * 区域统计只对整帧有意义，返回值的 zone_stats 为空。
+ */
+CandidateMaskInputs cropCandidateMaskInputs(const CandidateMaskInputs &inputs, const cv::Size &full_size, const cv::Rect &roi);
+
+#endif // CANDIDATE_MASK_H
@@ -0,0 +1,105 @@
+// src/ego_motion.cpp
+#include "ego_motion.h"
+#include "temperature_conversion.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+cv::Point2f FrameMotion::apply(const cv::Point2f &p) const
+{
+    if (!valid)
+        return p;
+    return p + translation_pixels;
+}
+
+EgoMotionEstimator::EgoMotionEstimator(int downsample_factor, double min_response)
+    : factor_(std::max(downsample_factor, 1)), min_response_(min_response)
+{
+}
+
+void EgoMotionEstimator::reset()
+{
+    prev_small_.release();
+}
+
+FrameMotion EgoMotionEstimator::estimate(const cv::Mat &temp_matrix, const FrameMotion *prior)
+{
+    FrameMotion motion;
+    const int64 start_tick = cv::getTickCount();
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Ego motion input must be a CV_32FC1 or CV_16SC1 temperature matrix." << std::endl;
+        return motion;
+    }
+
+    cv::Size small_size(temp_matrix.cols / factor_, temp_matrix.rows / factor_);
+    cv::resize(temp_matrix, curr_small_, small_size, 0, 0, cv::INTER_AREA);
+    // 相位相关需要浮点输入；定点矩阵在缩小后再转换，开销只有原图的 1/factor^2
+    if (curr_small_.type() != CV_32FC1)
+        curr_small_.convertTo(curr_small_, CV_32F, temperatureUnitCelsius(temp_matrix));
+    if (window_.size() != small_size)
+        cv::createHanningWindow(window_, small_size, CV_32F);
+
+    if (prev_small_.empty() || prev_small_.size() != small_size)
+    {
+        std::swap(prev_small_, curr_small_);
+        if (prior)
+            return *prior;
+        return motion;
+    }
+
+    double response = 0.0;
+    cv::Point2d shift = cv::phaseCorrelate(prev_small_, curr_small_, window_, &response);
+    std::swap(prev_small_, curr_small_);
+
+    if (response >= min_response_)
+    {
+        motion.translation_pixels = cv::Point2f(static_cast<float>(shift.x * factor_), static_cast<float>(shift.y * factor_));
+        motion.confidence = static_cast<float>(response);
+        motion.valid = true;
+    }
+    else if (prior)
+    {
+        // 热场景纹理不足，配准不可靠
+        motion = *prior;
+    }
+    motion.estimate_ms = static_cast<float>((cv::getTickCount() - start_tick) * 1000.0 / cv::getTickFrequency());
+    return motion;
+}
+
+FrameMotion motionFromGimbalDelta(float delta_azimuth_degrees, float delta_pitch_degrees, const cv::Mat &camera_matrix)
+{
+    FrameMotion motion;
+    if (camera_matrix.empty() || camera_matrix.at<double>(0, 0) == 0)
+        return motion;
+
+    const double k = CV_PI / 180.0;
+    double fx = camera_matrix.at<double>(0, 0);
+    double fy = camera_matrix.at<double>(1, 1);
+    motion.translation_pixels = cv::Point2f(static_cast<float>(-fx * std::tan(delta_azimuth_degrees * k)),
+                                            static_cast<float>(-fy * std::tan(delta_pitch_degrees * k)));
+    motion.confidence = 1.0f;
+    motion.valid = true;
+    return motion;
+}
+
+void shiftStatePlane(cv::Mat &plane, const FrameMotion &motion, const cv::Scalar &fill_value)
+{
+    if (plane.empty() || !motion.valid)
+        return;
+
+    int dx = cvRound(motion.translation_pixels.x);
+    int dy = cvRound(motion.translation_pixels.y);
+    if (dx == 0 && dy == 0)
+        return;
+
+    cv::Mat shifted(plane.size(), plane.type(), fill_value);
+    if (std::abs(dx) < plane.cols && std::abs(dy) < plane.rows)
+    {
+        // 上一帧 (x, y) 的状态移到当前帧 (x+dx, y+dy)
+        cv::Rect src_rect(std::max(0, -dx), std::max(0, -dy), plane.cols - std::abs(dx), plane.rows - std::abs(dy));
+        cv::Rect dst_rect(std::max(0, dx), std::max(0, dy), src_rect.width, src_rect.height);
+        plane(src_rect).copyTo(shifted(dst_rect));
+    }
+    plane = shifted;
+}
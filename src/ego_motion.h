@@ -0,0 +1,73 @@
+// src/ego_motion.h
+#ifndef EGO_MOTION_H
+#define EGO_MOTION_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+// --- 自运动补偿 ---
+// 底盘振动或移动时整幅场景在图像中平移。这里用降采样后的相位相关估计帧间平移，
+// 低置信度时(热场景纹理太少)回退到云台/里程计先验，供跟踪器和逐像素时域模型在稳像坐标下工作。
+// 384x288 输入按 4 倍降采样到 96x72 后做相位相关，开销预算为每帧 EGO_MOTION_BUDGET_MS 以内
+// (耗时记录在 FrameMotion::estimate_ms，stress_detection 检查最坏情况)。
+//
+// 运动模型只有平移：云台回转/俯仰在窄视场下近似为图像平移，底盘横滚引起的图像旋转不估计也不补偿，
+// 相对该假设的残差由跟踪关联门限和逐像素模型的容差吸收。
+
+// 帧间运动 (纯平移)：上一帧中位于 p 的场景点在当前帧中位于 p + translation_pixels
+struct FrameMotion
+{
+    cv::Point2f translation_pixels;
+    float confidence;             // 相位相关峰值响应 [0,1]，先验为 1
+    bool valid;
+    float estimate_ms;            // 本帧估计耗时 (降采样 + 相位相关)，直接采用先验时为 0
+
+    FrameMotion() : translation_pixels(0.0f, 0.0f), confidence(0.0f), valid(false), estimate_ms(0.0f) {}
+
+    cv::Point2f apply(const cv::Point2f &p) const;
+};
+
+class EgoMotionEstimator
+{
+public:
+    /**
+     * @param downsample_factor 降采样倍数
+     * @param min_response 相位相关响应低于该值时采用先验
+     */
+    explicit EgoMotionEstimator(int downsample_factor = 4, double min_response = 0.05);
+
+    /**
+     * @brief 估计当前帧相对上一帧的运动
+     *
+     * @param temp_matrix 当前帧温度矩阵 (CV_32FC1)
+     * @param prior 可选的云台/里程计先验，为 nullptr 时只用图像配准
+     * @return 帧间运动 (只含平移)；第一帧返回先验或 valid=false 的零运动
+     */
+    FrameMotion estimate(const cv::Mat &temp_matrix, const FrameMotion *prior = nullptr);
+
+    void reset();
+
+private:
+    int factor_;
+    double min_response_;
+    cv::Mat prev_small_;
+    cv::Mat curr_small_;
+    cv::Mat window_;
+};
+
+/**
+ * @brief 由云台转角增量构造运动先验
+ *
+ * 云台向右转 (回转角增大) 时场景在图像中左移，俯仰角增大 (向下) 时场景上移。
+ */
+FrameMotion motionFromGimbalDelta(float delta_azimuth_degrees, float delta_pitch_degrees, const cv::Mat &camera_matrix);
+
+/**
+ * @brief 按帧间运动平移逐像素状态平面 (整数像素)，移入的区域填充 fill_value
+ *
+ * 供时域滤波/背景模型等逐像素状态使用，使状态与当前帧像素对齐。纯内存拷贝，不做插值。
+ */
+void shiftStatePlane(cv::Mat &plane, const FrameMotion &motion, const cv::Scalar &fill_value);
+
+#endif // EGO_MOTION_H
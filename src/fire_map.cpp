@@ -0,0 +1,226 @@
+// src/fire_map.cpp
+#include "fire_map.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // 向下取整的整数除法 (负坐标也正确落到对应块)
+    inline int floorDiv(int a, int b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+}
+
+FireMap::FireMap(float resolution_meters, size_t max_tiles)
+    : resolution_(resolution_meters > 0.0f ? resolution_meters : 0.1f),
+      max_tiles_(std::max<size_t>(max_tiles, 1))
+{
+}
+
+int64_t FireMap::tileKey(int tx, int ty)
+{
+    return (static_cast<int64_t>(tx) << 32) | static_cast<uint32_t>(ty);
+}
+
+cv::Point2f FireMap::cellCenter(int64_t key, int index) const
+{
+    int tx = static_cast<int>(key >> 32);
+    int ty = static_cast<int>(static_cast<int32_t>(key & 0xffffffff));
+    int cx = tx * FIRE_MAP_TILE_SIZE + index % FIRE_MAP_TILE_SIZE;
+    int cy = ty * FIRE_MAP_TILE_SIZE + index / FIRE_MAP_TILE_SIZE;
+    return cv::Point2f((cx + 0.5f) * resolution_, (cy + 0.5f) * resolution_);
+}
+
+FireMap::Tile &FireMap::tileFor(int cx, int cy, float timestamp_seconds)
+{
+    int64_t key = tileKey(floorDiv(cx, FIRE_MAP_TILE_SIZE), floorDiv(cy, FIRE_MAP_TILE_SIZE));
+    auto it = tiles_.find(key);
+    if (it == tiles_.end())
+    {
+        if (tiles_.size() >= max_tiles_)
+            evictOldestTile();
+        it = tiles_.emplace(key, Tile()).first;
+    }
+    it->second.last_update_seconds = timestamp_seconds;
+    return it->second;
+}
+
+void FireMap::evictOldestTile()
+{
+    // 只在分配新块且已满时发生，线性扫描可以接受
+    auto oldest = tiles_.begin();
+    for (auto it = tiles_.begin(); it != tiles_.end(); ++it)
+    {
+        if (it->second.last_update_seconds < oldest->second.last_update_seconds)
+            oldest = it;
+    }
+    if (oldest != tiles_.end())
+        tiles_.erase(oldest);
+}
+
+void FireMap::refreshTileSummary(Tile &tile)
+{
+    tile.max_temperature = 0.0f;
+    tile.burning_cells = 0;
+    for (const auto &cell : tile.cells)
+    {
+        if (cell.state != FireCellState::Burning)
+            continue;
+        ++tile.burning_cells;
+        tile.max_temperature = std::max(tile.max_temperature, cell.max_temperature);
+    }
+}
+
+void FireMap::integrate(const std::vector<HotSpot> &hot_spots, float focal_length_pixels, float timestamp_seconds)
+{
+    if (focal_length_pixels <= 0.0f)
+        return;
+
+    for (const auto &spot : hot_spots)
+    {
+        if (spot.range_meters <= 0.0f)
+            continue;
+
+        // 热点等效圆半径：像素半径 * 深度 / 焦距
+        float radius_pixels = std::sqrt(static_cast<float>(spot.area_pixels) / static_cast<float>(CV_PI));
+        float radius = std::max(radius_pixels * spot.range_meters / focal_length_pixels, 0.5f * resolution_);
+        float wx = spot.world_frame_position.x;
+        float wy = spot.world_frame_position.y;
+
+        int cx0 = static_cast<int>(std::floor((wx - radius) / resolution_));
+        int cx1 = static_cast<int>(std::floor((wx + radius) / resolution_));
+        int cy0 = static_cast<int>(std::floor((wy - radius) / resolution_));
+        int cy1 = static_cast<int>(std::floor((wy + radius) / resolution_));
+        float r2 = (radius + 0.5f * resolution_) * (radius + 0.5f * resolution_);
+
+        for (int cy = cy0; cy <= cy1; ++cy)
+        {
+            float dy = (cy + 0.5f) * resolution_ - wy;
+            for (int cx = cx0; cx <= cx1; ++cx)
+            {
+                float dx = (cx + 0.5f) * resolution_ - wx;
+                if (dx * dx + dy * dy > r2)
+                    continue;
+
+                Tile &tile = tileFor(cx, cy, timestamp_seconds);
+                int lx = cx - floorDiv(cx, FIRE_MAP_TILE_SIZE) * FIRE_MAP_TILE_SIZE;
+                int ly = cy - floorDiv(cy, FIRE_MAP_TILE_SIZE) * FIRE_MAP_TILE_SIZE;
+                FireMapCell &cell = tile.cells[ly * FIRE_MAP_TILE_SIZE + lx];
+
+                if (cell.state != FireCellState::Burning)
+                {
+                    // 新火点；已处置区域熄灭超过保持时间后重新出现才计为复燃，否则是喷射后仍在燃烧
+                    if (cell.state == FireCellState::Suppressed &&
+                        timestamp_seconds - cell.last_seen_seconds >= FIRE_REIGNITION_HOLD_SECONDS &&
+                        cell.reignition_count < UINT8_MAX)
+                        ++cell.reignition_count;
+                    cell.state = FireCellState::Burning;
+                    cell.max_temperature = 0.0f;
+                    ++tile.burning_cells;
+                }
+                cell.max_temperature = std::max(cell.max_temperature, spot.max_temperature);
+                cell.last_seen_seconds = timestamp_seconds;
+                if (cell.hit_count < UINT16_MAX)
+                    ++cell.hit_count;
+                tile.max_temperature = std::max(tile.max_temperature, cell.max_temperature);
+            }
+        }
+    }
+}
+
+void FireMap::markSuppressed(const cv::Point2f &world_xy, float radius_meters)
+{
+    int cx0 = static_cast<int>(std::floor((world_xy.x - radius_meters) / resolution_));
+    int cx1 = static_cast<int>(std::floor((world_xy.x + radius_meters) / resolution_));
+    int cy0 = static_cast<int>(std::floor((world_xy.y - radius_meters) / resolution_));
+    int cy1 = static_cast<int>(std::floor((world_xy.y + radius_meters) / resolution_));
+    float r2 = radius_meters * radius_meters;
+
+    for (int ty = floorDiv(cy0, FIRE_MAP_TILE_SIZE); ty <= floorDiv(cy1, FIRE_MAP_TILE_SIZE); ++ty)
+    {
+        for (int tx = floorDiv(cx0, FIRE_MAP_TILE_SIZE); tx <= floorDiv(cx1, FIRE_MAP_TILE_SIZE); ++tx)
+        {
+            auto it = tiles_.find(tileKey(tx, ty));
+            if (it == tiles_.end() || it->second.burning_cells == 0)
+                continue;
+
+            Tile &tile = it->second;
+            for (int i = 0; i < FIRE_MAP_TILE_SIZE * FIRE_MAP_TILE_SIZE; ++i)
+            {
+                FireMapCell &cell = tile.cells[i];
+                if (cell.state != FireCellState::Burning)
+                    continue;
+                cv::Point2f c = cellCenter(it->first, i);
+                float dx = c.x - world_xy.x;
+                float dy = c.y - world_xy.y;
+                if (dx * dx + dy * dy <= r2)
+                    cell.state = FireCellState::Suppressed;
+            }
+            refreshTileSummary(tile);
+        }
+    }
+}
+
+bool FireMap::hottestBurningCell(float now_seconds, float max_age_seconds, FireMapSample &out) const
+{
+    bool found = false;
+    float best = 0.0f;
+    for (const auto &entry : tiles_)
+    {
+        const Tile &tile = entry.second;
+        // 块级摘要剪枝：没有燃烧栅格、或块内最高温度不可能超过当前最优的块直接跳过
+        if (tile.burning_cells == 0 || tile.max_temperature <= best)
+            continue;
+        if (now_seconds - tile.last_update_seconds > max_age_seconds)
+            continue;
+
+        for (int i = 0; i < FIRE_MAP_TILE_SIZE * FIRE_MAP_TILE_SIZE; ++i)
+        {
+            const FireMapCell &cell = tile.cells[i];
+            if (cell.state != FireCellState::Burning || cell.max_temperature <= best)
+                continue;
+            if (now_seconds - cell.last_seen_seconds > max_age_seconds)
+                continue;
+            best = cell.max_temperature;
+            out.world_xy = cellCenter(entry.first, i);
+            out.cell = cell;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void FireMap::collectBurningCells(float min_temperature, std::vector<FireMapSample> &out) const
+{
+    for (const auto &entry : tiles_)
+    {
+        const Tile &tile = entry.second;
+        if (tile.burning_cells == 0 || tile.max_temperature < min_temperature)
+            continue;
+        for (int i = 0; i < FIRE_MAP_TILE_SIZE * FIRE_MAP_TILE_SIZE; ++i)
+        {
+            const FireMapCell &cell = tile.cells[i];
+            if (cell.state == FireCellState::Burning && cell.max_temperature >= min_temperature)
+            {
+                FireMapSample sample;
+                sample.world_xy = cellCenter(entry.first, i);
+                sample.cell = cell;
+                out.push_back(sample);
+            }
+        }
+    }
+}
+
+bool FireMap::cellAt(const cv::Point2f &world_xy, FireMapCell &out) const
+{
+    int cx = static_cast<int>(std::floor(world_xy.x / resolution_));
+    int cy = static_cast<int>(std::floor(world_xy.y / resolution_));
+    int tx = floorDiv(cx, FIRE_MAP_TILE_SIZE);
+    int ty = floorDiv(cy, FIRE_MAP_TILE_SIZE);
+    auto it = tiles_.find(tileKey(tx, ty));
+    if (it == tiles_.end())
+        return false;
+    out = it->second.cells[(cy - ty * FIRE_MAP_TILE_SIZE) * FIRE_MAP_TILE_SIZE + (cx - tx * FIRE_MAP_TILE_SIZE)];
+    return true;
+}
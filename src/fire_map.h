@@ -0,0 +1,109 @@
+// src/fire_map.h
+#ifndef FIRE_MAP_H
+#define FIRE_MAP_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// --- 世界坐标系火情栅格地图 ---
+// 在世界坐标系 XY 平面上累积每一帧的火情证据。
+// 存储按 FIRE_MAP_TILE_SIZE x FIRE_MAP_TILE_SIZE 个栅格分块，只为出现过热点的区域分配块，
+// 块数超过上限时淘汰最久未更新的块，保证长时间任务内存有界。
+
+const int FIRE_MAP_TILE_SIZE = 16;
+
+enum class FireCellState : uint8_t
+{
+    Empty = 0,      // 从未观测到火情
+    Burning = 1,    // 观测到火情，尚未处置
+    Suppressed = 2  // 已喷射处置
+};
+
+struct FireMapCell
+{
+    float max_temperature;   // 观测到的最高温度
+    float last_seen_seconds; // 最近一次观测时间
+    uint16_t hit_count;      // 被热点覆盖的帧数
+    FireCellState state;
+    uint8_t reignition_count; // 处置后熄灭 (FIRE_REIGNITION_HOLD_SECONDS 内未观测到) 又重新出现的次数
+
+    FireMapCell() : max_temperature(0.0f), last_seen_seconds(0.0f), hit_count(0), state(FireCellState::Empty), reignition_count(0) {}
+};
+
+// 地图查询结果：栅格中心的世界坐标及其内容
+struct FireMapSample
+{
+    cv::Point2f world_xy;
+    FireMapCell cell;
+};
+
+class FireMap
+{
+public:
+    /**
+     * @param resolution_meters 栅格边长 (米)
+     * @param max_tiles 最多保留的块数 (每块 FIRE_MAP_TILE_SIZE^2 个栅格)
+     */
+    explicit FireMap(float resolution_meters = 0.1f, size_t max_tiles = 4096);
+
+    /**
+     * @brief 将一帧热点增量写入地图
+     *
+     * @param hot_spots 已由 TransformChain 填充 world_frame_position 的热点
+     * @param focal_length_pixels 相机焦距 (像素)，用于把热点面积换算为地面半径
+     * @param timestamp_seconds 当前帧时间
+     *
+     * 只访问每个热点覆盖圆内的栅格，代价与火区面积成正比。
+     * 已处置的栅格再次被观测到时恢复为燃烧：距上次观测已超过 FIRE_REIGNITION_HOLD_SECONDS 的计为复燃，
+     * 否则视为喷射未扑灭、持续燃烧。
+     */
+    void integrate(const std::vector<HotSpot> &hot_spots, float focal_length_pixels, float timestamp_seconds);
+
+    // 将圆形区域内的燃烧栅格标记为已处置 (控制器报告喷射完成后调用，见 FirePipeline::reportSprayCompleted)
+    void markSuppressed(const cv::Point2f &world_xy, float radius_meters);
+
+    /**
+     * @brief 查询最热的未处置栅格
+     *
+     * @param now_seconds 当前时间
+     * @param max_age_seconds 只考虑最近该时间内观测到的栅格
+     * @param out 输出结果
+     * @return 找到返回 true
+     */
+    bool hottestBurningCell(float now_seconds, float max_age_seconds, FireMapSample &out) const;
+
+    // 收集所有未处置且温度不低于 min_temperature 的栅格
+    void collectBurningCells(float min_temperature, std::vector<FireMapSample> &out) const;
+
+    // 读取单个栅格 (不存在时返回 false)
+    bool cellAt(const cv::Point2f &world_xy, FireMapCell &out) const;
+
+    size_t tileCount() const { return tiles_.size(); }
+    size_t memoryBytes() const { return tiles_.size() * sizeof(Tile); }
+
+private:
+    struct Tile
+    {
+        std::array<FireMapCell, FIRE_MAP_TILE_SIZE * FIRE_MAP_TILE_SIZE> cells;
+        float max_temperature = 0.0f; // 块内燃烧栅格的最高温度 (查询时快速跳过)
+        int burning_cells = 0;
+        float last_update_seconds = 0.0f;
+    };
+
+    static int64_t tileKey(int tx, int ty);
+    cv::Point2f cellCenter(int64_t key, int index) const;
+    Tile &tileFor(int cx, int cy, float timestamp_seconds);
+    void evictOldestTile();
+    void refreshTileSummary(Tile &tile);
+
+    float resolution_;
+    size_t max_tiles_;
+    std::unordered_map<int64_t, Tile> tiles_;
+};
+
+#endif // FIRE_MAP_H
@@ -0,0 +1,413 @@
+// src/fire_pipeline.cpp
+#include "fire_pipeline.h"
+#include <opencv2/imgproc.hpp>
+#include <iostream>
+
+FirePipeline::FirePipeline()
+    : frame_size_(384, 288),
+      fire_map_(FIRE_MAP_RESOLUTION_METERS, FIRE_MAP_MAX_TILES),
+      background_model_enabled_(false),
+      max_tree_enabled_(false),
+      nuc_enabled_(false),
+      temperature_type_(CV_32FC1),
+      region_stats_enabled_(false),
+      previous_timestamp_seconds_(0.0f),
+      frame_interval_seconds_(0.0f),
+      unconfirmed_since_seconds_(-1.0f),
+      grouping_distance_meters_(MAX_GROUPING_DISTANCE_METERS)
+{
+}
+
+bool FirePipeline::configure(const std::string &params_file, const cv::Size &frame_size)
+{
+    frame_size_ = frame_size;
+    const bool params_loaded = loadCameraParameters(params_file, camera_params_);
+    if (!params_loaded)
+        std::cout << "Using hardcoded default parameters due to load failure." << std::endl;
+
+    // 打印加载或使用的参数
+    std::cout << "Using HFOV: " << camera_params_.hfov_degrees << ", VFOV: " << camera_params_.vfov_degrees << std::endl;
+    std::cout << "Using Nozzle Offset Az: " << camera_params_.nozzle_azimuth_offset << ", Pitch: " << camera_params_.nozzle_pitch_offset << std::endl;
+
+    // 距离估计模型
+    range_provider_ = createRangeProvider(params_file, camera_params_.camera_matrix, frame_size_);
+
+    // 镜头畸变：显示映射表启动时计算一次，瞄准路径只校正热点几何
+    lens_undistortion_.configure(camera_params_.camera_matrix, camera_params_.dist_coeffs, frame_size_);
+
+    // 可选的逐像素阈值图：远处像素的火焰表观温度更低，阈值随距离模型降低 (温度矩阵格式确定后生成)
+    threshold_map_config_ = ThresholdMapConfig();
+    loadThresholdMapConfig(params_file, threshold_map_config_);
+
+    // 相机 -> 云台 -> 底盘 -> 世界 变换链
+    loadTransformChainParameters(params_file, camera_params_.camera_matrix, transform_chain_);
+
+    // 可选的区域跟踪检测：检测开销随火源面积而非图像面积变化
+    loadRegionTrackingConfig(params_file, region_tracking_config_);
+    region_tracker_ = RegionTracker(region_tracking_config_);
+
+    // 静态屏蔽区域；多边形禁喷区域一次性并入屏蔽掩码，区域统计在候选掩码遍历中累积
+    loadStaticExclusionMask(params_file, frame_size_, static_allow_mask_);
+    zone_map_.load(params_file, frame_size_);
+    if (!zone_map_.allowMask().empty())
+    {
+        if (static_allow_mask_.empty())
+            static_allow_mask_ = zone_map_.allowMask().clone();
+        else
+            cv::bitwise_and(static_allow_mask_, zone_map_.allowMask(), static_allow_mask_);
+    }
+    zone_stats_.assign(zone_map_.zones().size(), ZoneFrameStats());
+
+    // 可选的背景温度模型：学习从未被检出的稳定高温物体
+    background_model_enabled_ = loadBackgroundModelEnabled(params_file);
+
+    // 可选的热点分类器 (未配置模型时跳过) 与粘连热点拆分
+    loadBlobClassifier(params_file, blob_classifier_);
+    loadBlobSplitConfig(params_file, split_config_);
+
+    // 可选的多阈值分析 (阴燃/燃烧/轰燃等)，每帧建一次最大树后按各阈值查询
+    max_tree_enabled_ = loadMaxTreeThresholds(params_file, analysis_thresholds_);
+
+    // 16 位原始输入：启动时按 Planck 定标生成 65536 项查找表
+    PlanckCalibration planck_calibration;
+    loadPlanckCalibration(params_file, planck_calibration);
+    if (planck_calibration.enabled)
+        radiometric_lut_.build(planck_calibration);
+
+    // 非均匀性校正与坏点替换 (未配置校正表时跳过)，校正表为探测器原生分辨率
+    nuc_enabled_ = loadNonUniformityCorrection(params_file, nuc_);
+
+    // 可选的运动自适应时域降噪，在温度转换的同一遍中原地进行
+    loadTemporalDenoiseConfig(params_file, denoise_config_);
+    temporal_denoise_ = TemporalDenoiseFilter(denoise_config_);
+
+    // 温度矩阵格式：CV_32FC1，或 CV_16SC1 (0.1 °C 定点)；阈值图转换为同一格式，阈值比较直接在 int16 上进行
+    temperature_type_ = CV_32FC1;
+    loadTemperatureMatrixType(params_file, temperature_type_);
+    if (threshold_map_config_.enabled)
+        threshold_map_builder_.configure(camera_params_.camera_matrix, frame_size_, threshold_map_config_);
+    rebuildThresholdMap();
+
+    return params_loaded;
+}
+
+void FirePipeline::reset()
+{
+    fire_map_ = FireMap(FIRE_MAP_RESOLUTION_METERS, FIRE_MAP_MAX_TILES);
+    ego_motion_.reset();
+    tracker_ = HotspotTracker();
+    region_tracker_ = RegionTracker(region_tracking_config_);
+    rate_of_rise_model_ = RateOfRiseModel();
+    background_model_ = BackgroundTemperatureModel();
+    zone_stats_.assign(zone_map_.zones().size(), ZoneFrameStats());
+    temporal_denoise_ = TemporalDenoiseFilter(denoise_config_);
+    previous_gimbal_ = GimbalState();
+    previous_timestamp_seconds_ = 0.0f;
+    frame_interval_seconds_ = 0.0f;
+    unconfirmed_since_seconds_ = -1.0f;
+}
+
+void FirePipeline::setDetectionParameters(const DetectionParameters &params, float grouping_distance_meters)
+{
+    const bool threshold_changed = params.temperature_threshold != detection_params_.temperature_threshold;
+    detection_params_ = params;
+    grouping_distance_meters_ = grouping_distance_meters;
+    if (threshold_changed && range_provider_)
+        rebuildThresholdMap();
+}
+
+void FirePipeline::rebuildThresholdMap()
+{
+    threshold_map_.release();
+    if (!threshold_map_config_.enabled)
+        return;
+    threshold_map_builder_.build(*range_provider_, detection_params_.temperature_threshold, threshold_map_);
+    convertTemperatureFormat(threshold_map_, threshold_map_, temperature_type_);
+}
+
+bool FirePipeline::processFrame(const cv::Mat &frame, const GimbalState &gimbal, const OdometryState &odometry,
+                                float timestamp_seconds, FrameResult &result)
+{
+    if (!prepareFrame(frame, gimbal, timestamp_seconds, frame_inputs_))
+        return false;
+    detectFrame(frame_inputs_, gimbal, odometry, result);
+    return true;
+}
+
+bool FirePipeline::prepareFrame(const cv::Mat &frame, const GimbalState &gimbal, float timestamp_seconds, FrameInputs &inputs)
+{
+    const bool raw_input = radiometric_lut_.isReady();
+    if (frame.empty() || frame.type() != (raw_input ? CV_16UC1 : CV_8UC1))
+    {
+        std::cerr << "Error: Expected a " << (raw_input ? "16-bit raw" : "8-bit grayscale") << " thermal frame." << std::endl;
+        return false;
+    }
+
+    // 以云台转角增量作为先验：降噪状态在转换前按先验平移，之后再估计帧间运动
+    FrameMotion gimbal_prior = motionFromGimbalDelta(gimbal.azimuth_degrees - previous_gimbal_.azimuth_degrees,
+                                                     gimbal.pitch_degrees - previous_gimbal_.pitch_degrees,
+                                                     camera_params_.camera_matrix);
+    previous_gimbal_ = gimbal;
+
+    TemporalDenoiseFilter *denoiser = denoise_config_.enabled ? &temporal_denoise_ : nullptr;
+    if (denoiser)
+        denoiser->compensate(gimbal_prior);
+
+    // 非均匀性校正在探测器原生分辨率上进行：帧需要缩放时先整帧校正，否则在温度转换 (灰度映射或查表) 中融合完成
+    const cv::Mat *input = &frame;
+    const NonUniformityCorrection *fused_nuc = nullptr;
+    if (nuc_enabled_ && !nuc_.isValid(frame.size()))
+    {
+        std::cout << "Warning: NUC calibration is " << nuc_.gain.cols << "x" << nuc_.gain.rows << " but frames are "
+                  << frame.cols << "x" << frame.rows << ", NUC disabled." << std::endl;
+        nuc_enabled_ = false;
+    }
+    if (nuc_enabled_ && frame.size() != frame_size_)
+    {
+        applyNonUniformityCorrection(frame, nuc_, corrected_frame_);
+        input = &corrected_frame_;
+    }
+    else if (nuc_enabled_)
+    {
+        fused_nuc = &nuc_;
+    }
+
+    // 原始计数与辐亮度近似线性，两种输入都先缩放再转换
+    if (input->size() != frame_size_)
+    {
+        cv::resize(*input, resized_frame_, frame_size_, 0, 0, cv::INTER_LINEAR);
+        input = &resized_frame_;
+    }
+    cv::Mat &temperature_matrix = inputs.temperature_matrix;
+    RegionStatistics *region_stats = region_stats_enabled_ ? &region_stats_ : nullptr;
+    if (raw_input)
+        radiometric_lut_.convert(*input, temperature_matrix, region_stats, fused_nuc, temperature_type_, denoiser);
+    else
+        convertGrayToTemperature(*input, gray_min_temperature, gray_max_temperature, temperature_matrix, region_stats,
+                                 fused_nuc, temperature_type_, denoiser);
+    if (temperature_matrix.empty())
+        return false;
+
+    inputs.motion = ego_motion_.estimate(temperature_matrix, &gimbal_prior);
+    inputs.timestamp_seconds = timestamp_seconds;
+    rate_of_rise_model_.update(temperature_matrix, timestamp_seconds - previous_timestamp_seconds_, inputs.rising_mask, &inputs.motion);
+    inputs.rise_rate = rate_of_rise_model_.riseRate();
+    const float frame_dt = timestamp_seconds - previous_timestamp_seconds_;
+    if (frame_dt > 0.0f)
+        frame_interval_seconds_ = frame_interval_seconds_ > 0.0f ? 0.9f * frame_interval_seconds_ + 0.1f * frame_dt : frame_dt;
+    inputs.frame_interval_seconds = frame_interval_seconds_;
+    previous_timestamp_seconds_ = timestamp_seconds;
+    return true;
+}
+
+void FirePipeline::detectFrame(const FrameInputs &inputs, const GimbalState &gimbal, const OdometryState &odometry,
+                               FrameResult &result)
+{
+    const cv::Mat &temperature_matrix = inputs.temperature_matrix;
+    const float timestamp_seconds = inputs.timestamp_seconds;
+    result.temperature_matrix = temperature_matrix;
+    result.motion = inputs.motion;
+    result.timestamp_seconds = timestamp_seconds;
+
+    // 距离模型随云台俯仰角更新 (地平面模型)；深度图变化时阈值图随之重建
+    if (range_provider_->beginFrame(gimbal.pitch_degrees))
+        rebuildThresholdMap();
+
+    DetectionAuxInputs detection_inputs;
+    detection_inputs.params = detection_params_;
+    detection_inputs.mask_inputs.extra_candidates = inputs.rising_mask;
+    detection_inputs.mask_inputs.allow_mask = static_allow_mask_;
+    detection_inputs.mask_inputs.threshold_map = threshold_map_;
+    if (!zone_map_.empty())
+    {
+        detection_inputs.mask_inputs.zone_ids = zone_map_.zoneIds();
+        detection_inputs.mask_inputs.zone_stats = &zone_stats_;
+    }
+    if (background_model_enabled_ && background_model_.isReady())
+    {
+        detection_inputs.mask_inputs.background = background_model_.background();
+        detection_inputs.mask_inputs.background_deviation = background_model_.deviation();
+    }
+    detection_inputs.rise_rate = inputs.rise_rate;
+    detection_inputs.split = split_config_;
+    detection_inputs.undistortion = &lens_undistortion_;
+    if (region_tracking_config_.enabled)
+    {
+        region_tracker_.predict(result.motion, temperature_matrix.size());
+        detection_inputs.region_tracker = &region_tracker_;
+    }
+
+    result.hot_spots = detectAndFilterHotspots(temperature_matrix, camera_params_.camera_matrix, *range_provider_, detection_inputs);
+    tracker_.update(result.hot_spots, result.motion, timestamp_seconds);
+    blob_classifier_.classify(result.hot_spots);
+    if (background_model_enabled_)
+    {
+        buildBackgroundFreezeMask(result.hot_spots, temperature_matrix.size());
+        background_model_.update(temperature_matrix, &result.motion, background_freeze_mask_);
+    }
+    evictLeastSevereHotspots(result.hot_spots, MAX_HOTSPOTS_KEPT);
+
+    // 多阈值分析：构建一次最大树，各阈值的连通区域均为查询
+    result.threshold_regions.resize(max_tree_enabled_ ? analysis_thresholds_.size() : 0);
+    if (max_tree_enabled_)
+    {
+        max_tree_.build(temperature_matrix);
+        for (size_t i = 0; i < analysis_thresholds_.size(); ++i)
+        {
+            result.threshold_regions[i].threshold_temperature = analysis_thresholds_[i];
+            max_tree_.query(analysis_thresholds_[i], MIN_HOTSPOT_AREA_PIXELS, result.threshold_regions[i].components);
+        }
+    }
+
+    // 每帧复合一次变换链，批量投影全部热点到世界坐标系
+    transform_chain_.setGimbalAngles(gimbal.azimuth_degrees, gimbal.pitch_degrees);
+    transform_chain_.setOdometry(odometry.x, odometry.y, odometry.yaw);
+    transform_chain_.projectHotspots(result.hot_spots);
+
+    fire_map_.integrate(result.hot_spots, static_cast<float>(camera_params_.camera_matrix.at<double>(0, 0)), timestamp_seconds);
+    result.spray_targets = determineSprayTargets(result.hot_spots, grouping_distance_meters_);
+
+    result.aim_target_index = chooseAimTarget(result.spray_targets, timestamp_seconds, inputs.frame_interval_seconds);
+    if (result.aim_target_index >= 0)
+    {
+        const SprayTarget &primary_target = result.spray_targets[result.aim_target_index];
+        result.gimbal_command = calculateGimbalAngles(
+            primary_target.final_pixel_aim_point,
+            temperature_matrix.cols, temperature_matrix.rows,
+            camera_params_.hfov_degrees, camera_params_.vfov_degrees,
+            gimbal.azimuth_degrees, gimbal.pitch_degrees,
+            camera_params_.nozzle_azimuth_offset, camera_params_.nozzle_pitch_offset);
+
+        // TODO: 在此处将 gimbal_command 发送给云台控制器并开启喷嘴；控制器确认喷射完成后调用 reportSprayCompleted
+    }
+}
+
+void FirePipeline::reportSprayCompleted(const cv::Point3f &world_aim_point)
+{
+    fire_map_.markSuppressed(cv::Point2f(world_aim_point.x, world_aim_point.y), SPRAY_SUPPRESSION_RADIUS_METERS);
+}
+
+void FirePipeline::buildBackgroundFreezeMask(const std::vector<HotSpot> &hot_spots, const cv::Size &size)
+{
+    background_freeze_mask_.create(size, CV_8UC1);
+    background_freeze_mask_.setTo(cv::Scalar(0));
+
+    // 热点轮廓与轨迹外接矩形是无畸变坐标，填充前映射回温度矩阵 (原始图像) 坐标
+    std::vector<cv::Point2f> points;
+    std::vector<std::vector<cv::Point>> polygon(1);
+    auto fill_polygon = [&]()
+    {
+        lens_undistortion_.distortPoints(points);
+        polygon[0].resize(points.size());
+        for (size_t i = 0; i < points.size(); ++i)
+            polygon[0][i] = cv::Point(cvRound(points[i].x), cvRound(points[i].y));
+        cv::fillPoly(background_freeze_mask_, polygon, cv::Scalar(255));
+    };
+
+    // 本帧检出的全部热点 (含随后按上限淘汰的)
+    for (const auto &spot : hot_spots)
+    {
+        points.assign(spot.contour_pixels.begin(), spot.contour_pixels.end());
+        fill_polygon();
+    }
+    // 已确认的火焰轨迹，包括本帧暂时未检出 (如被遮挡) 的
+    for (const auto &track : tracker_.tracks())
+    {
+        if (track.flicker_score < FLICKER_CONFIRM_SCORE)
+            continue;
+        const cv::Rect &box = track.bounding_box;
+        points = {cv::Point2f(static_cast<float>(box.x), static_cast<float>(box.y)),
+                  cv::Point2f(static_cast<float>(box.x + box.width), static_cast<float>(box.y)),
+                  cv::Point2f(static_cast<float>(box.x + box.width), static_cast<float>(box.y + box.height)),
+                  cv::Point2f(static_cast<float>(box.x), static_cast<float>(box.y + box.height))};
+        fill_polygon();
+    }
+}
+
+int FirePipeline::chooseAimTarget(const std::vector<SprayTarget> &spray_targets, float timestamp_seconds,
+                                  float frame_interval_seconds)
+{
+    if (spray_targets.empty())
+    {
+        unconfirmed_since_seconds_ = -1.0f;
+        return -1;
+    }
+
+    // 优先只对经闪烁/分类器确认的目标喷射，高温但不燃烧的物体不会占用喷嘴 (已确认目标排在最前)
+    if (spray_targets[0].confirmed)
+    {
+        unconfirmed_since_seconds_ = -1.0f;
+        return 0;
+    }
+
+    // 回退：帧率过低无法测量闪烁且未加载分类器时，确认永远不会发生，直接瞄准最严重的目标；
+    // 否则目标持续 UNCONFIRMED_AIM_TIMEOUT_SECONDS 仍未确认时瞄准
+    if (unconfirmed_since_seconds_ < 0.0f)
+        unconfirmed_since_seconds_ = timestamp_seconds;
+    const bool flicker_measurable = frame_interval_seconds > 0.0f && 0.5f / frame_interval_seconds >= FLICKER_BAND_MIN_HZ;
+    const bool confirmation_possible = flicker_measurable || blob_classifier_.isLoaded();
+    if (!confirmation_possible || timestamp_seconds - unconfirmed_since_seconds_ >= UNCONFIRMED_AIM_TIMEOUT_SECONDS)
+        return 0;
+    return -1;
+}
+
+void FirePipeline::printReport(const FrameResult &result) const
+{
+    const std::vector<SprayTarget> &spray_targets = result.spray_targets;
+
+    if (result.aim_target_index >= 0)
+    {
+        const SprayTarget &primary_target = spray_targets[result.aim_target_index];
+        if (!primary_target.confirmed)
+            std::cout << "Aiming at unconfirmed target (flame confirmation unavailable or timed out)." << std::endl;
+        std::cout << "Primary Target Pixel: (" << primary_target.final_pixel_aim_point.x
+                  << ", " << primary_target.final_pixel_aim_point.y << ")" << std::endl;
+        std::cout << "Primary Target World: (" << primary_target.final_world_frame_aim_point.x
+                  << ", " << primary_target.final_world_frame_aim_point.y
+                  << ", " << primary_target.final_world_frame_aim_point.z << ")" << std::endl;
+        std::cout << "Calculated Gimbal Command -> Target Azimuth: " << result.gimbal_command.target_azimuth_degrees
+                  << ", Target Pitch: " << result.gimbal_command.target_pitch_degrees << std::endl;
+    }
+    else if (!spray_targets.empty())
+    {
+        std::cout << "Unconfirmed target at (" << spray_targets[0].final_pixel_aim_point.x << ", "
+                  << spray_targets[0].final_pixel_aim_point.y << "), waiting for flame flicker confirmation." << std::endl;
+    }
+    else
+    {
+        std::cout << "No spray targets detected." << std::endl;
+    }
+
+    for (size_t i = 0; i < zone_stats_.size(); ++i)
+    {
+        const ZoneDefinition &zone = zone_map_.zones()[i];
+        if (zone.type == ZoneType::Measurement && zone.alarm_temperature > 0.0f &&
+            zone_stats_[i].max_temperature >= zone.alarm_temperature)
+        {
+            std::cout << "Zone Alarm: " << zone.name << " max " << zone_stats_[i].max_temperature
+                      << " C, mean " << zone_stats_[i].meanTemperature() << " C, "
+                      << zone_stats_[i].candidate_pixels << " hot px" << std::endl;
+        }
+    }
+
+    for (const auto &regions : result.threshold_regions)
+    {
+        double total_area = 0.0;
+        for (const auto &component : regions.components)
+            total_area += component.area_pixels;
+        std::cout << "Regions >= " << regions.threshold_temperature << " C: " << regions.components.size()
+                  << " (total area " << total_area << " px)" << std::endl;
+    }
+
+    FireMapSample hottest_cell;
+    if (fire_map_.hottestBurningCell(result.timestamp_seconds, FIRE_MAP_MAX_AGE_SECONDS, hottest_cell))
+    {
+        std::cout << "Fire Map: " << fire_map_.tileCount() << " tiles, hottest burning cell at ("
+                  << hottest_cell.world_xy.x << ", " << hottest_cell.world_xy.y << "), "
+                  << hottest_cell.cell.max_temperature << " C";
+        if (hottest_cell.cell.reignition_count > 0)
+            std::cout << ", re-ignited " << static_cast<int>(hottest_cell.cell.reignition_count) << "x";
+        std::cout << std::endl;
+    }
+    std::cout << "------------------------------------" << std::endl;
+}
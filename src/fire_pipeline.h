@@ -0,0 +1,215 @@
+// src/fire_pipeline.h
+#ifndef FIRE_PIPELINE_H
+#define FIRE_PIPELINE_H
+
+#include "background_model.h"
+#include "blob_classifier.h"
+#include "camera_parameters.h"
+#include "ego_motion.h"
+#include "fire_map.h"
+#include "hotspot_tracker.h"
+#include "lens_undistortion.h"
+#include "max_tree.h"
+#include "nuc_correction.h"
+#include "radiometric_lut.h"
+#include "range_estimation.h"
+#include "region_tracking.h"
+#include "temperature_conversion.h"
+#include "temporal_denoise.h"
+#include "temporal_model.h"
+#include "threshold_map.h"
+#include "transform_chain.h"
+#include "vision_processing.h"
+#include "zone_map.h"
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// --- 逐帧处理流程 ---
+// 非均匀性校正 (原生分辨率) -> 温度转换 (Planck 定标/时域降噪/区域统计 (可选)) -> 自运动 -> 升温速率 -> 热点检测 -> 跟踪/分类 -> 背景模型 (可选，冻结热点区域) -> 热点数上限 (淘汰严重度最低的)
+// -> 变换链投影 -> 火情地图 -> 分组 -> 瞄准 (控制器报告喷射完成后在火情地图中标记已处置)，图形界面主程序 (main.cpp) 与无界面主程序 (main_headless.cpp) 共用。
+// 输入为已解码的帧，本模块只依赖 core/imgproc/calib3d，帧读取见 sequence_io.h，显示由调用方完成。
+
+// 云台当前角度 (实际应用中从云台反馈获取)
+struct GimbalState
+{
+    float azimuth_degrees = 0.0f;
+    float pitch_degrees = 0.0f;
+};
+
+// 底盘里程计位姿 (实际应用中从底盘控制器获取)
+struct OdometryState
+{
+    double x = 0.0;
+    double y = 0.0;
+    double yaw = 0.0;
+};
+
+// 一帧中与检测参数无关的中间结果 (prepareFrame 输出)：温度矩阵、帧间运动、升温速率及其候选掩码
+struct FrameInputs
+{
+    cv::Mat temperature_matrix;
+    FrameMotion motion;
+    float timestamp_seconds = 0.0f;
+    float frame_interval_seconds = 0.0f; // 帧间隔的滑动平均，判断闪烁频带是否可测
+    cv::Mat rising_mask;                 // CV_8UC1 升温候选
+    cv::Mat rise_rate;                   // CV_32FC1, °C/s
+};
+
+// 多阈值分析中一个阈值下的连通区域 (面积不小于 MIN_HOTSPOT_AREA_PIXELS)
+struct ThresholdRegions
+{
+    float threshold_temperature = 0.0f;
+    std::vector<MaxTreeComponent> components;
+};
+
+struct FrameResult
+{
+    cv::Mat temperature_matrix; // 本帧温度矩阵 (CV_32FC1 或 CV_16SC1，见 compact_temperature_matrix)
+    FrameMotion motion;
+    float timestamp_seconds = 0.0f;
+    std::vector<HotSpot> hot_spots;
+    std::vector<SprayTarget> spray_targets; // 按确认状态与严重度排序
+    int aim_target_index = -1;              // 本帧瞄准并喷射的目标 (spray_targets 下标)，-1 表示不喷射；目标可能未确认 (回退)
+    CloudGimbalAngles gimbal_command;       // 瞄准 aim_target_index 的云台指令
+    std::vector<ThresholdRegions> threshold_regions; // 多阈值分析，按参数文件中的阈值顺序；未配置阈值时为空
+};
+
+class FirePipeline
+{
+public:
+    FirePipeline();
+
+    /**
+     * @brief 从参数文件加载相机参数与各处理模块配置，并建立启动时一次性生成的表 (阈值图斜距表、Planck 查找表、映射表等)
+     *
+     * @param params_file 参数文件路径
+     * @param frame_size 温度矩阵分辨率，输入帧按该尺寸缩放
+     * @return 参数文件打开成功返回 true；失败时使用默认参数，流程仍可运行
+     */
+    bool configure(const std::string &params_file, const cv::Size &frame_size = cv::Size(384, 288));
+
+    /**
+     * @brief 清空全部逐帧时域状态 (自运动、升温速率、背景、跟踪、降噪、火情地图等)，保留 configure() 加载的配置
+     *
+     * 处理不连续的帧段 (如另一段录制序列) 前调用，避免重新加载参数文件与重建启动时的表。
+     */
+    void reset();
+
+    /**
+     * @brief 处理一帧
+     *
+     * @param frame 已解码的帧：8 位灰度 (按 gray_min/max_temperature 线性映射)，或启用 Planck 定标时的 16 位原始数据
+     * @param gimbal 云台当前角度，与上一帧的差值作为帧间运动先验，也是云台指令的基准
+     * @param odometry 底盘里程计位姿
+     * @param timestamp_seconds 帧时间戳
+     * @param result 输出本帧结果
+     * @return 帧格式与配置不符时返回 false
+     */
+    bool processFrame(const cv::Mat &frame, const GimbalState &gimbal, const OdometryState &odometry,
+                      float timestamp_seconds, FrameResult &result);
+
+    /**
+     * @brief processFrame 的前半部分：非均匀性校正、温度转换、自运动与升温速率，结果与检测参数无关
+     *
+     * 参数扫描工具 (tools/parameter_sweep.cpp) 对每帧只调用一次并缓存 inputs，再用各参数组的流程分别调用 detectFrame。
+     * inputs 中的矩阵在下一次调用时被覆盖，需要保留时调用方自行 clone。
+     *
+     * @return 帧格式与配置不符时返回 false
+     */
+    bool prepareFrame(const cv::Mat &frame, const GimbalState &gimbal, float timestamp_seconds, FrameInputs &inputs);
+
+    /**
+     * @brief processFrame 的后半部分：热点检测、跟踪/分类、背景模型、变换链、火情地图、分组与瞄准
+     *
+     * inputs 需按时间顺序提供 (跟踪等时域状态保存在本对象中)，可以来自另一个按相同参数文件配置的 FirePipeline。
+     */
+    void detectFrame(const FrameInputs &inputs, const GimbalState &gimbal, const OdometryState &odometry, FrameResult &result);
+
+    /**
+     * @brief 覆盖检测参数与分组距离 (默认为 utils.h 中的常量)，阈值变化时重建阈值图；用于参数扫描
+     */
+    void setDetectionParameters(const DetectionParameters &params, float grouping_distance_meters);
+
+    /**
+     * @brief 喷射完成回调：由云台/喷嘴控制器在确认一次喷射完成后调用，将火情地图中覆盖范围内的燃烧栅格标记为已处置
+     *
+     * @param world_aim_point 实际喷射的目标世界坐标 (SprayTarget::final_world_frame_aim_point)
+     */
+    void reportSprayCompleted(const cv::Point3f &world_aim_point);
+
+    /**
+     * @brief 在控制台输出本帧报告：首要目标与云台指令、区域报警、多阈值分析与火情地图
+     *
+     * 只输出 processFrame() 已计算的结果，不做额外处理。
+     */
+    void printReport(const FrameResult &result) const;
+
+    /**
+     * @brief 启用区域统计表 (积分图与分块最大值表)，在温度转换的同一遍中生成，供 regionStatistics() 做框选区域查询
+     *
+     * 默认关闭：只有需要区域查询的调用方 (图形界面的鼠标框选测温) 才需要承担每帧生成统计表的开销。
+     */
+    void setRegionStatisticsEnabled(bool enabled) { region_stats_enabled_ = enabled; }
+
+    const CameraParams &cameraParams() const { return camera_params_; }
+    const LensUndistortion &lensUndistortion() const { return lens_undistortion_; }
+    const RegionStatistics &regionStatistics() const { return region_stats_; }
+    const BlobClassifier &blobClassifier() const { return blob_classifier_; }
+    const cv::Size &frameSize() const { return frame_size_; }
+
+    // 8 位灰度帧 0/255 对应的温度
+    float gray_min_temperature = 20.0f;
+    float gray_max_temperature = 500.0f;
+
+private:
+    void rebuildThresholdMap();
+    void buildBackgroundFreezeMask(const std::vector<HotSpot> &hot_spots, const cv::Size &size);
+    int chooseAimTarget(const std::vector<SprayTarget> &spray_targets, float timestamp_seconds, float frame_interval_seconds);
+
+    CameraParams camera_params_;
+    cv::Size frame_size_;
+    std::unique_ptr<RangeProvider> range_provider_;
+    LensUndistortion lens_undistortion_;
+    ThresholdMapConfig threshold_map_config_;
+    ThresholdMapBuilder threshold_map_builder_;
+    cv::Mat threshold_map_;
+    TransformChain transform_chain_;
+    FireMap fire_map_;
+    EgoMotionEstimator ego_motion_;
+    HotspotTracker tracker_;
+    RegionTrackingConfig region_tracking_config_;
+    RegionTracker region_tracker_;
+    RateOfRiseModel rate_of_rise_model_;
+    bool background_model_enabled_;
+    BackgroundTemperatureModel background_model_;
+    cv::Mat background_freeze_mask_; // 本帧不学习背景的像素 (检出的热点与已确认的火焰轨迹)
+    cv::Mat static_allow_mask_;
+    ZoneMap zone_map_;
+    std::vector<ZoneFrameStats> zone_stats_;
+    BlobClassifier blob_classifier_;
+    BlobSplitConfig split_config_;
+    std::vector<float> analysis_thresholds_;
+    bool max_tree_enabled_;
+    MaxTree max_tree_;
+    RadiometricLut radiometric_lut_;
+    NonUniformityCorrection nuc_;
+    bool nuc_enabled_;
+    TemporalDenoiseConfig denoise_config_;
+    TemporalDenoiseFilter temporal_denoise_;
+    int temperature_type_;
+    bool region_stats_enabled_;
+    RegionStatistics region_stats_;
+    GimbalState previous_gimbal_;
+    float previous_timestamp_seconds_;
+    float frame_interval_seconds_;   // 帧间隔的滑动平均，判断闪烁频带是否可测
+    float unconfirmed_since_seconds_; // 当前未确认目标首次出现的时间，-1 表示没有
+    DetectionParameters detection_params_;
+    float grouping_distance_meters_;
+    FrameInputs frame_inputs_;
+    cv::Mat corrected_frame_;
+    cv::Mat resized_frame_;
+};
+
+#endif // FIRE_PIPELINE_H
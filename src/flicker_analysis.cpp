@@ -0,0 +1,102 @@
+// src/flicker_analysis.cpp
+#include "flicker_analysis.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const double TWO_PI = 6.283185307179586;
+    const float SAMPLE_INTERVAL_SMOOTHING = 0.1f; // 采样间隔 EMA 系数
+}
+
+FlickerAnalyzer::FlickerAnalyzer(int window_samples)
+    : window_(std::max(window_samples, 4))
+{
+    twiddles_.resize(window_ / 2 + 1);
+    for (int k = 0; k <= window_ / 2; ++k)
+        twiddles_[k] = std::polar(1.0, TWO_PI * k / window_);
+    reset();
+}
+
+void FlickerAnalyzer::reset()
+{
+    history_.assign(window_, 0.0f);
+    bins_.assign(window_ / 2 + 1, std::complex<double>(0.0, 0.0));
+    head_ = 0;
+    count_ = 0;
+    samples_since_refresh_ = 0;
+    sum_ = 0.0;
+    sum_sq_ = 0.0;
+    mean_dt_ = 0.0f;
+}
+
+void FlickerAnalyzer::addSample(float value, float dt_seconds)
+{
+    if (dt_seconds > 0.0f)
+        mean_dt_ = mean_dt_ > 0.0f ? mean_dt_ + SAMPLE_INTERVAL_SMOOTHING * (dt_seconds - mean_dt_) : dt_seconds;
+
+    // 窗口未满时旧样本视为 0，与初始化的零缓冲一致
+    const double x_old = history_[head_];
+    const double x_new = value;
+    history_[head_] = value;
+    head_ = (head_ + 1) % window_;
+    count_ = std::min(count_ + 1, window_);
+
+    sum_ += x_new - x_old;
+    sum_sq_ += x_new * x_new - x_old * x_old;
+    const double delta = x_new - x_old;
+    for (size_t k = 0; k < bins_.size(); ++k)
+        bins_[k] = (bins_[k] + delta) * twiddles_[k];
+
+    // 递推累积舍入误差，每满一个窗口按定义重算一次 (均摊后每样本仍为常数开销)
+    if (++samples_since_refresh_ >= window_)
+        recompute();
+}
+
+void FlickerAnalyzer::recompute()
+{
+    samples_since_refresh_ = 0;
+    sum_ = 0.0;
+    sum_sq_ = 0.0;
+    std::fill(bins_.begin(), bins_.end(), std::complex<double>(0.0, 0.0));
+    for (int m = 0; m < window_; ++m)
+    {
+        const double x = history_[(head_ + m) % window_]; // 从最旧样本开始
+        sum_ += x;
+        sum_sq_ += x * x;
+        for (size_t k = 0; k < bins_.size(); ++k)
+            bins_[k] += x * std::polar(1.0, -TWO_PI * static_cast<double>(k * m) / window_);
+    }
+}
+
+float FlickerAnalyzer::score(float band_min_hz, float band_max_hz) const
+{
+    if (!isReady() || mean_dt_ <= 0.0f)
+        return -1.0f;
+
+    const double fs = 1.0 / mean_dt_;
+    if (fs * 0.5 < band_min_hz)
+        return -1.0f; // 帧率太低，火焰频带超出奈奎斯特频率
+
+    // Parseval：交流总能量 = N * Σx² - (Σx)²，与各非直流频点 |X_k|² 之和相等
+    const double n = static_cast<double>(window_);
+    const double ac_energy = n * sum_sq_ - sum_ * sum_;
+    if (ac_energy <= 1e-9)
+        return 0.0f;
+
+    double band_energy = 0.0;
+    for (int k = 1; k <= window_ / 2; ++k)
+    {
+        const double f = k * fs / n;
+        if (f < band_min_hz || f > band_max_hz)
+            continue;
+        // 实信号频谱共轭对称，k 与 N-k 各占一份 (奈奎斯特频点只有一份)
+        const double weight = (2 * k == window_) ? 1.0 : 2.0;
+        band_energy += weight * std::norm(bins_[k]);
+    }
+
+    const double band_ratio = std::min(band_energy / ac_energy, 1.0);
+    const double amplitude = std::sqrt(ac_energy) / n; // 窗口内温度标准差
+    const double amplitude_weight = std::min(amplitude / FLICKER_MIN_AMPLITUDE_CELSIUS, 1.0);
+    return static_cast<float>(band_ratio * amplitude_weight);
+}
@@ -0,0 +1,60 @@
+// src/flicker_analysis.h
+#ifndef FLICKER_ANALYSIS_H
+#define FLICKER_ANALYSIS_H
+
+#include "utils.h"
+#include <complex>
+#include <vector>
+
+// --- 火焰闪烁频率分析 ---
+// 真实火焰的辐射强度在约 1~15 Hz 范围内闪烁，而排气管、暖风机等高温表面温度平稳。
+// 对每条热点轨迹的温度序列做滑动 DFT：每来一个样本，各频点按递推式
+//     X_k <- (X_k + x_new - x_old) * e^{j2πk/N}
+// 更新，窗口长度 N 固定，因此每条轨迹每帧的计算量为常数，无需保存或重算整段 FFT。
+// 得分为火焰频带能量占交流总能量的比例，并按波动幅度加权，抑制传感器噪声。
+
+class FlickerAnalyzer
+{
+public:
+    /**
+     * @param window_samples 滑动窗口长度 (样本数)，决定频率分辨率 fs/N
+     */
+    explicit FlickerAnalyzer(int window_samples = FLICKER_WINDOW_SAMPLES);
+
+    /**
+     * @brief 加入一个样本
+     *
+     * @param value 样本值 (如区域平均温度)
+     * @param dt_seconds 距上一个样本的时间间隔，用于估计采样率
+     */
+    void addSample(float value, float dt_seconds);
+
+    /**
+     * @brief 计算火焰频带能量得分
+     *
+     * @param band_min_hz 频带下限
+     * @param band_max_hz 频带上限
+     * @return [0,1] 得分；样本不足或采样率不足以分辨频带时返回 -1
+     */
+    float score(float band_min_hz = FLICKER_BAND_MIN_HZ, float band_max_hz = FLICKER_BAND_MAX_HZ) const;
+
+    bool isReady() const { return count_ >= window_; }
+    float sampleRateHz() const { return mean_dt_ > 0.0f ? 1.0f / mean_dt_ : 0.0f; }
+    void reset();
+
+private:
+    void recompute();
+
+    int window_;
+    std::vector<float> history_; // 环形缓冲，长度为 window_
+    int head_;                   // 下一个写入位置 (即窗口中最旧的样本)
+    int count_;
+    int samples_since_refresh_;
+    std::vector<std::complex<double>> bins_;     // k = 0..N/2
+    std::vector<std::complex<double>> twiddles_; // e^{j2πk/N}
+    double sum_;
+    double sum_sq_;
+    float mean_dt_;
+};
+
+#endif // FLICKER_ANALYSIS_H
@@ -0,0 +1,135 @@
+// src/hotspot_tracker.cpp
+#include "hotspot_tracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float GROWTH_RATE_SMOOTHING = 0.3f; // 面积增长率 EMA 系数
+
+    // 每帧向轨迹的闪烁分析器追加一个样本 (O(1))，并刷新得分
+    void addFlickerSample(HotspotTrack &track, float dt_seconds)
+    {
+        track.mean_flicker.addSample(track.mean_temperature, dt_seconds);
+        track.max_flicker.addSample(track.max_temperature, dt_seconds);
+        track.flicker_score = std::max(track.mean_flicker.score(), track.max_flicker.score());
+    }
+}
+
+HotspotTracker::HotspotTracker(float gate_pixels, int max_missed_frames)
+    : gate_pixels_(gate_pixels), max_missed_frames_(max_missed_frames), next_track_id_(0), last_timestamp_(-1.0f)
+{
+}
+
+const HotspotTrack *HotspotTracker::findTrack(int track_id) const
+{
+    for (const auto &track : tracks_)
+    {
+        if (track.track_id == track_id)
+            return &track;
+    }
+    return nullptr;
+}
+
+void HotspotTracker::update(std::vector<HotSpot> &hot_spots, const FrameMotion &motion, float timestamp_seconds)
+{
+    const float dt_seconds = last_timestamp_ >= 0.0f ? timestamp_seconds - last_timestamp_ : 0.0f;
+    last_timestamp_ = timestamp_seconds;
+
+    // 1. 运动补偿：把上一帧的轨迹位置预测到当前帧
+    if (motion.valid)
+    {
+        for (auto &track : tracks_)
+        {
+            cv::Point2f moved = motion.apply(track.pixel_centroid);
+            cv::Point2f delta = moved - track.pixel_centroid;
+            track.pixel_centroid = moved;
+            track.bounding_box.x += cvRound(delta.x);
+            track.bounding_box.y += cvRound(delta.y);
+        }
+    }
+
+    // 2. 贪心最近邻关联：按距离从小到大依次配对
+    struct Candidate
+    {
+        float distance;
+        size_t track_index;
+        size_t spot_index;
+    };
+    std::vector<Candidate> candidates;
+    const float gate2 = gate_pixels_ * gate_pixels_;
+    for (size_t t = 0; t < tracks_.size(); ++t)
+    {
+        for (size_t i = 0; i < hot_spots.size(); ++i)
+        {
+            cv::Point2f d = hot_spots[i].pixel_centroid - tracks_[t].pixel_centroid;
+            float dist2 = d.x * d.x + d.y * d.y;
+            if (dist2 <= gate2)
+                candidates.push_back({dist2, t, i});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b)
+              { return a.distance < b.distance; });
+
+    std::vector<bool> track_used(tracks_.size(), false);
+    std::vector<bool> spot_used(hot_spots.size(), false);
+    for (const auto &c : candidates)
+    {
+        if (track_used[c.track_index] || spot_used[c.spot_index])
+            continue;
+        track_used[c.track_index] = true;
+        spot_used[c.spot_index] = true;
+
+        HotspotTrack &track = tracks_[c.track_index];
+        const HotSpot &spot = hot_spots[c.spot_index];
+        track.pixel_centroid = spot.pixel_centroid;
+        track.bounding_box = cv::boundingRect(spot.contour_pixels);
+        if (dt_seconds > 1e-3f && track.area_pixels > 0.0)
+        {
+            float growth = static_cast<float>((spot.area_pixels - track.area_pixels) / (track.area_pixels * dt_seconds));
+            track.area_growth_rate += GROWTH_RATE_SMOOTHING * (growth - track.area_growth_rate);
+        }
+        track.area_pixels = spot.area_pixels;
+        track.max_temperature = spot.max_temperature;
+        track.mean_temperature = spot.mean_temperature;
+        track.age_frames++;
+        track.missed_frames = 0;
+        addFlickerSample(track, dt_seconds);
+        hot_spots[c.spot_index].track_id = track.track_id;
+        hot_spots[c.spot_index].flicker_score = track.flicker_score;
+        hot_spots[c.spot_index].area_growth_rate = track.area_growth_rate;
+    }
+
+    // 3. 未关联轨迹计数丢失，超时删除；短暂丢失期间保持上一个样本，使闪烁序列采样间隔均匀
+    for (size_t t = 0; t < tracks_.size(); ++t)
+    {
+        if (!track_used[t])
+        {
+            tracks_[t].missed_frames++;
+            addFlickerSample(tracks_[t], dt_seconds);
+        }
+    }
+    tracks_.erase(std::remove_if(tracks_.begin(), tracks_.end(),
+                                 [this](const HotspotTrack &track)
+                                 { return track.missed_frames > max_missed_frames_; }),
+                  tracks_.end());
+
+    // 4. 未关联热点新建轨迹
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+    {
+        if (spot_used[i])
+            continue;
+        HotspotTrack track;
+        track.track_id = next_track_id_++;
+        track.pixel_centroid = hot_spots[i].pixel_centroid;
+        track.bounding_box = cv::boundingRect(hot_spots[i].contour_pixels);
+        track.area_pixels = hot_spots[i].area_pixels;
+        track.max_temperature = hot_spots[i].max_temperature;
+        track.mean_temperature = hot_spots[i].mean_temperature;
+        track.age_frames = 1;
+        addFlickerSample(track, 0.0f);
+        tracks_.push_back(track);
+        hot_spots[i].track_id = track.track_id;
+    }
+}
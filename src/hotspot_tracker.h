@@ -0,0 +1,65 @@
+// src/hotspot_tracker.h
+#ifndef HOTSPOT_TRACKER_H
+#define HOTSPOT_TRACKER_H
+
+#include "utils.h"
+#include "ego_motion.h"
+#include "flicker_analysis.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+
+// --- 热点跟踪 ---
+// 跨帧关联热点，为每个热点分配稳定的 track_id。
+// 关联前先用帧间运动把上一帧的轨迹位置平移到当前帧，整幅场景平移不会造成轨迹断裂。
+// 每条轨迹保存区域平均温度与最高温度的时间序列 (滑动 DFT 状态)，用于火焰闪烁判定。
+
+struct HotspotTrack
+{
+    int track_id;
+    cv::Point2f pixel_centroid; // 当前帧像素坐标 (已做运动补偿)
+    cv::Rect bounding_box;
+    double area_pixels;
+    float max_temperature;
+    float mean_temperature;
+    int age_frames;    // 被关联上的总帧数
+    int missed_frames; // 连续未关联帧数
+    FlickerAnalyzer mean_flicker; // 区域平均温度序列
+    FlickerAnalyzer max_flicker;  // 区域最高温度序列
+    float flicker_score;          // 两个序列得分的较大值，-1 表示尚无法判定
+    float area_growth_rate;       // 面积相对增长率 (1/s) 的平滑估计
+
+    HotspotTrack() : track_id(-1), area_pixels(0.0), max_temperature(0.0f), mean_temperature(0.0f),
+                     age_frames(0), missed_frames(0), flicker_score(-1.0f), area_growth_rate(0.0f) {}
+};
+
+class HotspotTracker
+{
+public:
+    /**
+     * @param gate_pixels 关联门限 (像素)，超过该距离不关联
+     * @param max_missed_frames 连续丢失超过该帧数删除轨迹
+     */
+    explicit HotspotTracker(float gate_pixels = 25.0f, int max_missed_frames = 5);
+
+    /**
+     * @brief 用当前帧热点更新轨迹，并写回 hot_spots[i] 的 track_id、flicker_score 与 area_growth_rate
+     *
+     * @param hot_spots 当前帧热点
+     * @param motion 当前帧相对上一帧的运动 (EgoMotionEstimator 输出)
+     * @param timestamp_seconds 当前帧时间戳，用于闪烁分析的采样率估计
+     */
+    void update(std::vector<HotSpot> &hot_spots, const FrameMotion &motion, float timestamp_seconds);
+
+    const std::vector<HotspotTrack> &tracks() const { return tracks_; }
+    const HotspotTrack *findTrack(int track_id) const;
+
+private:
+    float gate_pixels_;
+    int max_missed_frames_;
+    int next_track_id_;
+    float last_timestamp_;
+    std::vector<HotspotTrack> tracks_;
+};
+
+#endif // HOTSPOT_TRACKER_H
@@ -0,0 +1,68 @@
+// src/lens_undistortion.cpp
+#include "lens_undistortion.h"
+#include <opencv2/calib3d.hpp>
+#include <iostream>
+
+void LensUndistortion::configure(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs, const cv::Size &image_size)
+{
+    enabled_ = false;
+    map1_.release();
+    map2_.release();
+    if (camera_matrix.empty() || dist_coeffs.empty() || cv::countNonZero(dist_coeffs) == 0)
+        return;
+
+    camera_matrix.convertTo(camera_matrix_, CV_64F);
+    dist_coeffs.convertTo(dist_coeffs_, CV_64F);
+    cv::initUndistortRectifyMap(camera_matrix_, dist_coeffs_, cv::Mat(), camera_matrix_, image_size, CV_16SC2, map1_, map2_);
+    enabled_ = true;
+    std::cout << "Lens undistortion enabled (" << dist_coeffs_.total() << " coefficients)." << std::endl;
+}
+
+void LensUndistortion::remapForDisplay(const cv::Mat &src, cv::Mat &dst) const
+{
+    if (!enabled_ || src.size() != map1_.size())
+    {
+        dst = src;
+        return;
+    }
+    cv::remap(src, dst, map1_, map2_, cv::INTER_LINEAR, cv::BORDER_CONSTANT);
+}
+
+void LensUndistortion::undistortPoints(std::vector<cv::Point2f> &points) const
+{
+    if (!enabled_ || points.empty())
+        return;
+    cv::undistortPoints(points, points, camera_matrix_, dist_coeffs_, cv::noArray(), camera_matrix_);
+}
+
+void LensUndistortion::distortPoints(std::vector<cv::Point2f> &points) const
+{
+    if (!enabled_ || points.empty())
+        return;
+    // 无畸变像素 -> 归一化平面 (z = 1) 上的点，再按畸变模型投影
+    const double fx = camera_matrix_.at<double>(0, 0), fy = camera_matrix_.at<double>(1, 1);
+    const double cx = camera_matrix_.at<double>(0, 2), cy = camera_matrix_.at<double>(1, 2);
+    std::vector<cv::Point3f> rays(points.size());
+    for (size_t i = 0; i < points.size(); ++i)
+        rays[i] = cv::Point3f(static_cast<float>((points[i].x - cx) / fx), static_cast<float>((points[i].y - cy) / fy), 1.0f);
+    const cv::Mat zero = cv::Mat::zeros(3, 1, CV_64F);
+    cv::projectPoints(rays, zero, zero, camera_matrix_, dist_coeffs_, points);
+}
+
+void LensUndistortion::undistortHotspot(HotSpot &spot) const
+{
+    if (!enabled_)
+        return;
+
+    // 质心与轮廓点合并为一次调用
+    std::vector<cv::Point2f> points;
+    points.reserve(spot.contour_pixels.size() + 1);
+    points.push_back(spot.pixel_centroid);
+    for (const auto &p : spot.contour_pixels)
+        points.emplace_back(static_cast<float>(p.x), static_cast<float>(p.y));
+    undistortPoints(points);
+
+    spot.pixel_centroid = points[0];
+    for (size_t i = 0; i < spot.contour_pixels.size(); ++i)
+        spot.contour_pixels[i] = cv::Point(cvRound(points[i + 1].x), cvRound(points[i + 1].y));
+}
@@ -0,0 +1,63 @@
+// src/lens_undistortion.h
+#ifndef LENS_UNDISTORTION_H
+#define LENS_UNDISTORTION_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <vector>
+
+// --- 镜头畸变校正 ---
+// 每帧对整幅温度矩阵做 cv::undistort 的开销与温度转换相当，且检测本身不需要无畸变图像。
+// 因此按用途分两条路径：
+//   * 显示：启动时用 initUndistortRectifyMap 生成一次定点映射表 (CV_16SC2 + CV_16UC1)，
+//     每帧只对 8 位显示图做 remap (OpenCV 对定点映射表走 SIMD 双线性插值)；
+//   * 瞄准：检测仍在原始 (有畸变) 图像上进行，只把热点质心、轮廓点和测距点用 undistortPoints 稀疏校正，
+//     后续测距、世界坐标、分组与云台角度计算都使用无畸变像素坐标。
+// 校正后的像素坐标仍以原内参矩阵表示 (P = K)，与显示映射表一致。
+
+class LensUndistortion
+{
+public:
+    /**
+     * @brief 设置相机参数并预先计算显示映射表
+     *
+     * @param camera_matrix 相机内参矩阵
+     * @param dist_coeffs 畸变系数，全零或为空时不做校正
+     * @param image_size 温度矩阵分辨率
+     */
+    void configure(const cv::Mat &camera_matrix, const cv::Mat &dist_coeffs, const cv::Size &image_size);
+
+    bool isEnabled() const { return enabled_; }
+
+    /**
+     * @brief 用缓存的定点映射表校正显示图像，未启用时直接共享输入
+     */
+    void remapForDisplay(const cv::Mat &src, cv::Mat &dst) const;
+
+    /**
+     * @brief 稀疏校正像素坐标 (原地)，未启用时不做任何处理
+     */
+    void undistortPoints(std::vector<cv::Point2f> &points) const;
+
+    /**
+     * @brief undistortPoints 的逆映射：无畸变像素坐标映射回原始 (有畸变) 图像坐标 (原地)，未启用时不做任何处理
+     *
+     * 用于把显示/瞄准坐标系下的区域 (框选矩形、热点轮廓) 对应回温度矩阵。
+     */
+    void distortPoints(std::vector<cv::Point2f> &points) const;
+
+    /**
+     * @brief 校正热点的质心与轮廓点
+     */
+    void undistortHotspot(HotSpot &spot) const;
+
+private:
+    bool enabled_ = false;
+    cv::Mat camera_matrix_;
+    cv::Mat dist_coeffs_;
+    cv::Mat map1_; // CV_16SC2 整数坐标
+    cv::Mat map2_; // CV_16UC1 插值系数索引
+};
+
+#endif // LENS_UNDISTORTION_H
@@ -0,0 +1,96 @@
+// src/main_headless.cpp
+// 无界面主程序：与 main.cpp 相同的处理流程 (见 fire_pipeline.h)，不链接 highgui，用于部署在无显示器的设备上
+//
+// 用法：
+//   fire_detection_headless [图像 | 录制序列目录] [--params params.xml] [--frames N]
+//
+// 输入为录制序列目录时按顺序处理每一帧 (时间戳按 sequence.yml 的帧间隔，录制了 gimbal_angles 时使用逐帧云台角度)，
+// 为单幅图像时重复处理 --frames 次 (默认 1)。
+// 结束时输出处理帧数与单帧平均耗时，加载了热点分类器时同时输出推理耗时与超出预算的帧数。
+
+#include "fire_pipeline.h"
+#include "sequence_io.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+int main(int argc, char **argv)
+{
+    std::string input = "../testImage/02.JPG";
+    std::string params_file = "../config/params.xml";
+    int repeat_frames = 1;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--params" && i + 1 < argc)
+            params_file = argv[++i];
+        else if (arg == "--frames" && i + 1 < argc)
+            repeat_frames = std::atoi(argv[++i]);
+        else if (!arg.empty() && arg[0] != '-')
+            input = arg;
+        else
+        {
+            std::cerr << "Usage: fire_detection_headless [image | sequence_dir] [--params params.xml] [--frames N]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<std::string> frame_paths;
+    float frame_interval_seconds = 1.0f / 30.0f;
+    FirePipeline pipeline;
+    RecordedSequence sequence;
+    if (std::filesystem::is_directory(input))
+    {
+        if (!loadRecordedSequence(input, sequence))
+            return 1;
+        frame_paths = sequence.frame_paths;
+        frame_interval_seconds = sequence.frame_interval_seconds;
+        pipeline.gray_min_temperature = sequence.min_temperature;
+        pipeline.gray_max_temperature = sequence.max_temperature;
+    }
+    else
+    {
+        frame_paths.assign(std::max(repeat_frames, 1), input);
+    }
+    pipeline.configure(params_file, cv::Size(384, 288));
+
+    std::cout << "Vision Processing for Fire Suppression Started (headless, " << frame_paths.size() << " frames)." << std::endl;
+
+    // 云台当前角度取录制的编码器角度，未录制时与底盘里程计一样为模拟值 (实际应用中从云台反馈与底盘控制器获取)
+    GimbalState gimbal;
+    OdometryState odometry;
+    cv::Mat frame;
+    FrameResult result;
+    int processed_frames = 0;
+    double total_ms = 0.0;
+    for (size_t f = 0; f < frame_paths.size(); ++f)
+    {
+        const int64 start = cv::getTickCount();
+        sequence.gimbalAnglesForFrame(static_cast<int>(f), gimbal.azimuth_degrees, gimbal.pitch_degrees);
+        if (!readThermalFrame(frame_paths[f], frame) ||
+            !pipeline.processFrame(frame, gimbal, odometry, static_cast<float>(f) * frame_interval_seconds, result))
+        {
+            std::cerr << "Error: Could not generate temperature matrix from image." << std::endl;
+            break;
+        }
+        total_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+        processed_frames++;
+        pipeline.printReport(result);
+    }
+
+    std::cout << "Vision Processing Terminated: " << processed_frames << " frames";
+    if (processed_frames > 0)
+        std::cout << ", " << total_ms / processed_frames << " ms/frame";
+    std::cout << std::endl;
+    const BlobClassifier &classifier = pipeline.blobClassifier();
+    if (classifier.classifiedFrames() > 0)
+    {
+        std::cout << "Blob classifier: max " << classifier.maxInferenceMicroseconds() << " us, "
+                  << classifier.budgetOverrunFrames() << "/" << classifier.classifiedFrames()
+                  << " frames over budget (" << BLOB_CLASSIFIER_BUDGET_MICROSECONDS << " us)" << std::endl;
+    }
+    return processed_frames > 0 ? 0 : 1;
+}
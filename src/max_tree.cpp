@@ -0,0 +1,283 @@
+// src/max_tree.cpp
+#include "max_tree.h"
+#include "temperature_conversion.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const int MAX_TREE_LEVELS = 4096; // 量化级别上限 (含根级别 0)
+}
+
+MaxTree::MaxTree(float step_celsius, float floor_celsius)
+    : step_(step_celsius > 0.0f ? step_celsius : 1.0f), floor_(floor_celsius), root_node_(-1)
+{
+}
+
+int MaxTree::findRoot(int p)
+{
+    int root = p;
+    while (zpar_[root] != root)
+        root = zpar_[root];
+    // 路径压缩
+    while (zpar_[p] != root)
+    {
+        int next = zpar_[p];
+        zpar_[p] = root;
+        p = next;
+    }
+    return root;
+}
+
+void MaxTree::build(const cv::Mat &temp_matrix)
+{
+    node_level_.clear();
+    node_parent_.clear();
+    node_first_child_.clear();
+    node_next_sibling_.clear();
+    node_subtree_max_level_.clear();
+    node_area_.clear();
+    node_max_temperature_.clear();
+    node_sum_xy_.clear();
+    node_bbox_.clear();
+    root_node_ = -1;
+
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Max-tree input must be CV_32FC1 or CV_16SC1." << std::endl;
+        return;
+    }
+
+    size_ = temp_matrix.size();
+    const int width = size_.width;
+    const int n = size_.area();
+    std::vector<float> row_scratch;
+    level_.resize(n);
+    sorted_.resize(n);
+    parent_.resize(n);
+    zpar_.assign(n, -1);
+    pixel_node_.resize(n);
+
+    // 1. 量化并按级别降序计数排序
+    std::vector<int> histogram(MAX_TREE_LEVELS + 1, 0);
+    const float inv_step = 1.0f / step_;
+    for (int y = 0; y < size_.height; ++y)
+    {
+        const float *t = temperatureRow(temp_matrix, y, row_scratch);
+        int *l = &level_[y * width];
+        for (int x = 0; x < width; ++x)
+        {
+            int level = 0;
+            if (t[x] >= floor_)
+                level = std::min(1 + static_cast<int>((t[x] - floor_) * inv_step), MAX_TREE_LEVELS - 1);
+            l[x] = level;
+            histogram[level]++;
+        }
+    }
+    std::vector<int> offset(MAX_TREE_LEVELS, 0);
+    for (int level = MAX_TREE_LEVELS - 2, acc = histogram[MAX_TREE_LEVELS - 1]; level >= 0; --level)
+    {
+        offset[level] = acc;
+        acc += histogram[level];
+    }
+    for (int p = 0; p < n; ++p)
+        sorted_[offset[level_[p]]++] = p;
+
+    // 2. 按级别降序合并邻域 (8 连通)，后处理的像素成为先处理集合的父节点
+    for (int i = 0; i < n; ++i)
+    {
+        const int p = sorted_[i];
+        parent_[p] = p;
+        zpar_[p] = p;
+        const int px = p % width, py = p / width;
+        for (int dy = -1; dy <= 1; ++dy)
+        {
+            const int ny = py + dy;
+            if (ny < 0 || ny >= size_.height)
+                continue;
+            for (int dx = -1; dx <= 1; ++dx)
+            {
+                const int nx = px + dx;
+                if ((dx == 0 && dy == 0) || nx < 0 || nx >= width)
+                    continue;
+                const int q = ny * width + nx;
+                if (zpar_[q] < 0)
+                    continue; // 尚未处理 (级别更低)
+                const int r = findRoot(q);
+                if (r != p)
+                {
+                    parent_[r] = p;
+                    zpar_[r] = p;
+                }
+            }
+        }
+    }
+
+    // 3. 规范化：同级别的像素都指向该连通域的代表像素
+    for (int i = n - 1; i >= 0; --i)
+    {
+        const int p = sorted_[i];
+        const int q = parent_[p];
+        if (level_[parent_[q]] == level_[q])
+            parent_[p] = parent_[q];
+    }
+
+    // 4. 建立节点 (根先于子节点创建)
+    const int root_pixel = sorted_[n - 1];
+    for (int i = n - 1; i >= 0; --i)
+    {
+        const int p = sorted_[i];
+        const bool canonical = (p == root_pixel) || level_[parent_[p]] != level_[p];
+        if (!canonical)
+        {
+            pixel_node_[p] = pixel_node_[parent_[p]];
+            continue;
+        }
+        const int node = static_cast<int>(node_level_.size());
+        const int parent_node = (p == root_pixel) ? -1 : pixel_node_[parent_[p]];
+        pixel_node_[p] = node;
+        node_level_.push_back(level_[p]);
+        node_parent_.push_back(parent_node);
+        node_first_child_.push_back(-1);
+        node_next_sibling_.push_back(-1);
+        if (parent_node >= 0)
+        {
+            node_next_sibling_[node] = node_first_child_[parent_node];
+            node_first_child_[parent_node] = node;
+        }
+    }
+    root_node_ = pixel_node_[root_pixel];
+
+    // 5. 属性：先累计各节点自身像素，再按级别降序 (子节点在前) 向父节点传递
+    const int node_count = static_cast<int>(node_level_.size());
+    node_subtree_max_level_ = node_level_;
+    node_area_.assign(node_count, 0.0);
+    node_max_temperature_.assign(node_count, -FLT_MAX);
+    node_sum_xy_.assign(node_count, cv::Point2d(0.0, 0.0));
+    node_bbox_.assign(node_count, cv::Rect());
+    std::vector<int> min_x(node_count, INT_MAX), min_y(node_count, INT_MAX), max_x(node_count, -1), max_y(node_count, -1);
+    for (int y = 0; y < size_.height; ++y)
+    {
+        const float *t = temperatureRow(temp_matrix, y, row_scratch);
+        for (int x = 0; x < width; ++x)
+        {
+            const int node = pixel_node_[y * width + x];
+            node_area_[node] += 1.0;
+            node_max_temperature_[node] = std::max(node_max_temperature_[node], t[x]);
+            node_sum_xy_[node] += cv::Point2d(x, y);
+            min_x[node] = std::min(min_x[node], x);
+            min_y[node] = std::min(min_y[node], y);
+            max_x[node] = std::max(max_x[node], x);
+            max_y[node] = std::max(max_y[node], y);
+        }
+    }
+    // 节点按根优先的顺序编号，倒序遍历即保证子节点先于父节点
+    for (int node = node_count - 1; node >= 0; --node)
+    {
+        const int parent = node_parent_[node];
+        node_bbox_[node] = cv::Rect(min_x[node], min_y[node], max_x[node] - min_x[node] + 1, max_y[node] - min_y[node] + 1);
+        if (parent < 0)
+            continue;
+        node_area_[parent] += node_area_[node];
+        node_max_temperature_[parent] = std::max(node_max_temperature_[parent], node_max_temperature_[node]);
+        node_sum_xy_[parent] += node_sum_xy_[node];
+        node_subtree_max_level_[parent] = std::max(node_subtree_max_level_[parent], node_subtree_max_level_[node]);
+        min_x[parent] = std::min(min_x[parent], min_x[node]);
+        min_y[parent] = std::min(min_y[parent], min_y[node]);
+        max_x[parent] = std::max(max_x[parent], max_x[node]);
+        max_y[parent] = std::max(max_y[parent], max_y[node]);
+    }
+}
+
+void MaxTree::query(float threshold, double min_area, std::vector<MaxTreeComponent> &components) const
+{
+    components.clear();
+    if (root_node_ < 0)
+        return;
+
+    const int query_level = threshold < floor_ ? 0 : 1 + static_cast<int>(std::floor((threshold - floor_) / step_));
+
+    // 从根向下：级别已达到阈值的节点即为一个连通域；子树最高级别不足的分支整体剪掉
+    std::vector<int> stack;
+    stack.push_back(root_node_);
+    while (!stack.empty())
+    {
+        const int node = stack.back();
+        stack.pop_back();
+        if (node_level_[node] >= query_level)
+        {
+            if (node_area_[node] < min_area)
+                continue;
+            MaxTreeComponent component;
+            component.node = node;
+            component.level_temperature = node_level_[node] == 0 ? floor_ : floor_ + (node_level_[node] - 1) * step_;
+            component.area_pixels = node_area_[node];
+            component.max_temperature = node_max_temperature_[node];
+            component.pixel_centroid = cv::Point2f(static_cast<float>(node_sum_xy_[node].x / node_area_[node]),
+                                                   static_cast<float>(node_sum_xy_[node].y / node_area_[node]));
+            component.bounding_box = node_bbox_[node];
+            components.push_back(component);
+            continue;
+        }
+        for (int child = node_first_child_[node]; child >= 0; child = node_next_sibling_[child])
+        {
+            if (node_subtree_max_level_[child] >= query_level)
+                stack.push_back(child);
+        }
+    }
+}
+
+void MaxTree::componentMask(int node, cv::Mat &mask) const
+{
+    mask.release();
+    if (node < 0 || node >= nodeCount())
+        return;
+
+    const cv::Rect &box = node_bbox_[node];
+    mask = cv::Mat::zeros(box.size(), CV_8UC1);
+    const int target_level = node_level_[node];
+    for (int y = 0; y < box.height; ++y)
+    {
+        uchar *m = mask.ptr<uchar>(y);
+        for (int x = 0; x < box.width; ++x)
+        {
+            // 沿父链上溯到目标级别，判断像素是否属于该子树
+            int current = pixel_node_[(box.y + y) * size_.width + box.x + x];
+            while (current >= 0 && node_level_[current] > target_level)
+                current = node_parent_[current];
+            m[x] = (current == node) ? 255 : 0;
+        }
+    }
+}
+
+bool loadMaxTreeThresholds(const std::string &filename, std::vector<float> &thresholds)
+{
+    thresholds.clear();
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    bool enabled = false;
+    if (fs["max_tree_enabled"].isInt())
+        enabled = static_cast<int>(fs["max_tree_enabled"]) != 0;
+    else
+        std::cout << "Warning: max_tree_enabled not found in " << filename << std::endl;
+
+    cv::Mat values;
+    fs["max_tree_thresholds"] >> values;
+    fs.release();
+    if (!enabled || values.empty())
+        return false;
+
+    values.convertTo(values, CV_32F);
+    const float *v = values.ptr<float>();
+    thresholds.assign(v, v + values.total());
+    std::sort(thresholds.begin(), thresholds.end());
+    return true;
+}
@@ -0,0 +1,98 @@
+// src/max_tree.h
+#ifndef MAX_TREE_H
+#define MAX_TREE_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 温度最大树 (组件树) ---
+// 每帧把量化后的温度矩阵建成一棵最大树：每个节点是某个温度级别以上的一个连通域 (8 连通)，
+// 父节点是包含它的更低级别连通域。建树使用按级别降序处理像素的并查集算法 (计数排序 + 路径压缩)，
+// 每个节点累积面积、最高温度、质心和外接矩形。
+// 建树一次后，任意阈值下的全部连通域都可以从根向下查询得到：子树最高温度低于阈值的分支直接剪掉，
+// 查询耗时只与输出数量 (及其祖先路径) 有关，不需要对每个阈值再做整帧阈值化和连通域标记。
+// 量化步长为 step_celsius，查询结果的温度误差不超过一个步长。
+
+struct MaxTreeComponent
+{
+    int node;                  // 节点编号，可用于 componentMask
+    float level_temperature;   // 该节点的量化温度级别
+    double area_pixels;
+    float max_temperature;
+    cv::Point2f pixel_centroid;
+    cv::Rect bounding_box;
+};
+
+class MaxTree
+{
+public:
+    /**
+     * @param step_celsius 温度量化步长
+     * @param floor_celsius 低于该温度的像素合并为根级别，缩小树的规模
+     */
+    explicit MaxTree(float step_celsius = MAX_TREE_STEP_CELSIUS, float floor_celsius = RATE_OF_RISE_MIN_TEMPERATURE_CELSIUS);
+
+    /**
+     * @brief 由温度矩阵建树
+     *
+     * @param temp_matrix 温度矩阵 (CV_32FC1)
+     */
+    void build(const cv::Mat &temp_matrix);
+
+    /**
+     * @brief 查询温度不低于 threshold 的全部连通域
+     *
+     * @param threshold 温度阈值
+     * @param min_area 面积小于该值的连通域不输出
+     * @param components 输出连通域
+     */
+    void query(float threshold, double min_area, std::vector<MaxTreeComponent> &components) const;
+
+    /**
+     * @brief 生成某个连通域的掩码 (外接矩形内，CV_8UC1)
+     */
+    void componentMask(int node, cv::Mat &mask) const;
+
+    int nodeCount() const { return static_cast<int>(node_level_.size()); }
+    bool empty() const { return node_level_.empty(); }
+
+private:
+    int findRoot(int p);
+
+    float step_;
+    float floor_;
+    cv::Size size_;
+
+    // 像素级数组 (跨帧复用)
+    std::vector<int> level_;  // 量化级别
+    std::vector<int> sorted_; // 按级别降序排列的像素
+    std::vector<int> parent_; // 规范化后的父像素
+    std::vector<int> zpar_;   // 并查集
+    std::vector<int> pixel_node_;
+
+    // 节点数组
+    std::vector<int> node_level_;
+    std::vector<int> node_parent_;
+    std::vector<int> node_first_child_;
+    std::vector<int> node_next_sibling_;
+    std::vector<int> node_subtree_max_level_;
+    std::vector<double> node_area_;
+    std::vector<float> node_max_temperature_;
+    std::vector<cv::Point2d> node_sum_xy_;
+    std::vector<cv::Rect> node_bbox_;
+    int root_node_;
+};
+
+/**
+ * @brief 从参数文件读取多阈值分析配置
+ *
+ * @param filename 参数文件路径
+ * @param thresholds 输出阈值列表 (max_tree_thresholds，如阴燃/燃烧/轰燃)
+ * @return 配置了 max_tree_enabled=1 且阈值非空时返回 true
+ */
+bool loadMaxTreeThresholds(const std::string &filename, std::vector<float> &thresholds);
+
+#endif // MAX_TREE_H
@@ -0,0 +1,276 @@
+// src/nuc_correction.cpp
+#include "nuc_correction.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const int NUC_MAX_REPLACEMENT_RADIUS = 8; // 坏点替换像素的最大搜索半径
+
+    float medianOf(const cv::Mat &values)
+    {
+        std::vector<float> v;
+        v.reserve(values.total());
+        for (int y = 0; y < values.rows; ++y)
+        {
+            const float *p = values.ptr<float>(y);
+            v.insert(v.end(), p, p + values.cols);
+        }
+        if (v.empty())
+            return 0.0f;
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        return v[v.size() / 2];
+    }
+
+    // 在逐层扩大的方框上寻找距离最近的正常像素
+    int findReplacement(const cv::Mat &bad_mask, int x, int y)
+    {
+        for (int r = 1; r <= NUC_MAX_REPLACEMENT_RADIUS; ++r)
+        {
+            int best = -1, best_d2 = INT_MAX;
+            for (int dy = -r; dy <= r; ++dy)
+            {
+                const int ny = y + dy;
+                if (ny < 0 || ny >= bad_mask.rows)
+                    continue;
+                for (int dx = -r; dx <= r; ++dx)
+                {
+                    if (std::max(std::abs(dx), std::abs(dy)) != r)
+                        continue; // 只检查本层方框边缘
+                    const int nx = x + dx;
+                    if (nx < 0 || nx >= bad_mask.cols || bad_mask.at<uchar>(ny, nx))
+                        continue;
+                    const int d2 = dx * dx + dy * dy;
+                    if (d2 < best_d2)
+                    {
+                        best_d2 = d2;
+                        best = ny * bad_mask.cols + nx;
+                    }
+                }
+            }
+            if (best >= 0)
+                return best;
+        }
+        return -1;
+    }
+
+    template <typename T>
+    void correctFrame(const cv::Mat &frame, const NonUniformityCorrection &nuc, cv::Mat &corrected)
+    {
+        corrected.create(frame.size(), frame.type());
+        for (int y = 0; y < frame.rows; ++y)
+        {
+            const T *src = frame.ptr<T>(y);
+            const float *g = nuc.gain.ptr<float>(y);
+            const float *o = nuc.offset.ptr<float>(y);
+            T *dst = corrected.ptr<T>(y);
+            for (int x = 0; x < frame.cols; ++x)
+                dst[x] = cv::saturate_cast<T>(g[x] * src[x] + o[x]);
+        }
+        // 替换像素均为正常像素，其校正值在上面已经算出
+        T *data = corrected.ptr<T>();
+        const int total = static_cast<int>(frame.total());
+        for (int i = 0; i < nuc.bad_pixels.rows; ++i)
+        {
+            const int bad = nuc.bad_pixels.at<int>(i, 0);
+            const int src = nuc.bad_pixels.at<int>(i, 1);
+            if (bad >= 0 && bad < total && src >= 0 && src < total)
+                data[bad] = data[src];
+        }
+    }
+}
+
+bool NonUniformityCorrection::isValid(const cv::Size &size) const
+{
+    return gain.size() == size && gain.type() == CV_32FC1 &&
+           offset.size() == size && offset.type() == CV_32FC1 &&
+           (bad_pixels.empty() || (bad_pixels.cols == 2 && bad_pixels.type() == CV_32SC1));
+}
+
+bool applyNonUniformityCorrection(const cv::Mat &frame, const NonUniformityCorrection &nuc, cv::Mat &corrected)
+{
+    if (!nuc.isValid(frame.size()) || (frame.type() != CV_8UC1 && frame.type() != CV_16UC1))
+    {
+        frame.copyTo(corrected);
+        return false;
+    }
+    if (frame.type() == CV_8UC1)
+        correctFrame<uchar>(frame, nuc, corrected);
+    else
+        correctFrame<ushort>(frame, nuc, corrected);
+    return true;
+}
+
+bool loadNonUniformityCorrection(const std::string &params_file, NonUniformityCorrection &nuc)
+{
+    cv::FileStorage fs(params_file, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << params_file << std::endl;
+        return false;
+    }
+    std::string calibration_file;
+    if (fs["nuc_calibration_file"].isString())
+        fs["nuc_calibration_file"] >> calibration_file;
+    fs.release();
+
+    if (calibration_file.empty())
+    {
+        std::cout << "Warning: nuc_calibration_file not found in " << params_file << ", NUC disabled." << std::endl;
+        return false;
+    }
+    return readNonUniformityCorrection(calibration_file, nuc);
+}
+
+bool readNonUniformityCorrection(const std::string &filename, NonUniformityCorrection &nuc)
+{
+    nuc = NonUniformityCorrection();
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cout << "Warning: NUC calibration file " << filename << " not found, NUC disabled." << std::endl;
+        return false;
+    }
+    fs["gain"] >> nuc.gain;
+    fs["offset"] >> nuc.offset;
+    fs["bad_pixels"] >> nuc.bad_pixels;
+    fs.release();
+
+    if (!nuc.isValid(nuc.gain.size()) || nuc.gain.empty())
+    {
+        std::cerr << "Error: Invalid NUC calibration in " << filename << std::endl;
+        nuc = NonUniformityCorrection();
+        return false;
+    }
+    // 转换阶段按行顺序消费替换表，手工编辑过的文件需重新排序
+    if (!nuc.bad_pixels.empty())
+    {
+        std::vector<std::pair<int, int>> pairs(nuc.bad_pixels.rows);
+        for (int i = 0; i < nuc.bad_pixels.rows; ++i)
+            pairs[i] = std::make_pair(nuc.bad_pixels.at<int>(i, 0), nuc.bad_pixels.at<int>(i, 1));
+        std::sort(pairs.begin(), pairs.end());
+        for (int i = 0; i < nuc.bad_pixels.rows; ++i)
+        {
+            nuc.bad_pixels.at<int>(i, 0) = pairs[i].first;
+            nuc.bad_pixels.at<int>(i, 1) = pairs[i].second;
+        }
+    }
+    std::cout << "Loaded NUC calibration (" << nuc.gain.cols << "x" << nuc.gain.rows << ", "
+              << nuc.bad_pixels.rows << " bad pixels)." << std::endl;
+    return true;
+}
+
+bool writeNonUniformityCorrection(const std::string &filename, const NonUniformityCorrection &nuc)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::WRITE);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not write NUC calibration file: " << filename << std::endl;
+        return false;
+    }
+    fs << "gain" << nuc.gain;
+    fs << "offset" << nuc.offset;
+    fs << "bad_pixels" << nuc.bad_pixels;
+    fs.release();
+    return true;
+}
+
+bool computeTwoPointCorrection(const cv::Mat &cold_mean,
+                               const cv::Mat &hot_mean,
+                               const cv::Mat &temporal_noise,
+                               float max_response_deviation,
+                               float max_noise_ratio,
+                               NonUniformityCorrection &nuc)
+{
+    nuc = NonUniformityCorrection();
+    if (cold_mean.empty() || cold_mean.size() != hot_mean.size() ||
+        cold_mean.type() != CV_32FC1 || hot_mean.type() != CV_32FC1)
+    {
+        std::cerr << "Error: NUC reference frames must be CV_32FC1 of equal size." << std::endl;
+        return false;
+    }
+
+    cv::Mat response = hot_mean - cold_mean;
+    const float median_response = medianOf(response);
+    if (median_response <= 1e-3f)
+    {
+        std::cerr << "Error: Hot reference is not warmer than cold reference, cannot calibrate." << std::endl;
+        return false;
+    }
+    const bool has_noise = temporal_noise.size() == cold_mean.size() && temporal_noise.type() == CV_32FC1;
+    const float median_noise = has_noise ? medianOf(temporal_noise) : 0.0f;
+
+    // 1. 坏点：响应偏离中位数过多 (死点/过热点) 或时域噪声过大 (闪烁点)
+    cv::Mat bad_mask = cv::Mat::zeros(cold_mean.size(), CV_8UC1);
+    double cold_sum = 0.0, hot_sum = 0.0;
+    int good_count = 0;
+    for (int y = 0; y < cold_mean.rows; ++y)
+    {
+        const float *r = response.ptr<float>(y);
+        const float *c = cold_mean.ptr<float>(y);
+        const float *h = hot_mean.ptr<float>(y);
+        const float *n = has_noise ? temporal_noise.ptr<float>(y) : nullptr;
+        uchar *b = bad_mask.ptr<uchar>(y);
+        for (int x = 0; x < cold_mean.cols; ++x)
+        {
+            bool bad = std::fabs(r[x] - median_response) > max_response_deviation * median_response;
+            if (has_noise && median_noise > 0.0f && n[x] > max_noise_ratio * median_noise)
+                bad = true;
+            b[x] = bad ? 255 : 0;
+            if (!bad)
+            {
+                cold_sum += c[x];
+                hot_sum += h[x];
+                ++good_count;
+            }
+        }
+    }
+    if (good_count == 0)
+    {
+        std::cerr << "Error: No usable pixels in NUC reference frames." << std::endl;
+        return false;
+    }
+
+    // 2. 两点校正：正常像素对冷/热参考的响应映射到全幅均值
+    const float cold_target = static_cast<float>(cold_sum / good_count);
+    const float hot_target = static_cast<float>(hot_sum / good_count);
+    nuc.gain.create(cold_mean.size(), CV_32FC1);
+    nuc.offset.create(cold_mean.size(), CV_32FC1);
+    std::vector<int> bad_list;
+    int unreplaced = 0;
+    for (int y = 0; y < cold_mean.rows; ++y)
+    {
+        const float *r = response.ptr<float>(y);
+        const float *c = cold_mean.ptr<float>(y);
+        const uchar *b = bad_mask.ptr<uchar>(y);
+        float *g = nuc.gain.ptr<float>(y);
+        float *o = nuc.offset.ptr<float>(y);
+        for (int x = 0; x < cold_mean.cols; ++x)
+        {
+            if (b[x])
+            {
+                g[x] = 1.0f;
+                o[x] = 0.0f;
+                const int replacement = findReplacement(bad_mask, x, y);
+                if (replacement < 0)
+                {
+                    ++unreplaced;
+                    continue;
+                }
+                bad_list.push_back(y * cold_mean.cols + x);
+                bad_list.push_back(replacement);
+                continue;
+            }
+            g[x] = (hot_target - cold_target) / r[x];
+            o[x] = cold_target - g[x] * c[x];
+        }
+    }
+    if (!bad_list.empty())
+        nuc.bad_pixels = cv::Mat(static_cast<int>(bad_list.size() / 2), 2, CV_32SC1, bad_list.data()).clone();
+    if (unreplaced > 0)
+        std::cout << "Warning: " << unreplaced << " bad pixels have no good neighbour within "
+                  << NUC_MAX_REPLACEMENT_RADIUS << " px and are left uncorrected." << std::endl;
+    return true;
+}
@@ -0,0 +1,75 @@
+// src/nuc_correction.h
+#ifndef NUC_CORRECTION_H
+#define NUC_CORRECTION_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 非均匀性校正 (NUC) 与坏点替换 ---
+// 两点校正：corrected = gain * raw + offset，由冷/热两组均匀面源帧标定，
+// 使每个像素对两个参考温度的响应都等于全幅均值。
+// 坏点 (响应异常或时域噪声过大) 用预先选定的最近正常像素替换，替换表为 N x 2 的像素下标对。
+//
+// 非均匀性是探测器逐像元的性质，校正表按探测器原生分辨率、在与运行时相同的输入数据上标定
+// (16 位原始计数，或相机只输出 8 位时的灰度)，校正必须在任何缩放之前进行：
+//   - 输入帧无需缩放时，校正在温度转换中与映射/查表融合为一次遍历 (见 convertGrayToTemperature、RadiometricLut::convert)；
+//   - 需要缩放时，先用 applyNonUniformityCorrection 在原生分辨率上校正，再缩放、转换。
+
+struct NonUniformityCorrection
+{
+    cv::Mat gain;       // CV_32FC1
+    cv::Mat offset;     // CV_32FC1，与输入帧同单位 (原始计数或灰度)
+    cv::Mat bad_pixels; // N x 2, CV_32S：坏点下标 (y * width + x)、替换像素下标，按坏点下标升序
+
+    /**
+     * @brief 校正表与给定尺寸一致时返回 true
+     */
+    bool isValid(const cv::Size &size) const;
+};
+
+/**
+ * @brief 从参数文件读取校正表路径并加载
+ *
+ * @param params_file 参数文件路径 (nuc_calibration_file 项)
+ * @param nuc 输出校正表
+ * @return 配置了校正表且加载成功时返回 true
+ */
+bool loadNonUniformityCorrection(const std::string &params_file, NonUniformityCorrection &nuc);
+
+/**
+ * @brief 读取/保存校正表文件 (gain, offset, bad_pixels)
+ */
+bool readNonUniformityCorrection(const std::string &filename, NonUniformityCorrection &nuc);
+bool writeNonUniformityCorrection(const std::string &filename, const NonUniformityCorrection &nuc);
+
+/**
+ * @brief 在原生分辨率上对整帧做两点校正与坏点替换 (输入帧需要缩放时使用)
+ *
+ * @param frame 原生分辨率输入帧 (CV_8UC1 或 CV_16UC1)，尺寸须与校正表一致
+ * @param nuc 校正表
+ * @param corrected 输出与输入同类型，校正结果饱和截断到该类型的取值范围
+ * @return 尺寸与类型匹配时返回 true；否则 corrected 为输入的拷贝
+ */
+bool applyNonUniformityCorrection(const cv::Mat &frame, const NonUniformityCorrection &nuc, cv::Mat &corrected);
+
+/**
+ * @brief 由冷/热均匀面源的平均帧计算两点校正表
+ *
+ * @param cold_mean 冷面源平均帧 (CV_32FC1，原始计数或灰度)
+ * @param hot_mean 热面源平均帧 (CV_32FC1)
+ * @param temporal_noise 逐像素时域标准差 (CV_32FC1，可为空)
+ * @param max_response_deviation 响应 (热 - 冷) 偏离中位数超过该比例的像素判为坏点
+ * @param max_noise_ratio 时域噪声超过中位数该倍数的像素判为坏点
+ * @param nuc 输出校正表
+ * @return 冷热响应差有效时返回 true
+ */
+bool computeTwoPointCorrection(const cv::Mat &cold_mean,
+                               const cv::Mat &hot_mean,
+                               const cv::Mat &temporal_noise,
+                               float max_response_deviation,
+                               float max_noise_ratio,
+                               NonUniformityCorrection &nuc);
+
+#endif // NUC_CORRECTION_H
@@ -0,0 +1,293 @@
+// src/panorama_scan.cpp
+#include "panorama_scan.h"
+#include "temperature_conversion.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    const float EMPTY_CELL_TEMPERATURE = -273.15f;
+    const float RAD_TO_DEG = static_cast<float>(180.0 / CV_PI);
+}
+
+PanoramaScanner::PanoramaScanner(const cv::Mat &camera_matrix, const cv::Size &image_size, const PanoramaScanConfig &config)
+    : config_(config), frame_counter_(0)
+{
+    double fx = 500.0, fy = 500.0, cx = image_size.width / 2.0, cy = image_size.height / 2.0;
+    if (!camera_matrix.empty() && camera_matrix.at<double>(0, 0) != 0)
+    {
+        fx = camera_matrix.at<double>(0, 0);
+        fy = camera_matrix.at<double>(1, 1);
+        cx = camera_matrix.at<double>(0, 2);
+        cy = camera_matrix.at<double>(1, 2);
+    }
+
+    // 默认分辨率取光轴处单个像素对应的角度，边缘像素角更小，正向投影不会留空洞
+    resolution_ = config_.resolution_degrees > 0.0f ? config_.resolution_degrees
+                                                     : static_cast<float>(std::atan(1.0 / fx) * RAD_TO_DEG);
+
+    mosaic_cols_ = std::max(1, static_cast<int>(std::ceil((config_.azimuth_max_degrees - config_.azimuth_min_degrees) / resolution_)));
+    mosaic_rows_ = std::max(1, static_cast<int>(std::ceil((config_.pitch_max_degrees - config_.pitch_min_degrees) / resolution_)));
+    tiles_x_ = (mosaic_cols_ + PANORAMA_TILE_SIZE - 1) / PANORAMA_TILE_SIZE;
+    tiles_y_ = (mosaic_rows_ + PANORAMA_TILE_SIZE - 1) / PANORAMA_TILE_SIZE;
+    tiles_.resize(static_cast<size_t>(tiles_x_) * tiles_y_);
+
+    // 预计算每像素角度 (栅格单位)，每帧只需加上云台角度
+    column_azimuth_cells_.resize(image_size.width);
+    pixel_pitch_cells_.create(image_size, CV_32FC1);
+    for (int u = 0; u < image_size.width; ++u)
+    {
+        double xn = (u - cx) / fx;
+        column_azimuth_cells_[u] = static_cast<float>(std::atan(xn) * RAD_TO_DEG / resolution_);
+    }
+    for (int v = 0; v < image_size.height; ++v)
+    {
+        double yn = (v - cy) / fy;
+        float *row = pixel_pitch_cells_.ptr<float>(v);
+        for (int u = 0; u < image_size.width; ++u)
+        {
+            double xn = (u - cx) / fx;
+            row[u] = static_cast<float>(std::atan2(yn, std::sqrt(1.0 + xn * xn)) * RAD_TO_DEG / resolution_);
+        }
+    }
+
+    std::cout << "Panorama mosaic: " << mosaic_cols_ << "x" << mosaic_rows_ << " cells @ "
+              << resolution_ << " deg, " << tiles_.size() << " tiles" << std::endl;
+}
+
+PanoramaScanner::Tile &PanoramaScanner::tileAt(int tile_index)
+{
+    std::unique_ptr<Tile> &tile = tiles_[tile_index];
+    if (!tile)
+    {
+        tile.reset(new Tile());
+        tile->max_temperature = cv::Mat(PANORAMA_TILE_SIZE, PANORAMA_TILE_SIZE, CV_32FC1, cv::Scalar(EMPTY_CELL_TEMPERATURE));
+    }
+    return *tile;
+}
+
+void PanoramaScanner::addFrame(const cv::Mat &temp_matrix, float gimbal_azimuth_degrees, float gimbal_pitch_degrees)
+{
+    if (!isTemperatureMatrix(temp_matrix) || temp_matrix.size() != pixel_pitch_cells_.size())
+    {
+        std::cerr << "Error: Panorama frame must be CV_32FC1 or CV_16SC1 with the calibrated image size." << std::endl;
+        return;
+    }
+
+    const int frame_id = frame_counter_++;
+    const float az_base = (gimbal_azimuth_degrees - config_.azimuth_min_degrees) / resolution_;
+    const float pitch_base = (gimbal_pitch_degrees - config_.pitch_min_degrees) / resolution_;
+
+    // 全景图为浮点摄氏度，定点帧逐行展开
+    std::vector<float> row_scratch;
+    for (int v = 0; v < temp_matrix.rows; ++v)
+    {
+        const float *temp_row = temperatureRow(temp_matrix, v, row_scratch);
+        const float *pitch_row = pixel_pitch_cells_.ptr<float>(v);
+        int cached_tile_index = -1;
+        Tile *cached_tile = nullptr;
+
+        for (int u = 0; u < temp_matrix.cols; ++u)
+        {
+            float a = az_base + column_azimuth_cells_[u];
+            float p = pitch_base + pitch_row[u];
+            if (a < 0.0f || p < 0.0f)
+                continue;
+            int mx = static_cast<int>(a);
+            int my = static_cast<int>(p);
+            if (mx >= mosaic_cols_ || my >= mosaic_rows_)
+                continue;
+
+            // 同一行相邻像素大多落在同一块，缓存块指针
+            int tile_index = (my / PANORAMA_TILE_SIZE) * tiles_x_ + (mx / PANORAMA_TILE_SIZE);
+            if (tile_index != cached_tile_index)
+            {
+                cached_tile_index = tile_index;
+                cached_tile = &tileAt(tile_index);
+                if (cached_tile->last_touched_frame != frame_id)
+                {
+                    cached_tile->last_touched_frame = frame_id;
+                    if (cached_tile->state == TileState::Complete)
+                    {
+                        // 往返扫描再次覆盖已完成的块：作废旧结果，等离开后重新检测
+                        cached_tile->state = TileState::Filling;
+                        cached_tile->regions.clear();
+                    }
+                }
+            }
+            float &cell = cached_tile->max_temperature.at<float>(my % PANORAMA_TILE_SIZE, mx % PANORAMA_TILE_SIZE);
+            cell = std::max(cell, temp_row[u]);
+        }
+    }
+
+    // 本帧之前被覆盖、本帧不再覆盖的块已完成
+    for (size_t i = 0; i < tiles_.size(); ++i)
+    {
+        Tile *tile = tiles_[i].get();
+        if (tile && tile->state == TileState::Filling && tile->last_touched_frame != frame_id)
+            detectInTile(static_cast<int>(i));
+    }
+}
+
+void PanoramaScanner::finishSweep()
+{
+    for (size_t i = 0; i < tiles_.size(); ++i)
+    {
+        if (tiles_[i] && tiles_[i]->state == TileState::Filling)
+            detectInTile(static_cast<int>(i));
+    }
+}
+
+void PanoramaScanner::detectInTile(int tile_index)
+{
+    Tile &tile = *tiles_[tile_index];
+    tile.state = TileState::Complete;
+    tile.regions.clear();
+
+    cv::Mat binary_mask;
+    cv::threshold(tile.max_temperature, binary_mask, FIRE_TEMPERATURE_THRESHOLD_CELSIUS, 255.0, cv::THRESH_BINARY);
+    binary_mask.convertTo(binary_mask, CV_8U);
+    if (cv::countNonZero(binary_mask) == 0)
+        return;
+
+    cv::Mat labels, stats, centroids;
+    int n = cv::connectedComponentsWithStats(binary_mask, labels, stats, centroids, 8, CV_32S);
+    if (n <= 1)
+        return;
+
+    std::vector<float> max_temps(n, EMPTY_CELL_TEMPERATURE);
+    for (int y = 0; y < labels.rows; ++y)
+    {
+        const int *label_row = labels.ptr<int>(y);
+        const float *temp_row = tile.max_temperature.ptr<float>(y);
+        for (int x = 0; x < labels.cols; ++x)
+        {
+            if (label_row[x] > 0)
+                max_temps[label_row[x]] = std::max(max_temps[label_row[x]], temp_row[x]);
+        }
+    }
+
+    const int origin_x = (tile_index % tiles_x_) * PANORAMA_TILE_SIZE;
+    const int origin_y = (tile_index / tiles_x_) * PANORAMA_TILE_SIZE;
+    for (int label = 1; label < n; ++label)
+    {
+        PanoramaHotRegion region;
+        region.area_cells = stats.at<int>(label, cv::CC_STAT_AREA);
+        region.max_temperature = max_temps[label];
+        region.cell_bbox = cv::Rect(origin_x + stats.at<int>(label, cv::CC_STAT_LEFT),
+                                    origin_y + stats.at<int>(label, cv::CC_STAT_TOP),
+                                    stats.at<int>(label, cv::CC_STAT_WIDTH),
+                                    stats.at<int>(label, cv::CC_STAT_HEIGHT));
+        region.azimuth_degrees = config_.azimuth_min_degrees + (origin_x + static_cast<float>(centroids.at<double>(label, 0)) + 0.5f) * resolution_;
+        region.pitch_degrees = config_.pitch_min_degrees + (origin_y + static_cast<float>(centroids.at<double>(label, 1)) + 0.5f) * resolution_;
+        tile.regions.push_back(region);
+    }
+}
+
+std::vector<PanoramaHotRegion> PanoramaScanner::hotRegions() const
+{
+    std::vector<PanoramaHotRegion> regions;
+    for (const auto &tile : tiles_)
+    {
+        if (tile && tile->state == TileState::Complete)
+            regions.insert(regions.end(), tile->regions.begin(), tile->regions.end());
+    }
+
+    // 合并跨越块边界的区域：外接矩形扩展 1 格后相交即视为同一区域
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < regions.size() && !merged; ++i)
+        {
+            cv::Rect grown(regions[i].cell_bbox.x - 1, regions[i].cell_bbox.y - 1,
+                           regions[i].cell_bbox.width + 2, regions[i].cell_bbox.height + 2);
+            for (size_t j = i + 1; j < regions.size(); ++j)
+            {
+                if ((grown & regions[j].cell_bbox).area() == 0)
+                    continue;
+                PanoramaHotRegion &a = regions[i];
+                const PanoramaHotRegion &b = regions[j];
+                float total = static_cast<float>(a.area_cells + b.area_cells);
+                a.azimuth_degrees = (a.azimuth_degrees * a.area_cells + b.azimuth_degrees * b.area_cells) / total;
+                a.pitch_degrees = (a.pitch_degrees * a.area_cells + b.pitch_degrees * b.area_cells) / total;
+                a.area_cells += b.area_cells;
+                a.max_temperature = std::max(a.max_temperature, b.max_temperature);
+                a.cell_bbox |= b.cell_bbox;
+                regions.erase(regions.begin() + j);
+                merged = true;
+                break;
+            }
+        }
+    }
+
+    // 与单帧检测一致的最小面积过滤 (栅格分辨率约等于光轴处像素角)
+    regions.erase(std::remove_if(regions.begin(), regions.end(),
+                                 [](const PanoramaHotRegion &r)
+                                 { return r.area_cells < MIN_HOTSPOT_AREA_PIXELS; }),
+                  regions.end());
+    std::sort(regions.begin(), regions.end(),
+              [](const PanoramaHotRegion &a, const PanoramaHotRegion &b)
+              { return a.max_temperature > b.max_temperature; });
+    return regions;
+}
+
+void PanoramaScanner::renderMosaic(cv::Mat &display_image) const
+{
+    cv::Mat mosaic(tiles_y_ * PANORAMA_TILE_SIZE, tiles_x_ * PANORAMA_TILE_SIZE, CV_32FC1, cv::Scalar(EMPTY_CELL_TEMPERATURE));
+    cv::Mat covered = cv::Mat::zeros(mosaic.size(), CV_8U);
+    for (size_t i = 0; i < tiles_.size(); ++i)
+    {
+        if (!tiles_[i])
+            continue;
+        cv::Rect roi(static_cast<int>(i % tiles_x_) * PANORAMA_TILE_SIZE, static_cast<int>(i / tiles_x_) * PANORAMA_TILE_SIZE,
+                     PANORAMA_TILE_SIZE, PANORAMA_TILE_SIZE);
+        tiles_[i]->max_temperature.copyTo(mosaic(roi));
+    }
+    cv::compare(mosaic, EMPTY_CELL_TEMPERATURE, covered, cv::CMP_GT);
+
+    cv::Mat normalized;
+    cv::normalize(mosaic, normalized, 0, 255, cv::NORM_MINMAX, CV_8UC1, covered);
+    cv::applyColorMap(normalized, display_image, cv::COLORMAP_JET);
+    display_image.setTo(cv::Scalar(0, 0, 0), ~covered);
+    display_image = display_image(cv::Rect(0, 0, mosaic_cols_, mosaic_rows_)).clone();
+
+    for (const auto &region : hotRegions())
+        cv::rectangle(display_image, region.cell_bbox, cv::Scalar(255, 255, 255), 1);
+}
+
+void PanoramaScanner::reset()
+{
+    for (auto &tile : tiles_)
+        tile.reset();
+    frame_counter_ = 0;
+}
+
+bool loadPanoramaScanConfig(const std::string &filename, PanoramaScanConfig &config)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["scan_enabled"].isInt())
+        config.enabled = static_cast<int>(fs["scan_enabled"]) != 0;
+    if (fs["scan_azimuth_min_degrees"].isReal())
+        fs["scan_azimuth_min_degrees"] >> config.azimuth_min_degrees;
+    if (fs["scan_azimuth_max_degrees"].isReal())
+        fs["scan_azimuth_max_degrees"] >> config.azimuth_max_degrees;
+    if (fs["scan_pitch_min_degrees"].isReal())
+        fs["scan_pitch_min_degrees"] >> config.pitch_min_degrees;
+    if (fs["scan_pitch_max_degrees"].isReal())
+        fs["scan_pitch_max_degrees"] >> config.pitch_max_degrees;
+    if (fs["scan_resolution_degrees"].isReal())
+        fs["scan_resolution_degrees"] >> config.resolution_degrees;
+    if (fs["scan_sequence"].isString())
+        fs["scan_sequence"] >> config.sequence_directory;
+    fs.release();
+    return true;
+}
@@ -0,0 +1,114 @@
+// src/panorama_scan.h
+#ifndef PANORAMA_SCAN_H
+#define PANORAMA_SCAN_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// --- 全景扫描模式 ---
+// 云台扫描过程中，将每帧温度矩阵按 (回转角, 俯仰角) 拼接成热成像全景图。
+// 全景图按 PANORAMA_TILE_SIZE 分块，取最高温度融合；当扫描离开某个块后立即在该块上做热点检测，
+// 最终得到以云台绝对角度表示的全部高温区域，无需对每个云台姿态做整帧检测。
+//
+// 像素 -> 角度：回转角 = atan(x')，俯仰角 = atan(y' / sqrt(1 + x'^2))，x',y' 为归一化像素坐标；
+// 与云台编码器角度相加得到绝对角度 (小俯仰角近似，与 calculateGimbalAngles 的约定一致)。
+
+const int PANORAMA_TILE_SIZE = 64;
+
+// 全景图中的一个高温区域 (绝对云台角度)
+struct PanoramaHotRegion
+{
+    float azimuth_degrees;
+    float pitch_degrees;
+    float max_temperature;
+    int area_cells;
+    cv::Rect cell_bbox; // 全景图栅格坐标下的外接矩形
+
+    PanoramaHotRegion() : azimuth_degrees(0.0f), pitch_degrees(0.0f), max_temperature(0.0f), area_cells(0) {}
+};
+
+// 扫描范围配置
+struct PanoramaScanConfig
+{
+    bool enabled = false;
+    float azimuth_min_degrees = -90.0f;
+    float azimuth_max_degrees = 90.0f;
+    float pitch_min_degrees = -10.0f;
+    float pitch_max_degrees = 30.0f;
+    float resolution_degrees = 0.0f;  // 全景图栅格角分辨率，<=0 表示按图像中心像素角自动选取
+    std::string sequence_directory;   // 录制的扫描序列 (sequence.yml 中带每帧云台编码器角度)，回放时按编码器角度拼接
+};
+
+class PanoramaScanner
+{
+public:
+    PanoramaScanner(const cv::Mat &camera_matrix, const cv::Size &image_size, const PanoramaScanConfig &config);
+
+    /**
+     * @brief 将一帧拼接到全景图
+     *
+     * @param temp_matrix 温度矩阵 (CV_32FC1，或 CV_16SC1 的 0.1 °C 定点)
+     * @param gimbal_azimuth_degrees 拍摄时云台编码器回转角
+     * @param gimbal_pitch_degrees 拍摄时云台编码器俯仰角
+     *
+     * 被本帧覆盖过、而本帧不再覆盖的块视为完成，立即在块内检测高温区域。
+     */
+    void addFrame(const cv::Mat &temp_matrix, float gimbal_azimuth_degrees, float gimbal_pitch_degrees);
+
+    // 扫描结束，对剩余未完成的块做检测
+    void finishSweep();
+
+    // 跨块合并后的高温区域，按最高温度降序
+    std::vector<PanoramaHotRegion> hotRegions() const;
+
+    // 渲染全景图 (伪彩色，未覆盖区域为黑色)
+    void renderMosaic(cv::Mat &display_image) const;
+
+    void reset();
+
+private:
+    enum class TileState
+    {
+        Filling,
+        Complete
+    };
+
+    struct Tile
+    {
+        cv::Mat max_temperature; // PANORAMA_TILE_SIZE^2, CV_32FC1
+        TileState state = TileState::Filling;
+        int last_touched_frame = -1;
+        std::vector<PanoramaHotRegion> regions;
+    };
+
+    void detectInTile(int tile_index);
+    Tile &tileAt(int tile_index);
+
+    PanoramaScanConfig config_;
+    float resolution_;
+    int mosaic_cols_;
+    int mosaic_rows_;
+    int tiles_x_;
+    int tiles_y_;
+    std::vector<std::unique_ptr<Tile>> tiles_;
+    int frame_counter_;
+
+    // 每像素相对光轴的角度偏移，已换算为全景图栅格单位
+    std::vector<float> column_azimuth_cells_; // 每列
+    cv::Mat pixel_pitch_cells_;              // 每像素, CV_32FC1
+};
+
+/**
+ * @brief 从参数文件加载扫描配置
+ *
+ * @param filename 参数文件路径
+ * @param config 输出的扫描配置；缺失的字段保留默认值
+ * @return 成功打开文件返回 true
+ */
+bool loadPanoramaScanConfig(const std::string &filename, PanoramaScanConfig &config);
+
+#endif // PANORAMA_SCAN_H
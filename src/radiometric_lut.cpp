@@ -0,0 +1,122 @@
+// src/radiometric_lut.cpp
+#include "radiometric_lut.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+bool loadPlanckCalibration(const std::string &filename, PlanckCalibration &calibration)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["radiometric_raw_input"].isInt())
+        calibration.enabled = static_cast<int>(fs["radiometric_raw_input"]) != 0;
+    else
+        std::cout << "Warning: radiometric_raw_input not found in " << filename << std::endl;
+    if (fs["planck_R"].isReal())
+        fs["planck_R"] >> calibration.R;
+    if (fs["planck_B"].isReal())
+        fs["planck_B"] >> calibration.B;
+    if (fs["planck_F"].isReal())
+        fs["planck_F"] >> calibration.F;
+    if (fs["planck_O"].isReal())
+        fs["planck_O"] >> calibration.O;
+    if (fs["object_emissivity"].isReal())
+        fs["object_emissivity"] >> calibration.emissivity;
+    if (fs["reflected_temperature_celsius"].isReal())
+        fs["reflected_temperature_celsius"] >> calibration.reflected_temperature_celsius;
+    fs.release();
+    return true;
+}
+
+void RadiometricLut::build(const PlanckCalibration &calibration)
+{
+    const double emissivity = std::min(std::max(calibration.emissivity, 0.01), 1.0);
+    const double reflected_kelvin = calibration.reflected_temperature_celsius + 273.15;
+    const double raw_reflected = calibration.R / (std::exp(calibration.B / reflected_kelvin) - calibration.F) + calibration.O;
+
+    lut_.resize(RADIOMETRIC_LUT_SIZE);
+    float running_max = RADIOMETRIC_MIN_CELSIUS;
+    for (int raw = 0; raw < RADIOMETRIC_LUT_SIZE; ++raw)
+    {
+        const double raw_object = (raw - (1.0 - emissivity) * raw_reflected) / emissivity;
+        float celsius = RADIOMETRIC_MIN_CELSIUS;
+        const double denom = raw_object - calibration.O;
+        if (denom > 0.0)
+        {
+            const double arg = calibration.R / denom + calibration.F;
+            if (arg > 1.0)
+                celsius = static_cast<float>(calibration.B / std::log(arg) - 273.15);
+        }
+        // 修正为单调不减：截断段与有效段衔接处不出现回落
+        running_max = std::max(running_max, celsius);
+        lut_[raw] = running_max;
+    }
+    std::cout << "Radiometric LUT: raw 0 -> " << lut_.front() << " C, raw 65535 -> " << lut_.back() << " C" << std::endl;
+}
+
+void RadiometricLut::convert(const cv::Mat &raw, cv::Mat &temp_matrix, RegionStatistics *region_stats,
+                             const NonUniformityCorrection *nuc, int output_type, TemporalDenoiseFilter *denoiser) const
+{
+    if (raw.empty() || raw.type() != CV_16UC1 || !isReady() || (output_type != CV_32FC1 && output_type != CV_16SC1))
+    {
+        std::cerr << "Error: Radiometric conversion needs a CV_16UC1 frame, a built LUT and a CV_32FC1/CV_16SC1 output." << std::endl;
+        temp_matrix.release();
+        return;
+    }
+
+    const bool compact = output_type == CV_16SC1;
+    const float *lut = lut_.data();
+    const bool has_nuc = nuc && nuc->isValid(raw.size());
+    if (nuc && !has_nuc)
+        std::cout << "Warning: NUC calibration size does not match frame size, NUC skipped." << std::endl;
+    const int bad_count = has_nuc ? nuc->bad_pixels.rows : 0;
+    int next_bad = 0;
+    std::vector<float> row_buffer(compact ? raw.cols : 0);
+    temp_matrix.create(raw.size(), output_type);
+    if (region_stats)
+        region_stats->begin(raw.size());
+    if (denoiser)
+        denoiser->begin(raw.size());
+    for (int y = 0; y < raw.rows; ++y)
+    {
+        const ushort *r = raw.ptr<ushort>(y);
+        float *t = compact ? row_buffer.data() : temp_matrix.ptr<float>(y);
+        if (has_nuc)
+        {
+            const float *g = nuc->gain.ptr<float>(y);
+            const float *o = nuc->offset.ptr<float>(y);
+            for (int x = 0; x < raw.cols; ++x)
+                t[x] = lut[cv::saturate_cast<ushort>(g[x] * r[x] + o[x])];
+            // 坏点：用替换像素的原始计数按其自身校正系数计算，不依赖替换像素所在行是否已转换
+            const int row_end = (y + 1) * raw.cols;
+            for (; next_bad < bad_count && nuc->bad_pixels.at<int>(next_bad, 0) < row_end; ++next_bad)
+            {
+                const int bad = nuc->bad_pixels.at<int>(next_bad, 0);
+                const int src = nuc->bad_pixels.at<int>(next_bad, 1);
+                if (bad < y * raw.cols || src < 0 || src >= static_cast<int>(raw.total()))
+                    continue;
+                const int sy = src / raw.cols, sx = src % raw.cols;
+                const float corrected = nuc->gain.at<float>(sy, sx) * raw.at<ushort>(sy, sx) + nuc->offset.at<float>(sy, sx);
+                t[bad - y * raw.cols] = lut[cv::saturate_cast<ushort>(corrected)];
+            }
+        }
+        else
+        {
+            for (int x = 0; x < raw.cols; ++x)
+                t[x] = lut[r[x]];
+        }
+        if (denoiser)
+            denoiser->filterRow(y, t);
+        if (compact)
+            compactTemperatureRow(t, temp_matrix.ptr<short>(y), raw.cols);
+        if (region_stats)
+            region_stats->accumulateRow(y, t);
+    }
+    if (region_stats)
+        region_stats->finish();
+}
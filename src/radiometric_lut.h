@@ -0,0 +1,71 @@
+// src/radiometric_lut.h
+#ifndef RADIOMETRIC_LUT_H
+#define RADIOMETRIC_LUT_H
+
+#include "temperature_conversion.h"
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+// --- 16 位原始数据的辐射定标 ---
+// 8 位灰度线性映射到 0~550 °C 时量化约 2 °C，且与辐射关系不符。
+// 16 位原始计数按 Planck 曲线标定 (常数 R, B, F, O 由相机厂商给出)：
+//   raw_refl = R / (exp(B / T_refl) - F) + O
+//   raw_obj  = (raw - (1 - ε) * raw_refl) / ε
+//   T        = B / ln(R / (raw_obj - O) + F)          (热力学温度，K)
+// 启动时对全部 65536 个计数值预先计算，逐像素转换只剩一次查表。
+// 表被修正为单调不减 (曲线无定义的低计数段截断到 RADIOMETRIC_MIN_CELSIUS)。
+
+const int RADIOMETRIC_LUT_SIZE = 65536;
+const float RADIOMETRIC_MIN_CELSIUS = -40.0f; // 曲线无定义的低计数值截断到该温度
+
+struct PlanckCalibration
+{
+    bool enabled = false;  // 输入为 16 位原始数据时启用
+    double R = 250000.0;   // 示例值 (约覆盖 -20~550 °C)，须替换为相机标定值
+    double B = 1396.5;
+    double F = 1.0;
+    double O = 1000.0;
+    double emissivity = 0.95;
+    double reflected_temperature_celsius = 20.0;
+};
+
+/**
+ * @brief 从参数文件读取 Planck 定标常数
+ *
+ * @param filename 参数文件路径 (radiometric_raw_input, planck_R/B/F/O, object_emissivity, reflected_temperature_celsius)
+ * @param calibration 输出定标常数，缺失项保持默认值
+ * @return 文件打开成功返回 true
+ */
+bool loadPlanckCalibration(const std::string &filename, PlanckCalibration &calibration);
+
+class RadiometricLut
+{
+public:
+    /**
+     * @brief 按定标常数生成 65536 项查找表
+     */
+    void build(const PlanckCalibration &calibration);
+
+    bool isReady() const { return !lut_.empty(); }
+    float temperature(ushort raw) const { return lut_[raw]; }
+
+    /**
+     * @brief 16 位原始帧逐像素查表转换为温度矩阵
+     *
+     * @param raw 原始帧 (CV_16UC1)
+     * @param temp_matrix 输出温度矩阵 (output_type)
+     * @param region_stats 非空时在同一遍中生成区域统计表
+     * @param nuc 非空且尺寸匹配时，查表前先对原始计数做两点校正 (截断到 [0,65535]) 并替换坏点
+     * @param output_type CV_32FC1，或 CV_16SC1 (0.1 °C 定点)
+     * @param denoiser 非空时查表后原地做时域降噪
+     */
+    void convert(const cv::Mat &raw, cv::Mat &temp_matrix, RegionStatistics *region_stats = nullptr,
+                 const NonUniformityCorrection *nuc = nullptr, int output_type = CV_32FC1,
+                 TemporalDenoiseFilter *denoiser = nullptr) const;
+
+private:
+    std::vector<float> lut_;
+};
+
+#endif // RADIOMETRIC_LUT_H
@@ -0,0 +1,338 @@
+// src/range_estimation.cpp
+#include "range_estimation.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+// ---------------- RangeProvider ----------------
+
+void RangeProvider::depthMap(const cv::Size &size, cv::Mat &depth) const
+{
+    depth.create(size, CV_32FC1);
+    for (int y = 0; y < size.height; ++y)
+    {
+        float *d = depth.ptr<float>(y);
+        for (int x = 0; x < size.width; ++x)
+            d[x] = depthAt(cv::Point2f(static_cast<float>(x), static_cast<float>(y)));
+    }
+}
+
+// ---------------- FixedRangeProvider ----------------
+
+FixedRangeProvider::FixedRangeProvider(float depth_meters)
+    : depth_meters_(depth_meters)
+{
+}
+
+float FixedRangeProvider::depthAt(const cv::Point2f &) const
+{
+    return depth_meters_;
+}
+
+// ---------------- GroundPlaneRangeProvider ----------------
+
+GroundPlaneRangeProvider::GroundPlaneRangeProvider(const cv::Mat &camera_matrix,
+                                                   int image_height,
+                                                   float camera_height_meters,
+                                                   float camera_tilt_degrees,
+                                                   float max_range_meters)
+    : fy_(0.0),
+      cy_(0.0),
+      camera_height_meters_(camera_height_meters),
+      mount_tilt_degrees_(camera_tilt_degrees),
+      max_range_meters_(max_range_meters),
+      valid_(false),
+      table_pitch_degrees_(0.0f)
+{
+    depth_per_row_.assign(std::max(image_height, 1), max_range_meters);
+    if (camera_matrix.empty() || camera_matrix.at<double>(1, 1) == 0 || camera_height_meters <= 0.0f)
+    {
+        std::cerr << "Warning: Invalid ground plane parameters, using max range for all rows." << std::endl;
+        return;
+    }
+
+    fy_ = camera_matrix.at<double>(1, 1);
+    cy_ = camera_matrix.at<double>(1, 2);
+    valid_ = true;
+    buildRowTable(mount_tilt_degrees_);
+}
+
+void GroundPlaneRangeProvider::buildRowTable(float tilt_degrees)
+{
+    double tilt = tilt_degrees * CV_PI / 180.0;
+    double cos_t = std::cos(tilt);
+    double sin_t = std::sin(tilt);
+
+    // 相机坐标系 Y 向下、Z 向前，相机下俯 tilt。
+    // 深度为 Z 的射线点 P = Z * (x', r, 1)，其在竖直向下方向上的分量为 Z * (r*cos + sin)，
+    // 令其等于相机高度即可解出 Z = h / (r*cos + sin)，与列号无关。
+    for (size_t v = 0; v < depth_per_row_.size(); ++v)
+    {
+        double r = (static_cast<double>(v) - cy_) / fy_;
+        double denom = r * cos_t + sin_t;
+        if (denom <= 1e-6)
+        {
+            depth_per_row_[v] = max_range_meters_; // 地平线以上
+            continue;
+        }
+        double depth = camera_height_meters_ / denom;
+        depth_per_row_[v] = static_cast<float>(std::min(depth, static_cast<double>(max_range_meters_)));
+    }
+}
+
+bool GroundPlaneRangeProvider::beginFrame(float gimbal_pitch_degrees)
+{
+    if (!valid_ || std::fabs(gimbal_pitch_degrees - table_pitch_degrees_) < GROUND_PLANE_PITCH_TOLERANCE_DEGREES)
+        return false;
+    table_pitch_degrees_ = gimbal_pitch_degrees;
+    buildRowTable(mount_tilt_degrees_ + gimbal_pitch_degrees);
+    return true;
+}
+
+float GroundPlaneRangeProvider::depthAt(const cv::Point2f &pixel) const
+{
+    int row = static_cast<int>(pixel.y + 0.5f);
+    row = std::max(0, std::min(row, static_cast<int>(depth_per_row_.size()) - 1));
+    return depth_per_row_[row];
+}
+
+void GroundPlaneRangeProvider::depthMap(const cv::Size &size, cv::Mat &depth) const
+{
+    depth.create(size, CV_32FC1);
+    for (int y = 0; y < size.height; ++y)
+        depth.row(y).setTo(cv::Scalar(depth_per_row_[std::min(y, static_cast<int>(depth_per_row_.size()) - 1)]));
+}
+
+// ---------------- RangefinderRangeProvider ----------------
+
+RangefinderRangeProvider::RangefinderRangeProvider(const std::string &source,
+                                                   std::unique_ptr<RangeProvider> fallback,
+                                                   int stale_frame_limit)
+    : fallback_(std::move(fallback)),
+      stale_frame_limit_(stale_frame_limit),
+      frames_since_reading_(stale_frame_limit + 1),
+      latest_depth_meters_(0.0f),
+      socket_fd_(-1),
+      replay_index_(0)
+{
+    if (!fallback_)
+        fallback_.reset(new FixedRangeProvider());
+
+    if (source.compare(0, 4, "udp:") == 0)
+    {
+        int port = std::atoi(source.c_str() + 4);
+        if (!openSocket(port))
+            std::cerr << "Warning: Could not open rangefinder UDP port " << port << ", using fallback." << std::endl;
+        return;
+    }
+
+    std::ifstream replay(source);
+    if (!replay.is_open())
+    {
+        std::cerr << "Warning: Could not open rangefinder replay file: " << source << ", using fallback." << std::endl;
+        return;
+    }
+    std::string line;
+    while (std::getline(replay, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        std::istringstream iss(line);
+        double timestamp = 0.0;
+        float depth = 0.0f;
+        if (iss >> timestamp >> depth)
+            replay_depths_.push_back(depth);
+    }
+    std::cout << "Rangefinder replay loaded: " << replay_depths_.size() << " readings from " << source << std::endl;
+}
+
+RangefinderRangeProvider::~RangefinderRangeProvider()
+{
+    if (socket_fd_ < 0)
+        return;
+#ifdef _WIN32
+    closesocket(static_cast<SOCKET>(socket_fd_));
+    WSACleanup();
+#else
+    close(static_cast<int>(socket_fd_));
+#endif
+}
+
+bool RangefinderRangeProvider::openSocket(int port)
+{
+    if (port <= 0 || port > 65535)
+        return false;
+
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0)
+        return false;
+    SOCKET fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd == INVALID_SOCKET)
+    {
+        WSACleanup();
+        return false;
+    }
+    u_long non_blocking = 1;
+    ioctlsocket(fd, FIONBIO, &non_blocking);
+#else
+    int fd = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd < 0)
+        return false;
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<unsigned short>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0)
+    {
+#ifdef _WIN32
+        closesocket(fd);
+        WSACleanup();
+#else
+        close(fd);
+#endif
+        return false;
+    }
+
+    socket_fd_ = static_cast<long long>(fd);
+    std::cout << "Rangefinder listening on udp://127.0.0.1:" << port << std::endl;
+    return true;
+}
+
+void RangefinderRangeProvider::pollSocket()
+{
+    // 一次性取空接收队列，只保留最新读数
+    char buffer[64];
+    while (true)
+    {
+#ifdef _WIN32
+        int n = recv(static_cast<SOCKET>(socket_fd_), buffer, sizeof(buffer) - 1, 0);
+#else
+        long n = recv(static_cast<int>(socket_fd_), buffer, sizeof(buffer) - 1, 0);
+#endif
+        if (n <= 0)
+            break;
+        buffer[n] = '\0';
+        float depth = std::strtof(buffer, nullptr);
+        if (depth > 0.0f)
+        {
+            latest_depth_meters_ = depth;
+            frames_since_reading_ = 0;
+        }
+    }
+}
+
+void RangefinderRangeProvider::advanceReplay()
+{
+    if (replay_index_ >= replay_depths_.size())
+        return;
+    float depth = replay_depths_[replay_index_++];
+    if (depth > 0.0f)
+    {
+        latest_depth_meters_ = depth;
+        frames_since_reading_ = 0;
+    }
+}
+
+bool RangefinderRangeProvider::beginFrame(float gimbal_pitch_degrees)
+{
+    if (frames_since_reading_ <= stale_frame_limit_)
+        ++frames_since_reading_;
+
+    if (socket_fd_ >= 0)
+        pollSocket();
+    else
+        advanceReplay();
+
+    return fallback_->beginFrame(gimbal_pitch_degrees);
+}
+
+float RangefinderRangeProvider::depthAt(const cv::Point2f &pixel) const
+{
+    if (hasValidReading())
+        return latest_depth_meters_;
+    return fallback_->depthAt(pixel);
+}
+
+void RangefinderRangeProvider::depthMap(const cv::Size &size, cv::Mat &depth) const
+{
+    fallback_->depthMap(size, depth);
+}
+
+// ---------------- 工厂函数 ----------------
+
+std::unique_ptr<RangeProvider> createRangeProvider(const std::string &filename,
+                                                   const cv::Mat &camera_matrix,
+                                                   const cv::Size &image_size)
+{
+    std::string model = "fixed";
+    float fixed_range = ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS;
+    float camera_height = 0.0f;
+    float camera_tilt = 0.0f;
+    float max_range = 30.0f;
+    std::string rangefinder_source;
+
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (fs.isOpened())
+    {
+        if (fs["range_model"].isString())
+            fs["range_model"] >> model;
+        if (fs["fixed_range_meters"].isReal())
+            fs["fixed_range_meters"] >> fixed_range;
+        if (fs["camera_height_meters"].isReal())
+            fs["camera_height_meters"] >> camera_height;
+        if (fs["camera_tilt_degrees"].isReal())
+            fs["camera_tilt_degrees"] >> camera_tilt;
+        if (fs["max_range_meters"].isReal())
+            fs["max_range_meters"] >> max_range;
+        if (fs["rangefinder_source"].isString())
+            fs["rangefinder_source"] >> rangefinder_source;
+        fs.release();
+    }
+    else
+    {
+        std::cerr << "Warning: Could not open " << filename << ", using fixed range model." << std::endl;
+    }
+
+    std::unique_ptr<RangeProvider> provider;
+    if (model == "ground_plane")
+    {
+        provider.reset(new GroundPlaneRangeProvider(camera_matrix, image_size.height, camera_height, camera_tilt, max_range));
+    }
+    else if (model == "rangefinder" && !rangefinder_source.empty())
+    {
+        // 测距仪失效时优先回退到地平面模型
+        std::unique_ptr<RangeProvider> fallback;
+        if (camera_height > 0.0f)
+            fallback.reset(new GroundPlaneRangeProvider(camera_matrix, image_size.height, camera_height, camera_tilt, max_range));
+        else
+            fallback.reset(new FixedRangeProvider(fixed_range));
+        provider.reset(new RangefinderRangeProvider(rangefinder_source, std::move(fallback)));
+    }
+    else
+    {
+        if (model != "fixed")
+            std::cout << "Warning: Unknown or incomplete range_model '" << model << "', using fixed range." << std::endl;
+        provider.reset(new FixedRangeProvider(fixed_range));
+    }
+
+    std::cout << "Using range model: " << provider->name() << std::endl;
+    return provider;
+}
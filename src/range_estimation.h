@@ -0,0 +1,140 @@
+// src/range_estimation.h
+#ifndef RANGE_ESTIMATION_H
+#define RANGE_ESTIMATION_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// --- 距离估计 ---
+// 取代固定的 ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS，为每个热点单独给出深度。
+// 所有实现返回的都是相机坐标系下沿光轴方向的深度 Z (米)，与 pixelToApproxWorld 的输入一致。
+
+/**
+ * @brief 距离估计接口
+ *
+ * beginFrame() 每帧调用一次，传入云台当前俯仰角并刷新外部数据(如测距仪读数)，
+ * 返回 true 表示 depthMap() 的结果自上一帧起已变化，依赖它的逐像素参数 (如阈值图) 需要重建；
+ * depthAt() 在检测过程中按热点调用，实现必须是 O(1) 的查表/常数运算。
+ * depthMap() 生成整帧的深度图 (CV_32FC1)，用于预计算逐像素参数，只在其变化时调用。
+ */
+class RangeProvider
+{
+public:
+    virtual ~RangeProvider() = default;
+
+    virtual bool beginFrame(float /*gimbal_pitch_degrees*/) { return false; }
+    virtual float depthAt(const cv::Point2f &pixel) const = 0;
+    virtual void depthMap(const cv::Size &size, cv::Mat &depth) const;
+    virtual const char *name() const = 0;
+};
+
+/**
+ * @brief 固定距离模型 (原有的强假设，作为最终回退)
+ */
+class FixedRangeProvider : public RangeProvider
+{
+public:
+    explicit FixedRangeProvider(float depth_meters = ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS);
+
+    float depthAt(const cv::Point2f &pixel) const override;
+    const char *name() const override { return "fixed"; }
+
+private:
+    float depth_meters_;
+};
+
+/**
+ * @brief 地平面模型
+ *
+ * 已知相机离地高度和下俯角时，像素射线与地面的交点深度只取决于像素行号，
+ * 因此按行预计算查找表。实际下俯角 = 安装下俯角 + 云台俯仰角 (向下为正)，
+ * 查找表只在云台俯仰角变化超过 GROUND_PLANE_PITCH_TOLERANCE_DEGREES 时重建，云台静止时每帧无额外开销。
+ * 射线在地平线以上(不与地面相交)或超过最大距离时，截断到 max_range_meters。
+ */
+class GroundPlaneRangeProvider : public RangeProvider
+{
+public:
+    GroundPlaneRangeProvider(const cv::Mat &camera_matrix,
+                             int image_height,
+                             float camera_height_meters,
+                             float camera_tilt_degrees,
+                             float max_range_meters);
+
+    bool beginFrame(float gimbal_pitch_degrees) override;
+    float depthAt(const cv::Point2f &pixel) const override;
+    void depthMap(const cv::Size &size, cv::Mat &depth) const override;
+    const char *name() const override { return "ground_plane"; }
+
+private:
+    void buildRowTable(float tilt_degrees);
+
+    double fy_;
+    double cy_;
+    float camera_height_meters_;
+    float mount_tilt_degrees_;
+    float max_range_meters_;
+    bool valid_;
+    float table_pitch_degrees_; // 当前查找表对应的云台俯仰角
+    std::vector<float> depth_per_row_;
+};
+
+/**
+ * @brief 激光测距仪替身
+ *
+ * 测距仪与相机同轴安装，读数即为视场中心的深度，整帧按该深度处理。
+ * 数据来源：
+ *   - "udp:<端口>"：监听本机 UDP 端口，每个报文为一个 ASCII 浮点数 (米)
+ *   - 其他字符串：回放文件路径，每行 "<时间戳> <距离>"，每帧消费一行
+ * 连续 stale_frame_limit 帧没有新读数时，回退到 fallback 模型。
+ * 测距读数每帧变化，depthMap() 给出的是 fallback 模型的深度图，云台俯仰角转发给 fallback 模型。
+ */
+class RangefinderRangeProvider : public RangeProvider
+{
+public:
+    RangefinderRangeProvider(const std::string &source,
+                             std::unique_ptr<RangeProvider> fallback,
+                             int stale_frame_limit = 10);
+    ~RangefinderRangeProvider() override;
+
+    bool beginFrame(float gimbal_pitch_degrees) override;
+    float depthAt(const cv::Point2f &pixel) const override;
+    void depthMap(const cv::Size &size, cv::Mat &depth) const override;
+    const char *name() const override { return "rangefinder"; }
+
+    bool hasValidReading() const { return frames_since_reading_ <= stale_frame_limit_; }
+
+private:
+    bool openSocket(int port);
+    void pollSocket();
+    void advanceReplay();
+
+    std::unique_ptr<RangeProvider> fallback_;
+    int stale_frame_limit_;
+    int frames_since_reading_;
+    float latest_depth_meters_;
+
+    long long socket_fd_; // -1 表示未使用 UDP
+    std::vector<float> replay_depths_;
+    size_t replay_index_;
+};
+
+/**
+ * @brief 根据参数文件创建距离估计模型
+ *
+ * @param filename 参数文件路径 (params.xml)
+ * @param camera_matrix 相机内参矩阵
+ * @param image_size 温度矩阵尺寸
+ *
+ * @return 距离估计模型。参数缺失或无效时返回 FixedRangeProvider
+ *
+ * 读取 range_model (fixed / ground_plane / rangefinder) 及对应参数。
+ */
+std::unique_ptr<RangeProvider> createRangeProvider(const std::string &filename,
+                                                   const cv::Mat &camera_matrix,
+                                                   const cv::Size &image_size);
+
+#endif // RANGE_ESTIMATION_H
@@ -0,0 +1,219 @@
+// src/region_tracking.cpp
+#include "region_tracking.h"
+#include "temperature_conversion.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <iostream>
+
+namespace
+{
+    // 第一个高于 threshold 的像素下标，没有时返回 n
+    int firstAbove(const float *t, int n, float threshold)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 vthr = cv::vx_setall_f32(threshold);
+        for (; x <= n - VL; x += VL)
+        {
+            if (cv::v_check_any(cv::v_gt(cv::vx_load(t + x), vthr)))
+                break;
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            if (t[x] > threshold)
+                return x;
+        }
+        return n;
+    }
+
+    int firstAbove(const short *t, int n, short threshold)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_int16>::vlanes();
+        const cv::v_int16 vthr = cv::vx_setall_s16(threshold);
+        for (; x <= n - VL; x += VL)
+        {
+            if (cv::v_check_any(cv::v_gt(cv::vx_load(t + x), vthr)))
+                break;
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            if (t[x] > threshold)
+                return x;
+        }
+        return n;
+    }
+
+    // 一行的候选判定，与 computeCandidateMask 的温度/屏蔽/背景条件一致 (升温速率候选由定期整帧检测发现)
+    template <typename T>
+    struct OutsideRow
+    {
+        const T *t;
+        const T *thr;       // 逐像素阈值，为空时使用 threshold
+        const uchar *allow; // 为空表示不屏蔽
+        const T *bg;        // 为空表示无背景剔除
+        const T *dev;
+        T threshold;
+        T tolerance;
+
+        bool candidate(int x) const
+        {
+            const T limit = thr ? thr[x] : threshold;
+            if (!(t[x] > limit) || (allow && !allow[x]))
+                return false;
+            if (!bg)
+                return true;
+            const auto difference = t[x] > bg[x] ? t[x] - bg[x] : bg[x] - t[x];
+            const bool stable = bg[x] > limit && difference < tolerance && dev[x] < tolerance;
+            return !stable;
+        }
+
+        // SIMD 找到高于发现阈值的像素后逐个确认，屏蔽区域与稳定高温物体只在被找到时付出标量代价
+        bool anyCandidate(int begin, int end) const
+        {
+            for (int x = begin; x < end; ++x)
+            {
+                x += firstAbove(t + x, end - x, threshold);
+                if (x < end && candidate(x))
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    // 逐行扫描 regions 之间的空隙，regions 已按 x 排序且互不重叠
+    template <typename T>
+    bool scanOutside(const cv::Mat &temp_matrix, T threshold, T tolerance, const CandidateMaskInputs &inputs,
+                     const std::vector<cv::Rect> &regions)
+    {
+        // 阈值图与背景按与温度矩阵相同的格式使用 (流程中二者均随温度矩阵格式转换)
+        const cv::Size size = temp_matrix.size();
+        const int type = temp_matrix.type();
+        const bool has_map = inputs.threshold_map.size() == size && inputs.threshold_map.type() == type;
+        const bool has_allow = inputs.allow_mask.size() == size;
+        const bool has_background = inputs.background.size() == size && inputs.background.type() == type &&
+                                    inputs.background_deviation.size() == size && inputs.background_deviation.type() == type;
+        OutsideRow<T> row{nullptr, nullptr, nullptr, nullptr, nullptr, threshold, tolerance};
+        for (int y = 0; y < temp_matrix.rows; ++y)
+        {
+            row.t = temp_matrix.ptr<T>(y);
+            row.thr = has_map ? inputs.threshold_map.ptr<T>(y) : nullptr;
+            row.allow = has_allow ? inputs.allow_mask.ptr<uchar>(y) : nullptr;
+            row.bg = has_background ? inputs.background.ptr<T>(y) : nullptr;
+            row.dev = has_background ? inputs.background_deviation.ptr<T>(y) : nullptr;
+            int x = 0;
+            for (const auto &r : regions)
+            {
+                if (y < r.y || y >= r.y + r.height)
+                    continue;
+                if (r.x > x && row.anyCandidate(x, r.x))
+                    return true;
+                x = std::max(x, r.x + r.width);
+            }
+            if (x < temp_matrix.cols && row.anyCandidate(x, temp_matrix.cols))
+                return true;
+        }
+        return false;
+    }
+}
+
+bool loadRegionTrackingConfig(const std::string &filename, RegionTrackingConfig &config)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["region_tracking_enabled"].isInt())
+        config.enabled = static_cast<int>(fs["region_tracking_enabled"]) != 0;
+    else
+        std::cout << "Warning: region_tracking_enabled not found in " << filename << std::endl;
+    if (fs["region_tracking_discovery_interval"].isInt())
+        fs["region_tracking_discovery_interval"] >> config.discovery_interval_frames;
+    if (fs["region_tracking_margin_pixels"].isInt())
+        fs["region_tracking_margin_pixels"] >> config.margin_pixels;
+    fs.release();
+    return true;
+}
+
+RegionTracker::RegionTracker(const RegionTrackingConfig &config)
+    : config_(config), frames_since_discovery_(0), predicted_(false)
+{
+    reset();
+}
+
+void RegionTracker::reset()
+{
+    regions_.clear();
+    // 首帧没有历史区域，必须整帧检测
+    frames_since_discovery_ = std::max(config_.discovery_interval_frames, 1);
+    predicted_ = false;
+}
+
+void RegionTracker::predict(const FrameMotion &motion, const cv::Size &image_size)
+{
+    const cv::Rect image_rect(cv::Point(0, 0), image_size);
+    std::vector<cv::Rect> predicted;
+    predicted.reserve(regions_.size());
+    for (const auto &r : regions_)
+    {
+        const cv::Point2f center(r.x + 0.5f * r.width, r.y + 0.5f * r.height);
+        const cv::Point2f moved = motion.apply(center);
+        cv::Rect p(r.x + cvRound(moved.x - center.x) - config_.margin_pixels,
+                   r.y + cvRound(moved.y - center.y) - config_.margin_pixels,
+                   r.width + 2 * config_.margin_pixels,
+                   r.height + 2 * config_.margin_pixels);
+        p &= image_rect;
+        if (p.area() > 0)
+            predicted.push_back(p);
+    }
+
+    // 合并重叠区域直到互不重叠，保证同一热点只被提取一次
+    bool merged = true;
+    while (merged)
+    {
+        merged = false;
+        for (size_t i = 0; i < predicted.size() && !merged; ++i)
+        {
+            for (size_t j = i + 1; j < predicted.size(); ++j)
+            {
+                if ((predicted[i] & predicted[j]).area() > 0)
+                {
+                    predicted[i] |= predicted[j];
+                    predicted.erase(predicted.begin() + j);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+    }
+    std::sort(predicted.begin(), predicted.end(), [](const cv::Rect &a, const cv::Rect &b) { return a.x < b.x; });
+    regions_ = predicted;
+    predicted_ = true;
+}
+
+bool RegionTracker::trackingFrame() const
+{
+    return config_.enabled && predicted_ && frames_since_discovery_ < config_.discovery_interval_frames;
+}
+
+void RegionTracker::record(const std::vector<cv::Rect> &blob_regions, bool full_discovery)
+{
+    regions_ = blob_regions;
+    frames_since_discovery_ = full_discovery ? 0 : frames_since_discovery_ + 1;
+    predicted_ = false;
+}
+
+bool hasHotPixelsOutside(const cv::Mat &temp_matrix, float threshold, const CandidateMaskInputs &inputs,
+                         const std::vector<cv::Rect> &regions)
+{
+    if (isCompactTemperature(temp_matrix))
+        return scanOutside<short>(temp_matrix, toDeciCelsius(threshold), toDeciCelsius(inputs.stable_tolerance), inputs, regions);
+    return scanOutside<float>(temp_matrix, threshold, inputs.stable_tolerance, inputs, regions);
+}
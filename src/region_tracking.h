@@ -0,0 +1,85 @@
+// src/region_tracking.h
+#ifndef REGION_TRACKING_H
+#define REGION_TRACKING_H
+
+#include "utils.h"
+#include "candidate_mask.h"
+#include "ego_motion.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 区域跟踪检测 ---
+// 整帧检测 (候选掩码 + 形态学 + findContours) 的开销与图像面积成正比，而火源通常只占画面一小部分。
+// 跟踪帧中只在上一帧热点的外接矩形内 (按帧间运动平移并外扩 margin) 重新生长热点，开销与火源面积成正比：
+//   1. 早退检查：已知区域外逐行 SIMD 比较温度，发现任一会成为候选的像素 (高于阈值、未被屏蔽、
+//      不是背景模型中的稳定高温物体) 即改为整帧检测；
+//   2. 各区域内计算候选掩码、形态学处理并提取轮廓；轮廓触及区域边界 (火源扩展出区域) 时改为整帧检测。
+// 每隔 discovery_interval_frames 帧强制整帧检测一次，发现仅靠升温速率成为候选的新热点。
+// 配置了测温区域统计时每帧都需要整帧遍历，跟踪检测不生效。
+
+struct RegionTrackingConfig
+{
+    bool enabled = false;
+    int discovery_interval_frames = REGION_TRACKING_DISCOVERY_INTERVAL_FRAMES;
+    int margin_pixels = REGION_TRACKING_MARGIN_PIXELS;
+};
+
+/**
+ * @brief 从参数文件读取区域跟踪检测配置
+ *
+ * @param filename 参数文件路径 (region_tracking_enabled, region_tracking_discovery_interval, region_tracking_margin_pixels)
+ * @param config 输出配置，缺失项保持默认值
+ * @return 文件打开成功返回 true
+ */
+bool loadRegionTrackingConfig(const std::string &filename, RegionTrackingConfig &config);
+
+class RegionTracker
+{
+public:
+    explicit RegionTracker(const RegionTrackingConfig &config = RegionTrackingConfig());
+
+    /**
+     * @brief 检测前调用：把上一帧热点区域按帧间运动预测到当前帧，外扩、裁剪并合并重叠区域
+     */
+    void predict(const FrameMotion &motion, const cv::Size &image_size);
+
+    /**
+     * @brief 本帧是否可以只在已知区域内检测
+     */
+    bool trackingFrame() const;
+
+    // 预测后的区域 (原始图像坐标，互不重叠)
+    const std::vector<cv::Rect> &regions() const { return regions_; }
+
+    /**
+     * @brief 检测后调用：记录本帧热点在原始图像中的外接矩形
+     *
+     * @param blob_regions 本帧热点外接矩形
+     * @param full_discovery 本帧是否做了整帧检测
+     */
+    void record(const std::vector<cv::Rect> &blob_regions, bool full_discovery);
+
+    void reset();
+
+private:
+    RegionTrackingConfig config_;
+    std::vector<cv::Rect> regions_;
+    int frames_since_discovery_;
+    bool predicted_;
+};
+
+/**
+ * @brief 早退检查：regions 之外是否存在会成为候选的高温像素
+ *
+ * @param temp_matrix 温度矩阵 (CV_32FC1 或 CV_16SC1)
+ * @param threshold 发现阈值 (°C)，不高于阈值图中的任一值
+ * @param inputs 整帧候选掩码输入：有阈值图时按逐像素阈值确认，屏蔽区域与背景稳定高温物体视为已知
+ * @param regions 互不重叠的已知区域
+ * @return 找到第一个此类像素即返回 true
+ */
+bool hasHotPixelsOutside(const cv::Mat &temp_matrix, float threshold, const CandidateMaskInputs &inputs,
+                         const std::vector<cv::Rect> &regions);
+
+#endif // REGION_TRACKING_H
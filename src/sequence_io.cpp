@@ -0,0 +1,178 @@
+// src/sequence_io.cpp
+#include "sequence_io.h"
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+bool getThermalImageAsTemperatureMatrix(const std::string &image_path,
+                                        cv::Mat &temp_matrix,
+                                        float min_temp,
+                                        float max_temp,
+                                        const cv::Size &target_size,
+                                        RegionStatistics *region_stats,
+                                        const NonUniformityCorrection *nuc,
+                                        int output_type,
+                                        TemporalDenoiseFilter *denoiser)
+{
+    // 1. 读取灰度图
+    cv::Mat gray_image = cv::imread(image_path, cv::IMREAD_GRAYSCALE);
+    if (gray_image.empty())
+    {
+        std::cerr << "Error: Could not load image from " << image_path << std::endl;
+        return false;
+    }
+
+    // 2. 缩放图像到指定分辨率；非均匀性校正表为探测器原生分辨率，需要缩放时先在原图上校正
+    cv::Mat resized_image;
+    if (gray_image.size() != target_size)
+    {
+        if (nuc)
+        {
+            if (!applyNonUniformityCorrection(gray_image, *nuc, gray_image))
+                std::cout << "Warning: NUC calibration size does not match frame size, NUC skipped." << std::endl;
+            nuc = nullptr;
+        }
+        cv::resize(gray_image, resized_image, target_size, 0, 0, cv::INTER_LINEAR);
+    }
+    else
+    {
+        resized_image = gray_image;
+    }
+
+    // 3. 灰度映射为温度，按需同时做非均匀性校正、时域降噪并生成区域统计表
+    convertGrayToTemperature(resized_image, min_temp, max_temp, temp_matrix, region_stats, nuc, output_type, denoiser);
+
+    return true;
+}
+
+bool readThermalFrame(const std::string &image_path, cv::Mat &frame)
+{
+    // IMREAD_ANYDEPTH 不带颜色标志时按单通道读取，并保留 16 位深度
+    frame = cv::imread(image_path, cv::IMREAD_ANYDEPTH);
+    if (frame.empty())
+    {
+        std::cerr << "Error: Could not load image from " << image_path << std::endl;
+        return false;
+    }
+    if (frame.depth() != CV_8U && frame.depth() != CV_16U)
+        frame.convertTo(frame, CV_8U);
+    return true;
+}
+
+std::vector<cv::Rect> RecordedSequence::fireBoxesForFrame(int frame_index) const
+{
+    std::vector<cv::Rect> boxes;
+    for (int i = 0; i < fire_boxes.rows; ++i)
+    {
+        const int *row = fire_boxes.ptr<int>(i);
+        if (row[0] == frame_index)
+            boxes.emplace_back(row[1], row[2], row[3], row[4]);
+    }
+    return boxes;
+}
+
+bool RecordedSequence::gimbalAnglesForFrame(int frame_index, float &azimuth_degrees, float &pitch_degrees) const
+{
+    if (frame_index < 0 || frame_index >= gimbal_angles.rows)
+        return false;
+    const float *angles = gimbal_angles.ptr<float>(frame_index);
+    azimuth_degrees = angles[0];
+    pitch_degrees = angles[1];
+    return true;
+}
+
+bool RecordedSequence::loadFrame(int frame_index, cv::Mat &temp_matrix, const cv::Size &target_size) const
+{
+    if (frame_index < 0 || frame_index >= static_cast<int>(frame_paths.size()))
+        return false;
+    return getThermalImageAsTemperatureMatrix(frame_paths[frame_index], temp_matrix, min_temperature, max_temperature, target_size);
+}
+
+bool loadRecordedSequence(const std::string &directory, RecordedSequence &sequence)
+{
+    sequence = RecordedSequence();
+    sequence.directory = directory;
+
+    std::vector<cv::String> files;
+    for (const char *pattern : {"/*.png", "/*.jpg", "/*.JPG", "/*.bmp", "/*.tif", "/*.tiff"})
+    {
+        std::vector<cv::String> matched;
+        cv::glob(directory + pattern, matched, false);
+        files.insert(files.end(), matched.begin(), matched.end());
+    }
+    std::sort(files.begin(), files.end());
+    files.erase(std::unique(files.begin(), files.end()), files.end());
+    for (const auto &f : files)
+        sequence.frame_paths.push_back(f);
+    if (sequence.frame_paths.empty())
+    {
+        std::cerr << "Error: No frames found in sequence directory: " << directory << std::endl;
+        return false;
+    }
+
+    const std::string meta_file = directory + "/sequence.yml";
+    cv::FileStorage fs(meta_file, cv::FileStorage::READ);
+    if (fs.isOpened())
+    {
+        if (fs["frame_interval_seconds"].isReal())
+            fs["frame_interval_seconds"] >> sequence.frame_interval_seconds;
+        if (fs["min_temperature"].isReal())
+            fs["min_temperature"] >> sequence.min_temperature;
+        if (fs["max_temperature"].isReal())
+            fs["max_temperature"] >> sequence.max_temperature;
+        fs["fire_boxes"] >> sequence.fire_boxes;
+        fs["gimbal_angles"] >> sequence.gimbal_angles;
+        fs.release();
+        if (!sequence.fire_boxes.empty())
+        {
+            if (sequence.fire_boxes.cols != 5)
+            {
+                std::cout << "Warning: fire_boxes must have 5 columns (frame x y width height) in " << meta_file << std::endl;
+                sequence.fire_boxes.release();
+            }
+            else
+            {
+                sequence.fire_boxes.convertTo(sequence.fire_boxes, CV_32S);
+            }
+        }
+        if (!sequence.gimbal_angles.empty())
+        {
+            if (sequence.gimbal_angles.cols != 2 || sequence.gimbal_angles.rows != static_cast<int>(sequence.frame_paths.size()))
+            {
+                std::cout << "Warning: gimbal_angles must have one row (azimuth pitch) per frame in " << meta_file << std::endl;
+                sequence.gimbal_angles.release();
+            }
+            else
+            {
+                sequence.gimbal_angles.convertTo(sequence.gimbal_angles, CV_32F);
+            }
+        }
+    }
+    else
+    {
+        std::cout << "Warning: " << meta_file << " not found, using default frame interval and temperature range." << std::endl;
+    }
+    return true;
+}
+
+bool readSequenceList(const std::string &list_file, std::vector<std::string> &directories)
+{
+    directories.clear();
+    std::ifstream in(list_file);
+    if (!in.is_open())
+    {
+        std::cerr << "Error: Could not open sequence list: " << list_file << std::endl;
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line))
+    {
+        line.erase(line.find_last_not_of(" \t\r\n") + 1);
+        if (line.empty() || line[0] == '#')
+            continue;
+        directories.push_back(line);
+    }
+    return !directories.empty();
+}
@@ -0,0 +1,95 @@
+// src/sequence_io.h
+#ifndef SEQUENCE_IO_H
+#define SEQUENCE_IO_H
+
+#include "temperature_conversion.h"
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+// --- 热成像帧读取与录制序列 ---
+// 本模块是检测流程中唯一依赖 imgcodecs 的部分 (单独编译为 firevision_io 库)。
+// 录制序列为一个目录：按文件名排序的灰度帧 (png/jpg/bmp/tiff) 加可选的 sequence.yml：
+//   frame_interval_seconds  帧间隔 (默认 1/30 s)
+//   min_temperature / max_temperature  灰度 0/255 对应的温度 (默认 20 / 500 °C)
+//   fire_boxes  N x 5 矩阵，每行 frame_index x y width height，标注的火焰区域 (训练/评估用)
+//   gimbal_angles  帧数 x 2 矩阵，每行为拍摄该帧时云台编码器的回转角与俯仰角 (度)，云台扫描录制时给出
+
+/**
+ * @brief 将热成像图像转换为温度矩阵
+ *
+ * @param image_path 图像文件路径
+ * @param temp_matrix 输出的温度矩阵
+ * @param min_temp 图像中的最低温度
+ * @param max_temp 图像中的最高温度
+ * @param target_size 目标图像分辨率，默认为384x288
+ * @param region_stats 非空时在转换的同一遍中生成区域统计表
+ * @param nuc 非空时在缩放前按原生分辨率做非均匀性校正与坏点替换 (无需缩放时与转换融合为同一遍)
+ * @param output_type 温度矩阵格式：CV_32FC1，或 CV_16SC1 (0.1 °C 定点)
+ * @param denoiser 非空时在转换的同一遍中做运动自适应时域降噪
+ * @return 如果成功加载图像并转换为温度矩阵则返回true，否则返回false
+ *
+ * 此函数读取灰度图像，并将其转换为指定分辨率的温度矩阵。转换过程中，会根据给定的温度范围将灰度值映射到温度值。
+ */
+bool getThermalImageAsTemperatureMatrix(const std::string &image_path,
+                                        cv::Mat &temp_matrix,
+                                        float min_temp,
+                                        float max_temp,
+                                        const cv::Size &target_size = cv::Size(384, 288),
+                                        RegionStatistics *region_stats = nullptr,
+                                        const NonUniformityCorrection *nuc = nullptr,
+                                        int output_type = CV_32FC1,
+                                        TemporalDenoiseFilter *denoiser = nullptr);
+
+/**
+ * @brief 读取一帧热成像数据，不做转换
+ *
+ * @param image_path 图像文件路径
+ * @param frame 输出帧：16 位原始帧保持 CV_16UC1，其余按灰度读取为 CV_8UC1 (供 FirePipeline::processFrame 使用)
+ * @return 读取成功返回 true
+ */
+bool readThermalFrame(const std::string &image_path, cv::Mat &frame);
+
+struct RecordedSequence
+{
+    std::string directory;
+    std::vector<std::string> frame_paths; // 按文件名排序
+    float frame_interval_seconds = 1.0f / 30.0f;
+    float min_temperature = 20.0f;
+    float max_temperature = 500.0f;
+    cv::Mat fire_boxes; // N x 5, CV_32S：frame_index x y width height
+    cv::Mat gimbal_angles; // 帧数 x 2, CV_32F：azimuth pitch (度)，未录制时为空
+
+    /**
+     * @brief 取某一帧的标注火焰区域
+     */
+    std::vector<cv::Rect> fireBoxesForFrame(int frame_index) const;
+
+    /**
+     * @brief 取某一帧录制的云台编码器角度
+     *
+     * @return 序列录制了 gimbal_angles 时返回 true；否则不修改输出 (调用方按云台零位处理)
+     */
+    bool gimbalAnglesForFrame(int frame_index, float &azimuth_degrees, float &pitch_degrees) const;
+
+    /**
+     * @brief 读取第 frame_index 帧的温度矩阵
+     */
+    bool loadFrame(int frame_index, cv::Mat &temp_matrix, const cv::Size &target_size = cv::Size(384, 288)) const;
+};
+
+/**
+ * @brief 加载录制序列目录
+ *
+ * @param directory 序列目录
+ * @param sequence 输出序列描述
+ * @return 目录中至少有一帧时返回 true
+ */
+bool loadRecordedSequence(const std::string &directory, RecordedSequence &sequence);
+
+/**
+ * @brief 读取序列列表文件，每行一个序列目录，# 开头为注释
+ */
+bool readSequenceList(const std::string &list_file, std::vector<std::string> &directories);
+
+#endif // SEQUENCE_IO_H
@@ -0,0 +1,488 @@
+// src/temperature_conversion.cpp
+#include "temperature_conversion.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+
+namespace
+{
+    inline int floorLog2(int v)
+    {
+        int k = 0;
+        while ((2 << k) <= v)
+            ++k;
+        return k;
+    }
+
+    // 两点校正与温度映射融合：t = min + scale * clamp(gain * raw + offset, 0, 255)
+    void convertRowCorrected(const uchar *g, const float *gain, const float *offset, int n,
+                             float scale, float min_temp, float *t)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 vscale = cv::vx_setall_f32(scale);
+        const cv::v_float32 vmin_temp = cv::vx_setall_f32(min_temp);
+        const cv::v_float32 vzero = cv::vx_setzero_f32();
+        const cv::v_float32 vfull = cv::vx_setall_f32(255.0f);
+        for (; x <= n - VL; x += VL)
+        {
+            cv::v_float32 raw = cv::v_cvt_f32(cv::v_reinterpret_as_s32(cv::vx_load_expand_q(g + x)));
+            cv::v_float32 corrected = cv::v_fma(raw, cv::vx_load(gain + x), cv::vx_load(offset + x));
+            corrected = cv::v_min(cv::v_max(corrected, vzero), vfull);
+            cv::v_store(t + x, cv::v_fma(corrected, vscale, vmin_temp));
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            const float corrected = std::min(std::max(gain[x] * g[x] + offset[x], 0.0f), 255.0f);
+            t[x] = min_temp + scale * corrected;
+        }
+    }
+}
+
+void RegionStatistics::begin(const cv::Size &size)
+{
+    ready_ = false;
+    size_ = size;
+    blocks_x_ = (size.width + REGION_MAX_BLOCK - 1) / REGION_MAX_BLOCK;
+    blocks_y_ = (size.height + REGION_MAX_BLOCK - 1) / REGION_MAX_BLOCK;
+
+    sum_.create(size.height + 1, size.width + 1, CV_64F);
+    sqsum_.create(size.height + 1, size.width + 1, CV_64F);
+    sum_.row(0).setTo(cv::Scalar(0.0));
+    sqsum_.row(0).setTo(cv::Scalar(0.0));
+
+    row_prefix_.create(size, CV_32F);
+    row_suffix_.create(size, CV_32F);
+    col_prefix_.create(size, CV_32F);
+    col_suffix_.create(size, CV_32F);
+
+    row_sparse_.resize(1);
+    row_sparse_[0].create(size.height, blocks_x_, CV_32F);
+    col_sparse_.resize(1);
+    col_sparse_[0].create(size.width, blocks_y_, CV_32F);
+    grid_sparse_.assign(1, std::vector<cv::Mat>(1));
+    grid_sparse_[0][0].create(blocks_y_, blocks_x_, CV_32F);
+    grid_sparse_[0][0].setTo(cv::Scalar(-FLT_MAX));
+}
+
+void RegionStatistics::accumulateRow(int y, const float *row)
+{
+    const int width = size_.width;
+    const int B = REGION_MAX_BLOCK;
+
+    // 积分图：当前行的前缀和加上一行的积分值
+    double *s = sum_.ptr<double>(y + 1);
+    double *q = sqsum_.ptr<double>(y + 1);
+    const double *s_prev = sum_.ptr<double>(y);
+    const double *q_prev = sqsum_.ptr<double>(y);
+    double acc = 0.0, acc_sq = 0.0;
+    s[0] = 0.0;
+    q[0] = 0.0;
+    for (int x = 0; x < width; ++x)
+    {
+        const double v = row[x];
+        acc += v;
+        acc_sq += v * v;
+        s[x + 1] = s_prev[x + 1] + acc;
+        q[x + 1] = q_prev[x + 1] + acc_sq;
+    }
+
+    // 行方向：块内前缀/后缀最大值，块最大值写入行稀疏表第 0 层和块网格
+    float *rp = row_prefix_.ptr<float>(y);
+    float *rs = row_suffix_.ptr<float>(y);
+    float *row_blocks = row_sparse_[0].ptr<float>(y);
+    float *grid = grid_sparse_[0][0].ptr<float>(y / B);
+    for (int bx = 0; bx < blocks_x_; ++bx)
+    {
+        const int start = bx * B, end = std::min(start + B, width);
+        float m = -FLT_MAX;
+        for (int x = start; x < end; ++x)
+            rp[x] = m = std::max(m, row[x]);
+        m = -FLT_MAX;
+        for (int x = end - 1; x >= start; --x)
+            rs[x] = m = std::max(m, row[x]);
+        row_blocks[bx] = m;
+        grid[bx] = std::max(grid[bx], m);
+    }
+
+    // 列方向：前缀最大值逐行递推；后缀最大值在块行结束时倒序补齐
+    float *cp = col_prefix_.ptr<float>(y);
+    float *cs = col_suffix_.ptr<float>(y);
+    const bool block_row_start = (y % B) == 0;
+    const float *cp_prev = block_row_start ? nullptr : col_prefix_.ptr<float>(y - 1);
+    for (int x = 0; x < width; ++x)
+    {
+        cp[x] = block_row_start ? row[x] : std::max(cp_prev[x], row[x]);
+        cs[x] = row[x];
+    }
+    if ((y % B) == B - 1 || y == size_.height - 1)
+    {
+        const int y_start = y - (y % B);
+        for (int yy = y - 1; yy >= y_start; --yy)
+        {
+            float *cur = col_suffix_.ptr<float>(yy);
+            const float *next = col_suffix_.ptr<float>(yy + 1);
+            for (int x = 0; x < width; ++x)
+                cur[x] = std::max(cur[x], next[x]);
+        }
+        const float *block_max = col_suffix_.ptr<float>(y_start);
+        const int by = y / B;
+        for (int x = 0; x < width; ++x)
+            col_sparse_[0].at<float>(x, by) = block_max[x];
+    }
+}
+
+void RegionStatistics::finish()
+{
+    // 一维稀疏表：第 k 层覆盖连续 2^k 个块
+    auto build_levels = [](std::vector<cv::Mat> &levels, int count)
+    {
+        levels.resize(1);
+        for (int k = 1; (1 << k) <= count; ++k)
+        {
+            const int half = 1 << (k - 1);
+            const cv::Mat &prev = levels[k - 1];
+            cv::Mat next(prev.rows, count - (1 << k) + 1, CV_32F);
+            for (int r = 0; r < prev.rows; ++r)
+            {
+                const float *p = prev.ptr<float>(r);
+                float *n = next.ptr<float>(r);
+                for (int i = 0; i < next.cols; ++i)
+                    n[i] = std::max(p[i], p[i + half]);
+            }
+            levels.push_back(next);
+        }
+    };
+    build_levels(row_sparse_, blocks_x_);
+    build_levels(col_sparse_, blocks_y_);
+
+    // 二维稀疏表：先沿 x 方向，再沿 y 方向
+    build_levels(grid_sparse_[0], blocks_x_);
+    for (int ky = 1; (1 << ky) <= blocks_y_; ++ky)
+    {
+        const int half = 1 << (ky - 1);
+        std::vector<cv::Mat> level(grid_sparse_[ky - 1].size());
+        for (size_t kx = 0; kx < level.size(); ++kx)
+        {
+            const cv::Mat &prev = grid_sparse_[ky - 1][kx];
+            level[kx].create(blocks_y_ - (1 << ky) + 1, prev.cols, CV_32F);
+            for (int r = 0; r < level[kx].rows; ++r)
+            {
+                const float *a = prev.ptr<float>(r);
+                const float *b = prev.ptr<float>(r + half);
+                float *out = level[kx].ptr<float>(r);
+                for (int c = 0; c < prev.cols; ++c)
+                    out[c] = std::max(a[c], b[c]);
+            }
+        }
+        grid_sparse_.push_back(level);
+    }
+    ready_ = true;
+}
+
+void RegionStatistics::build(const cv::Mat &temp_matrix)
+{
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Region statistics input must be CV_32FC1 or CV_16SC1." << std::endl;
+        ready_ = false;
+        return;
+    }
+    std::vector<float> scratch;
+    begin(temp_matrix.size());
+    for (int y = 0; y < temp_matrix.rows; ++y)
+        accumulateRow(y, temperatureRow(temp_matrix, y, scratch));
+    finish();
+}
+
+float RegionStatistics::blockRangeMax(int bx0, int by0, int bx1, int by1) const
+{
+    const int kx = floorLog2(bx1 - bx0 + 1);
+    const int ky = floorLog2(by1 - by0 + 1);
+    const cv::Mat &t = grid_sparse_[ky][kx];
+    const int bx2 = bx1 - (1 << kx) + 1;
+    const int by2 = by1 - (1 << ky) + 1;
+    return std::max(std::max(t.at<float>(by0, bx0), t.at<float>(by0, bx2)),
+                    std::max(t.at<float>(by2, bx0), t.at<float>(by2, bx2)));
+}
+
+float RegionStatistics::rowSegmentMax(int y, int x0, int x1) const
+{
+    const int B = REGION_MAX_BLOCK;
+    const int bx0 = x0 / B, bx1 = x1 / B;
+    if (bx0 == bx1)
+    {
+        const int block_end = std::min((bx0 + 1) * B, size_.width) - 1;
+        if (x0 % B == 0)
+            return row_prefix_.at<float>(y, x1);
+        if (x1 == block_end)
+            return row_suffix_.at<float>(y, x0);
+        // 块内部的一段 (不足一块)，由积分图还原像素值逐个比较
+        float m = -FLT_MAX;
+        const double *s0 = sum_.ptr<double>(y);
+        const double *s1 = sum_.ptr<double>(y + 1);
+        for (int x = x0; x <= x1; ++x)
+            m = std::max(m, static_cast<float>(s1[x + 1] - s0[x + 1] - s1[x] + s0[x]));
+        return m;
+    }
+    float m = std::max(row_suffix_.at<float>(y, x0), row_prefix_.at<float>(y, x1));
+    if (bx1 - bx0 >= 2)
+    {
+        const int k = floorLog2(bx1 - bx0 - 1);
+        const cv::Mat &t = row_sparse_[k];
+        m = std::max(m, std::max(t.at<float>(y, bx0 + 1), t.at<float>(y, bx1 - (1 << k))));
+    }
+    return m;
+}
+
+float RegionStatistics::columnSegmentMax(int x, int y0, int y1) const
+{
+    const int B = REGION_MAX_BLOCK;
+    const int by0 = y0 / B, by1 = y1 / B;
+    if (by0 == by1)
+    {
+        const int block_end = std::min((by0 + 1) * B, size_.height) - 1;
+        if (y0 % B == 0)
+            return col_prefix_.at<float>(y1, x);
+        if (y1 == block_end)
+            return col_suffix_.at<float>(y0, x);
+        float m = -FLT_MAX;
+        for (int y = y0; y <= y1; ++y)
+        {
+            const double *s0 = sum_.ptr<double>(y);
+            const double *s1 = sum_.ptr<double>(y + 1);
+            m = std::max(m, static_cast<float>(s1[x + 1] - s0[x + 1] - s1[x] + s0[x]));
+        }
+        return m;
+    }
+    float m = std::max(col_suffix_.at<float>(y0, x), col_prefix_.at<float>(y1, x));
+    if (by1 - by0 >= 2)
+    {
+        const int k = floorLog2(by1 - by0 - 1);
+        const cv::Mat &t = col_sparse_[k];
+        m = std::max(m, std::max(t.at<float>(x, by0 + 1), t.at<float>(x, by1 - (1 << k))));
+    }
+    return m;
+}
+
+bool RegionStatistics::query(const cv::Rect &region, RegionStats &stats) const
+{
+    stats = RegionStats();
+    if (!ready_)
+        return false;
+    const cv::Rect r = region & cv::Rect(0, 0, size_.width, size_.height);
+    if (r.area() <= 0)
+        return false;
+
+    const int x0 = r.x, y0 = r.y, x1 = r.x + r.width - 1, y1 = r.y + r.height - 1;
+    const int n = r.area();
+    const double sum = sum_.at<double>(y1 + 1, x1 + 1) - sum_.at<double>(y0, x1 + 1) - sum_.at<double>(y1 + 1, x0) + sum_.at<double>(y0, x0);
+    const double sqsum = sqsum_.at<double>(y1 + 1, x1 + 1) - sqsum_.at<double>(y0, x1 + 1) - sqsum_.at<double>(y1 + 1, x0) + sqsum_.at<double>(y0, x0);
+    stats.pixel_count = n;
+    stats.mean = sum / n;
+    stats.variance = std::max(sqsum / n - stats.mean * stats.mean, 0.0);
+
+    // 完整块范围 (含右/下边缘的不完整块)
+    const int B = REGION_MAX_BLOCK;
+    const int fbx0 = (x0 + B - 1) / B;
+    const int fbx1 = (x1 == size_.width - 1) ? blocks_x_ - 1 : (x1 + 1) / B - 1;
+    const int fby0 = (y0 + B - 1) / B;
+    const int fby1 = (y1 == size_.height - 1) ? blocks_y_ - 1 : (y1 + 1) / B - 1;
+
+    float m = -FLT_MAX;
+    if (fbx0 <= fbx1 && fby0 <= fby1)
+    {
+        m = blockRangeMax(fbx0, fby0, fbx1, fby1);
+        const int core_x0 = fbx0 * B, core_x1 = std::min((fbx1 + 1) * B, size_.width) - 1;
+        const int core_y0 = fby0 * B, core_y1 = std::min((fby1 + 1) * B, size_.height) - 1;
+        for (int y = y0; y < core_y0; ++y)
+            m = std::max(m, rowSegmentMax(y, x0, x1));
+        for (int y = core_y1 + 1; y <= y1; ++y)
+            m = std::max(m, rowSegmentMax(y, x0, x1));
+        for (int x = x0; x < core_x0; ++x)
+            m = std::max(m, columnSegmentMax(x, core_y0, core_y1));
+        for (int x = core_x1 + 1; x <= x1; ++x)
+            m = std::max(m, columnSegmentMax(x, core_y0, core_y1));
+    }
+    else if (fby0 > fby1)
+    {
+        // 高度不含完整块行 (少于 2 块高)，逐行查询
+        for (int y = y0; y <= y1; ++y)
+            m = std::max(m, rowSegmentMax(y, x0, x1));
+    }
+    else
+    {
+        // 宽度不含完整块列 (少于 2 块宽)，逐列查询
+        for (int x = x0; x <= x1; ++x)
+            m = std::max(m, columnSegmentMax(x, y0, y1));
+    }
+    stats.max_temperature = m;
+    return true;
+}
+
+void compactTemperatureRow(const float *src, short *dst, int n)
+{
+    int x = 0;
+#if CV_SIMD
+    const int VL = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vscale = cv::vx_setall_f32(DECI_CELSIUS_PER_DEGREE);
+    for (; x <= n - 2 * VL; x += 2 * VL)
+    {
+        cv::v_int32 a = cv::v_round(cv::v_mul(cv::vx_load(src + x), vscale));
+        cv::v_int32 b = cv::v_round(cv::v_mul(cv::vx_load(src + x + VL), vscale));
+        cv::v_store(dst + x, cv::v_pack(a, b)); // 饱和截断
+    }
+#endif
+    for (; x < n; ++x)
+        dst[x] = toDeciCelsius(src[x]);
+}
+
+void expandTemperatureRow(const short *src, float *dst, int n)
+{
+    int x = 0;
+#if CV_SIMD
+    const int VL = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vscale = cv::vx_setall_f32(1.0f / DECI_CELSIUS_PER_DEGREE);
+    for (; x <= n - 2 * VL; x += 2 * VL)
+    {
+        cv::v_int32 a, b;
+        cv::v_expand(cv::vx_load(src + x), a, b);
+        cv::v_store(dst + x, cv::v_mul(cv::v_cvt_f32(a), vscale));
+        cv::v_store(dst + x + VL, cv::v_mul(cv::v_cvt_f32(b), vscale));
+    }
+#endif
+    for (; x < n; ++x)
+        dst[x] = src[x] / DECI_CELSIUS_PER_DEGREE;
+}
+
+void convertTemperatureFormat(const cv::Mat &src, cv::Mat &dst, int output_type)
+{
+    if (!isTemperatureMatrix(src) || (output_type != CV_32FC1 && output_type != CV_16SC1))
+    {
+        std::cerr << "Error: Temperature format conversion supports CV_32FC1 and CV_16SC1 only." << std::endl;
+        dst.release();
+        return;
+    }
+    if (src.type() == output_type)
+    {
+        src.copyTo(dst);
+        return;
+    }
+    // 保留输入数据的引用，允许 src 与 dst 为同一矩阵
+    const cv::Mat input = src;
+    dst.create(input.size(), output_type);
+    for (int y = 0; y < input.rows; ++y)
+    {
+        if (output_type == CV_16SC1)
+            compactTemperatureRow(input.ptr<float>(y), dst.ptr<short>(y), input.cols);
+        else
+            expandTemperatureRow(input.ptr<short>(y), dst.ptr<float>(y), input.cols);
+    }
+}
+
+bool loadTemperatureMatrixType(const std::string &filename, int &temperature_type)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["compact_temperature_matrix"].isInt())
+        temperature_type = static_cast<int>(fs["compact_temperature_matrix"]) != 0 ? CV_16SC1 : CV_32FC1;
+    else
+        std::cout << "Warning: compact_temperature_matrix not found in " << filename << std::endl;
+    fs.release();
+    return true;
+}
+
+const float *temperatureRow(const cv::Mat &temp_matrix, int y, std::vector<float> &scratch)
+{
+    if (!isCompactTemperature(temp_matrix))
+        return temp_matrix.ptr<float>(y);
+    scratch.resize(temp_matrix.cols);
+    expandTemperatureRow(temp_matrix.ptr<short>(y), scratch.data(), temp_matrix.cols);
+    return scratch.data();
+}
+
+void convertGrayToTemperature(const cv::Mat &gray,
+                              float min_temp,
+                              float max_temp,
+                              cv::Mat &temp_matrix,
+                              RegionStatistics *region_stats,
+                              const NonUniformityCorrection *nuc,
+                              int output_type,
+                              TemporalDenoiseFilter *denoiser)
+{
+    if (gray.empty() || gray.type() != CV_8UC1)
+    {
+        std::cerr << "Error: Temperature conversion input must be CV_8UC1." << std::endl;
+        temp_matrix.release();
+        return;
+    }
+    if (output_type != CV_32FC1 && output_type != CV_16SC1)
+    {
+        std::cerr << "Error: Temperature output type must be CV_32FC1 or CV_16SC1." << std::endl;
+        temp_matrix.release();
+        return;
+    }
+    const bool compact = output_type == CV_16SC1;
+
+    // 8 位输入只有 256 种取值，查表代替逐像素乘加
+    float lut[256];
+    const float scale = (max_temp - min_temp) / 255.0f;
+    for (int i = 0; i < 256; ++i)
+        lut[i] = min_temp + scale * i;
+
+    const bool has_nuc = nuc && nuc->isValid(gray.size());
+    if (nuc && !has_nuc)
+        std::cout << "Warning: NUC calibration size does not match frame size, NUC skipped." << std::endl;
+    const int bad_count = has_nuc ? nuc->bad_pixels.rows : 0;
+    int next_bad = 0;
+
+    // 定点输出时每行先在浮点缓冲区中完成校正与映射，再压缩写出
+    std::vector<float> row_buffer(compact ? gray.cols : 0);
+    temp_matrix.create(gray.size(), output_type);
+    if (region_stats)
+        region_stats->begin(gray.size());
+    if (denoiser)
+        denoiser->begin(gray.size());
+    for (int y = 0; y < gray.rows; ++y)
+    {
+        const uchar *g = gray.ptr<uchar>(y);
+        float *t = compact ? row_buffer.data() : temp_matrix.ptr<float>(y);
+        if (has_nuc)
+        {
+            convertRowCorrected(g, nuc->gain.ptr<float>(y), nuc->offset.ptr<float>(y), gray.cols, scale, min_temp, t);
+            // 坏点：用替换像素的原始灰度按其自身校正系数计算，不依赖替换像素所在行是否已转换
+            const int row_end = (y + 1) * gray.cols;
+            for (; next_bad < bad_count && nuc->bad_pixels.at<int>(next_bad, 0) < row_end; ++next_bad)
+            {
+                const int bad = nuc->bad_pixels.at<int>(next_bad, 0);
+                const int src = nuc->bad_pixels.at<int>(next_bad, 1);
+                if (bad < y * gray.cols || src < 0 || src >= static_cast<int>(gray.total()))
+                    continue;
+                const int sy = src / gray.cols, sx = src % gray.cols;
+                const float corrected = nuc->gain.at<float>(sy, sx) * gray.at<uchar>(sy, sx) + nuc->offset.at<float>(sy, sx);
+                t[bad - y * gray.cols] = min_temp + scale * std::min(std::max(corrected, 0.0f), 255.0f);
+            }
+        }
+        else
+        {
+            for (int x = 0; x < gray.cols; ++x)
+                t[x] = lut[g[x]];
+        }
+        if (denoiser)
+            denoiser->filterRow(y, t);
+        if (compact)
+            compactTemperatureRow(t, temp_matrix.ptr<short>(y), gray.cols);
+        if (region_stats)
+            region_stats->accumulateRow(y, t); // 当前行仍在缓存中
+    }
+    if (region_stats)
+        region_stats->finish();
+}
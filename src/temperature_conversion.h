@@ -0,0 +1,152 @@
+// src/temperature_conversion.h
+#ifndef TEMPERATURE_CONVERSION_H
+#define TEMPERATURE_CONVERSION_H
+
+#include "nuc_correction.h"
+#include "temporal_denoise.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 灰度 -> 温度转换与区域测温 ---
+// 转换按行进行，可在同一遍中完成非均匀性校正/坏点替换、时域降噪，并顺带生成区域统计表：
+//   * 温度及温度平方的积分图 (CV_64F)：任意矩形的均值、方差 O(1)
+//   * 分块最大值结构：块内每行/每列的前缀、后缀最大值，加上行、列方向的块级稀疏表和块网格的二维稀疏表。
+//     矩形最大值 = 完整块部分 (二维稀疏表 O(1)) + 边缘不足一块的行/列 (每行/列 O(1))，
+//     边缘行列数不超过 4 * REGION_MAX_BLOCK，因此单次查询耗时有固定上界，与矩形大小无关。
+// 每帧数百次区域查询的开销可以忽略。
+
+const int REGION_MAX_BLOCK = 8; // 分块边长
+
+// --- 紧凑温度格式 ---
+// 温度矩阵可选 CV_16SC1，单位 0.1 °C (范围 ±3276.7 °C)，内存与带宽为 CV_32FC1 的一半。
+// 检测、统计和显示各环节同时接受两种格式：阈值比较直接在 int16 上做 SIMD 比较，
+// 需要浮点运算的逐行内核用 temperatureRow() 将当前行就地展开到一行大小的缓冲区 (留在 L1 中)。
+
+const float DECI_CELSIUS_PER_DEGREE = 10.0f;
+
+inline bool isCompactTemperature(const cv::Mat &temp_matrix) { return temp_matrix.type() == CV_16SC1; }
+inline bool isTemperatureMatrix(const cv::Mat &temp_matrix)
+{
+    return !temp_matrix.empty() && (temp_matrix.type() == CV_32FC1 || temp_matrix.type() == CV_16SC1);
+}
+// 矩阵元素值乘以该系数得到摄氏度
+inline float temperatureUnitCelsius(const cv::Mat &temp_matrix) { return isCompactTemperature(temp_matrix) ? 1.0f / DECI_CELSIUS_PER_DEGREE : 1.0f; }
+inline short toDeciCelsius(float celsius) { return cv::saturate_cast<short>(cvRound(celsius * DECI_CELSIUS_PER_DEGREE)); }
+
+/**
+ * @brief 浮点温度行与 0.1 °C 定点行互转 (SIMD，定点饱和截断)
+ */
+void compactTemperatureRow(const float *src, short *dst, int n);
+void expandTemperatureRow(const short *src, float *dst, int n);
+
+/**
+ * @brief 整个矩阵在两种格式间转换
+ *
+ * @param src 温度矩阵 (CV_32FC1 或 CV_16SC1)
+ * @param dst 输出矩阵
+ * @param output_type CV_32FC1 或 CV_16SC1
+ */
+void convertTemperatureFormat(const cv::Mat &src, cv::Mat &dst, int output_type);
+
+/**
+ * @brief 从参数文件读取温度矩阵格式
+ *
+ * @param filename 参数文件路径 (compact_temperature_matrix: 1 为 CV_16SC1，0 为 CV_32FC1)
+ * @param temperature_type 输出矩阵类型，缺失时保持原值
+ * @return 文件打开成功返回 true
+ */
+bool loadTemperatureMatrixType(const std::string &filename, int &temperature_type);
+
+/**
+ * @brief 取温度矩阵第 y 行的浮点 (°C) 指针：CV_32FC1 直接返回行指针，CV_16SC1 展开到 scratch 后返回
+ */
+const float *temperatureRow(const cv::Mat &temp_matrix, int y, std::vector<float> &scratch);
+
+// 单个矩形的统计结果
+struct RegionStats
+{
+    int pixel_count = 0;
+    double mean = 0.0;
+    double variance = 0.0;
+    float max_temperature = 0.0f;
+};
+
+class RegionStatistics
+{
+public:
+    /**
+     * @brief 开始新一帧，分配 (或复用) 统计表
+     */
+    void begin(const cv::Size &size);
+
+    /**
+     * @brief 累积一行温度 (须按 y = 0,1,2... 的顺序调用)
+     */
+    void accumulateRow(int y, const float *row);
+
+    /**
+     * @brief 所有行累积完毕后建立稀疏表
+     */
+    void finish();
+
+    /**
+     * @brief 对已有温度矩阵 (CV_32FC1 或 CV_16SC1) 一次性建表 (不经过转换阶段时使用)
+     */
+    void build(const cv::Mat &temp_matrix);
+
+    /**
+     * @brief 查询矩形区域的均值、方差和最大值
+     *
+     * @param region 矩形 (像素坐标)，超出图像部分被裁掉
+     * @param stats 输出统计结果
+     * @return 裁剪后区域非空时返回 true
+     */
+    bool query(const cv::Rect &region, RegionStats &stats) const;
+
+    bool isReady() const { return ready_; }
+    const cv::Mat &integral() const { return sum_; }
+    const cv::Mat &integralSquared() const { return sqsum_; }
+
+private:
+    float rowSegmentMax(int y, int x0, int x1) const;
+    float columnSegmentMax(int x, int y0, int y1) const;
+    float blockRangeMax(int bx0, int by0, int bx1, int by1) const;
+
+    cv::Size size_;
+    int blocks_x_ = 0, blocks_y_ = 0;
+    bool ready_ = false;
+
+    cv::Mat sum_;   // (H+1) x (W+1), CV_64F
+    cv::Mat sqsum_; // (H+1) x (W+1), CV_64F
+
+    cv::Mat row_prefix_, row_suffix_; // H x W，块内行方向前缀/后缀最大值
+    cv::Mat col_prefix_, col_suffix_; // H x W，块内列方向前缀/后缀最大值
+    std::vector<cv::Mat> row_sparse_; // 第 k 层：H x (blocks_x - 2^k + 1)，行内连续 2^k 个块的最大值
+    std::vector<cv::Mat> col_sparse_; // 第 k 层：W x (blocks_y - 2^k + 1)，列内连续 2^k 个块的最大值
+    std::vector<std::vector<cv::Mat>> grid_sparse_; // [ky][kx]：块网格二维稀疏表
+};
+
+/**
+ * @brief 8 位灰度帧线性映射为温度矩阵，可选同时做非均匀性校正并生成区域统计表
+ *
+ * @param gray 灰度帧 (CV_8UC1)
+ * @param min_temp 灰度 0 对应的温度
+ * @param max_temp 灰度 255 对应的温度
+ * @param temp_matrix 输出温度矩阵 (output_type)
+ * @param region_stats 非空时在同一遍中生成区域统计表
+ * @param nuc 非空且尺寸匹配时，映射前先做两点校正 (校正后灰度截断到 [0,255]) 并替换坏点
+ * @param output_type CV_32FC1，或 CV_16SC1 (0.1 °C 定点)
+ * @param denoiser 非空时在映射后原地做时域降噪，区域统计与输出均为降噪后的温度
+ */
+void convertGrayToTemperature(const cv::Mat &gray,
+                              float min_temp,
+                              float max_temp,
+                              cv::Mat &temp_matrix,
+                              RegionStatistics *region_stats = nullptr,
+                              const NonUniformityCorrection *nuc = nullptr,
+                              int output_type = CV_32FC1,
+                              TemporalDenoiseFilter *denoiser = nullptr);
+
+#endif // TEMPERATURE_CONVERSION_H
@@ -0,0 +1,95 @@
+// src/temporal_denoise.cpp
+#include "temporal_denoise.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // 状态平面中未初始化像素 (首帧或运动补偿移入的边缘) 的标记值
+    const float UNINITIALIZED_TEMPERATURE = -1000.0f;
+    const float UNINITIALIZED_THRESHOLD = -500.0f;
+}
+
+bool loadTemporalDenoiseConfig(const std::string &filename, TemporalDenoiseConfig &config)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["temporal_denoise_enabled"].isInt())
+        config.enabled = static_cast<int>(fs["temporal_denoise_enabled"]) != 0;
+    else
+        std::cout << "Warning: temporal_denoise_enabled not found in " << filename << std::endl;
+    if (fs["temporal_denoise_min_gain"].isReal())
+        fs["temporal_denoise_min_gain"] >> config.min_gain;
+    if (fs["temporal_denoise_motion_celsius"].isReal())
+        fs["temporal_denoise_motion_celsius"] >> config.motion_celsius;
+    fs.release();
+    return true;
+}
+
+TemporalDenoiseFilter::TemporalDenoiseFilter(const TemporalDenoiseConfig &config)
+    : min_gain_(std::min(std::max(config.min_gain, 0.01f), 1.0f)),
+      inv_motion_(1.0f / std::max(config.motion_celsius, 1e-3f))
+{
+}
+
+void TemporalDenoiseFilter::reset()
+{
+    state_.release();
+}
+
+void TemporalDenoiseFilter::begin(const cv::Size &size)
+{
+    if (state_.size() != size)
+    {
+        state_.create(size, CV_32FC1);
+        state_.setTo(cv::Scalar(UNINITIALIZED_TEMPERATURE));
+    }
+}
+
+void TemporalDenoiseFilter::compensate(const FrameMotion &motion)
+{
+    shiftStatePlane(state_, motion, cv::Scalar(UNINITIALIZED_TEMPERATURE));
+}
+
+void TemporalDenoiseFilter::filterRow(int y, float *t)
+{
+    float *s = state_.ptr<float>(y);
+    const int n = state_.cols;
+    const float min_gain = min_gain_;
+    const float inv_motion = inv_motion_;
+    int x = 0;
+#if CV_SIMD
+    const int VL = cv::VTraits<cv::v_float32>::vlanes();
+    const cv::v_float32 vmin_gain = cv::vx_setall_f32(min_gain);
+    const cv::v_float32 vinv = cv::vx_setall_f32(inv_motion);
+    const cv::v_float32 vone = cv::vx_setall_f32(1.0f);
+    const cv::v_float32 vuninit = cv::vx_setall_f32(UNINITIALIZED_THRESHOLD);
+    for (; x <= n - VL; x += VL)
+    {
+        cv::v_float32 vt = cv::vx_load(t + x);
+        cv::v_float32 vs = cv::vx_load(s + x);
+        vs = cv::v_select(cv::v_lt(vs, vuninit), vt, vs);
+        cv::v_float32 d = cv::v_sub(vt, vs);
+        cv::v_float32 k = cv::v_min(cv::v_fma(cv::v_abs(d), vinv, vmin_gain), vone);
+        vs = cv::v_fma(k, d, vs);
+        cv::v_store(s + x, vs);
+        cv::v_store(t + x, vs);
+    }
+#endif
+    for (; x < n; ++x)
+    {
+        float vs = s[x] < UNINITIALIZED_THRESHOLD ? t[x] : s[x];
+        const float d = t[x] - vs;
+        const float k = std::min(min_gain + std::fabs(d) * inv_motion, 1.0f);
+        vs += k * d;
+        s[x] = vs;
+        t[x] = vs;
+    }
+}
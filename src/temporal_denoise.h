@@ -0,0 +1,63 @@
+// src/temporal_denoise.h
+#ifndef TEMPORAL_DENOISE_H
+#define TEMPORAL_DENOISE_H
+
+#include "utils.h"
+#include "ego_motion.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+
+// --- 运动自适应时域降噪 ---
+// 阈值附近的传感器噪声使热点边界逐帧闪动，面积过滤和分组结果随之跳变。
+// 每个像素维护一个递归 (IIR) 滤波状态：
+//   d = t - s,  k = min(1, min_gain + |d| / motion_celsius),  s += k * d,  t = s
+// 小幅波动 (噪声) 以 min_gain 平滑，大幅变化 (运动、火焰突变) 增益趋于 1 直接跟随，不拖尾。
+// 滤波在温度转换的行循环中原地进行 (SIMD)，状态为一个 CV_32FC1 平面，不增加额外的整帧遍历。
+
+struct TemporalDenoiseConfig
+{
+    bool enabled = false;
+    float min_gain = TEMPORAL_DENOISE_MIN_GAIN;             // 静止像素的滤波增益 (0,1]
+    float motion_celsius = TEMPORAL_DENOISE_MOTION_CELSIUS; // 帧差达到该值时增益为 1
+};
+
+/**
+ * @brief 从参数文件读取时域降噪配置
+ *
+ * @param filename 参数文件路径 (temporal_denoise_enabled, temporal_denoise_min_gain, temporal_denoise_motion_celsius)
+ * @param config 输出配置，缺失项保持默认值
+ * @return 文件打开成功返回 true
+ */
+bool loadTemporalDenoiseConfig(const std::string &filename, TemporalDenoiseConfig &config);
+
+class TemporalDenoiseFilter
+{
+public:
+    explicit TemporalDenoiseFilter(const TemporalDenoiseConfig &config = TemporalDenoiseConfig());
+
+    /**
+     * @brief 开始新一帧：尺寸变化时重新分配状态平面 (首帧直接采用当前值)
+     */
+    void begin(const cv::Size &size);
+
+    /**
+     * @brief 原地滤波第 y 行温度 (°C)，在转换循环中该行仍在缓存时调用
+     */
+    void filterRow(int y, float *t);
+
+    /**
+     * @brief 按帧间运动先验平移状态，移入的边缘区域重新初始化
+     */
+    void compensate(const FrameMotion &motion);
+
+    void reset();
+    const cv::Mat &state() const { return state_; }
+
+private:
+    float min_gain_;
+    float inv_motion_;
+    cv::Mat state_; // CV_32FC1, °C
+};
+
+#endif // TEMPORAL_DENOISE_H
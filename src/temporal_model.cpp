@@ -0,0 +1,111 @@
+// src/temporal_model.cpp
+#include "temporal_model.h"
+#include "temperature_conversion.h"
+#include <opencv2/core/hal/intrin.hpp>
+#include <iostream>
+
+namespace
+{
+    // 状态平面中未初始化像素 (首帧或运动补偿移入的边缘) 的标记值
+    const float UNINITIALIZED_TEMPERATURE = -1000.0f;
+    const float UNINITIALIZED_THRESHOLD = -500.0f;
+
+    void updateRow(const float *t, float *e, float *s, uchar *m, int n,
+                   float a, float b, float inv_dt, float rate_threshold, float min_temperature)
+    {
+        int x = 0;
+#if CV_SIMD
+        const int VL = cv::VTraits<cv::v_float32>::vlanes();
+        const cv::v_float32 va = cv::vx_setall_f32(a);
+        const cv::v_float32 vb = cv::vx_setall_f32(b);
+        const cv::v_float32 vinv = cv::vx_setall_f32(inv_dt);
+        const cv::v_float32 vrate = cv::vx_setall_f32(rate_threshold);
+        const cv::v_float32 vmin = cv::vx_setall_f32(min_temperature);
+        const cv::v_float32 vuninit = cv::vx_setall_f32(UNINITIALIZED_THRESHOLD);
+        const cv::v_float32 vzero = cv::vx_setzero_f32();
+
+        auto step = [&](int i) -> cv::v_uint32
+        {
+            cv::v_float32 vt = cv::vx_load(t + i);
+            cv::v_float32 ve = cv::vx_load(e + i);
+            cv::v_float32 vs = cv::vx_load(s + i);
+            cv::v_float32 fresh = cv::v_lt(ve, vuninit);
+            ve = cv::v_select(fresh, vt, ve);
+            cv::v_float32 de = cv::v_mul(va, cv::v_sub(vt, ve));
+            ve = cv::v_add(ve, de);
+            vs = cv::v_select(fresh, vzero, cv::v_fma(vb, cv::v_sub(cv::v_mul(de, vinv), vs), vs));
+            cv::v_store(e + i, ve);
+            cv::v_store(s + i, vs);
+            return cv::v_reinterpret_as_u32(cv::v_and(cv::v_gt(vs, vrate), cv::v_gt(vt, vmin)));
+        };
+
+        // 每次处理 4 个 float 向量，正好打包成一个 uint8 掩码向量
+        for (; x <= n - 4 * VL; x += 4 * VL)
+        {
+            cv::v_uint32 m0 = step(x);
+            cv::v_uint32 m1 = step(x + VL);
+            cv::v_uint32 m2 = step(x + 2 * VL);
+            cv::v_uint32 m3 = step(x + 3 * VL);
+            cv::v_store(m + x, cv::v_pack_b(m0, m1, m2, m3));
+        }
+#endif
+        for (; x < n; ++x)
+        {
+            float ve = e[x];
+            bool fresh = ve < UNINITIALIZED_THRESHOLD;
+            if (fresh)
+                ve = t[x];
+            float de = a * (t[x] - ve);
+            e[x] = ve + de;
+            s[x] = fresh ? 0.0f : s[x] + b * (de * inv_dt - s[x]);
+            m[x] = (s[x] > rate_threshold && t[x] > min_temperature) ? 255 : 0;
+        }
+    }
+}
+
+RateOfRiseModel::RateOfRiseModel(float ema_alpha, float slope_alpha)
+    : ema_alpha_(ema_alpha), slope_alpha_(slope_alpha)
+{
+}
+
+void RateOfRiseModel::reset()
+{
+    ema_.release();
+    slope_.release();
+}
+
+void RateOfRiseModel::update(const cv::Mat &temp_matrix,
+                             float dt_seconds,
+                             cv::Mat &rising_mask,
+                             const FrameMotion *motion,
+                             float rate_threshold,
+                             float min_temperature)
+{
+    if (!isTemperatureMatrix(temp_matrix))
+    {
+        std::cerr << "Error: Rate-of-rise model input must be CV_32FC1 or CV_16SC1." << std::endl;
+        return;
+    }
+
+    if (ema_.size() != temp_matrix.size())
+    {
+        ema_.create(temp_matrix.size(), CV_32FC1);
+        ema_.setTo(cv::Scalar(UNINITIALIZED_TEMPERATURE));
+        slope_ = cv::Mat::zeros(temp_matrix.size(), CV_32FC1);
+    }
+    else if (motion)
+    {
+        shiftStatePlane(ema_, *motion, cv::Scalar(UNINITIALIZED_TEMPERATURE));
+        shiftStatePlane(slope_, *motion, cv::Scalar(0.0));
+    }
+
+    rising_mask.create(temp_matrix.size(), CV_8UC1);
+    const float inv_dt = dt_seconds > 1e-3f ? 1.0f / dt_seconds : 0.0f;
+    std::vector<float> row_scratch;
+
+    for (int y = 0; y < temp_matrix.rows; ++y)
+    {
+        updateRow(temperatureRow(temp_matrix, y, row_scratch), ema_.ptr<float>(y), slope_.ptr<float>(y), rising_mask.ptr<uchar>(y),
+                  temp_matrix.cols, ema_alpha_, slope_alpha_, inv_dt, rate_threshold, min_temperature);
+    }
+}
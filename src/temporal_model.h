@@ -0,0 +1,54 @@
+// src/temporal_model.h
+#ifndef TEMPORAL_MODEL_H
+#define TEMPORAL_MODEL_H
+
+#include "utils.h"
+#include "ego_motion.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+// --- 逐像素升温速率模型 ---
+// 每个像素维护两个状态：温度指数滑动平均 (EMA) 和升温速率 (°C/s) 的平滑估计。
+// 每帧用 SIMD 原地更新一次，同时输出升温速率超过阈值的候选掩码，
+// 使低于绝对温度阈值但快速升温的早期火源也能进入热点检测。
+// 内存与计算量固定：每像素 2 个 float 状态，每帧一次遍历。
+
+class RateOfRiseModel
+{
+public:
+    /**
+     * @param ema_alpha 温度 EMA 系数 (0,1]，越大越跟随当前帧
+     * @param slope_alpha 速率平滑系数 (0,1]
+     */
+    explicit RateOfRiseModel(float ema_alpha = TEMPORAL_EMA_ALPHA, float slope_alpha = TEMPORAL_SLOPE_ALPHA);
+
+    /**
+     * @brief 用当前帧更新模型并输出升温候选掩码
+     *
+     * @param temp_matrix 当前帧温度矩阵 (CV_32FC1)
+     * @param dt_seconds 距上一帧的时间间隔
+     * @param rising_mask 输出 CV_8UC1 掩码：速率 > rate_threshold 且温度 > min_temperature 为 255
+     * @param motion 可选帧间运动，非空时先把状态平移到当前帧坐标
+     * @param rate_threshold 升温速率阈值 (°C/s)
+     * @param min_temperature 参与速率判定的最低温度，过滤环境温度附近的噪声
+     */
+    void update(const cv::Mat &temp_matrix,
+                float dt_seconds,
+                cv::Mat &rising_mask,
+                const FrameMotion *motion = nullptr,
+                float rate_threshold = RATE_OF_RISE_THRESHOLD_C_PER_SECOND,
+                float min_temperature = RATE_OF_RISE_MIN_TEMPERATURE_CELSIUS);
+
+    const cv::Mat &smoothedTemperature() const { return ema_; }
+    const cv::Mat &riseRate() const { return slope_; }
+
+    void reset();
+
+private:
+    float ema_alpha_;
+    float slope_alpha_;
+    cv::Mat ema_;   // CV_32FC1
+    cv::Mat slope_; // CV_32FC1, °C/s
+};
+
+#endif // TEMPORAL_MODEL_H
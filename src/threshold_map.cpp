@@ -0,0 +1,137 @@
+// src/threshold_map.cpp
+#include "threshold_map.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    const double KELVIN_OFFSET = 273.15;
+
+    double radiance(double celsius)
+    {
+        return std::pow(std::max(celsius + KELVIN_OFFSET, 1.0), static_cast<double>(THRESHOLD_MAP_RADIANCE_EXPONENT));
+    }
+
+    double radianceToCelsius(double value)
+    {
+        return std::pow(std::max(value, 0.0), 1.0 / THRESHOLD_MAP_RADIANCE_EXPONENT) - KELVIN_OFFSET;
+    }
+
+    // 斜距 slant_range 处、像素足迹为 footprint 米时火焰对像素辐亮度的权重
+    double radianceWeight(double slant_range, double footprint, const ThresholdMapConfig &config)
+    {
+        const double transmission = std::exp(-config.atmospheric_extinction_per_meter * slant_range);
+        const double coverage = config.reference_flame_size_meters / std::max(footprint, 1e-6);
+        const double fill = std::min(1.0, coverage * coverage);
+        return config.flame_emissivity / std::max(config.camera_emissivity, 1e-3f) * transmission * fill;
+    }
+}
+
+bool loadThresholdMapConfig(const std::string &filename, ThresholdMapConfig &config)
+{
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    if (fs["threshold_map_enabled"].isInt())
+        config.enabled = static_cast<int>(fs["threshold_map_enabled"]) != 0;
+    else
+        std::cout << "Warning: threshold_map_enabled not found in " << filename << std::endl;
+    if (fs["atmospheric_extinction_per_meter"].isReal())
+        fs["atmospheric_extinction_per_meter"] >> config.atmospheric_extinction_per_meter;
+    if (fs["flame_emissivity"].isReal())
+        fs["flame_emissivity"] >> config.flame_emissivity;
+    if (fs["camera_emissivity"].isReal())
+        fs["camera_emissivity"] >> config.camera_emissivity;
+    if (fs["reference_flame_size_meters"].isReal())
+        fs["reference_flame_size_meters"] >> config.reference_flame_size_meters;
+    if (fs["ambient_temperature_celsius"].isReal())
+        fs["ambient_temperature_celsius"] >> config.ambient_temperature_celsius;
+    if (fs["threshold_reference_range_meters"].isReal())
+        fs["threshold_reference_range_meters"] >> config.reference_range_meters;
+    fs.release();
+    return true;
+}
+
+void ThresholdMapBuilder::configure(const cv::Mat &camera_matrix, const cv::Size &image_size, const ThresholdMapConfig &config)
+{
+    config_ = config;
+    image_size_ = image_size;
+    const double fx = camera_matrix.at<double>(0, 0), fy = camera_matrix.at<double>(1, 1);
+    const double cx = camera_matrix.at<double>(0, 2), cy = camera_matrix.at<double>(1, 2);
+    focal_ = 0.5 * (fx + fy);
+    ambient_radiance_ = radiance(config.ambient_temperature_celsius);
+    base_threshold_ = -1.0f;
+    slant_table_.clear();
+
+    // 深度 Z 为光轴方向分量，斜距 = Z * |(x', y', 1)|
+    ray_norm_.create(image_size, CV_32FC1);
+    for (int y = 0; y < image_size.height; ++y)
+    {
+        float *n = ray_norm_.ptr<float>(y);
+        const double ry = (y - cy) / fy;
+        for (int x = 0; x < image_size.width; ++x)
+        {
+            const double rx = (x - cx) / fx;
+            n[x] = static_cast<float>(std::sqrt(rx * rx + ry * ry + 1.0));
+        }
+    }
+    double max_norm;
+    cv::minMaxLoc(ray_norm_, nullptr, &max_norm);
+    max_ray_norm_ = static_cast<float>(max_norm);
+}
+
+double ThresholdMapBuilder::apparentThreshold(double slant_range) const
+{
+    const double w = radianceWeight(slant_range, slant_range / focal_, config_);
+    const double apparent = radianceToCelsius(w * flame_radiance_ + (1.0 - w) * ambient_radiance_);
+    return std::min(std::max(apparent, static_cast<double>(THRESHOLD_MAP_MIN_CELSIUS)), static_cast<double>(THRESHOLD_MAP_MAX_CELSIUS));
+}
+
+void ThresholdMapBuilder::extendTable(float max_slant_range)
+{
+    const size_t needed = static_cast<size_t>(std::ceil(max_slant_range / THRESHOLD_MAP_RANGE_STEP_METERS)) + 2;
+    for (size_t i = slant_table_.size(); i < needed; ++i)
+        slant_table_.push_back(static_cast<float>(apparentThreshold(i * THRESHOLD_MAP_RANGE_STEP_METERS)));
+}
+
+void ThresholdMapBuilder::build(const RangeProvider &range_provider, float base_threshold, cv::Mat &threshold_map)
+{
+    if (base_threshold != base_threshold_)
+    {
+        // 参考距离 (视场中心) 处的表观阈值反推火焰真实辐亮度
+        const double w_ref = radianceWeight(config_.reference_range_meters, config_.reference_range_meters / focal_, config_);
+        flame_radiance_ = (radiance(base_threshold) - (1.0 - w_ref) * ambient_radiance_) / std::max(w_ref, 1e-6);
+        base_threshold_ = base_threshold;
+        slant_table_.clear();
+    }
+
+    range_provider.depthMap(image_size_, depth_);
+    double max_depth;
+    cv::minMaxLoc(depth_, nullptr, &max_depth);
+    const float max_slant = static_cast<float>(max_depth) * max_ray_norm_;
+    extendTable(max_slant > 0.0f ? std::min(max_slant, THRESHOLD_MAP_MAX_RANGE_METERS) : 0.0f);
+
+    // 斜距超出表范围时取最后一项 (远处阈值已趋于截断下限)；无效深度取第一项
+    const float inv_step = 1.0f / THRESHOLD_MAP_RANGE_STEP_METERS;
+    const float last_index = static_cast<float>(slant_table_.size() - 2);
+    threshold_map.create(image_size_, CV_32FC1);
+    for (int y = 0; y < image_size_.height; ++y)
+    {
+        const float *d = depth_.ptr<float>(y);
+        const float *n = ray_norm_.ptr<float>(y);
+        float *t = threshold_map.ptr<float>(y);
+        for (int x = 0; x < image_size_.width; ++x)
+        {
+            const float steps = d[x] * n[x] * inv_step;
+            const float position = steps > 0.0f ? std::min(steps, last_index) : 0.0f;
+            const int i = static_cast<int>(position);
+            const float frac = position - i;
+            t[x] = slant_table_[i] + frac * (slant_table_[i + 1] - slant_table_[i]);
+        }
+    }
+}
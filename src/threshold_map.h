@@ -0,0 +1,83 @@
+// src/threshold_map.h
+#ifndef THRESHOLD_MAP_H
+#define THRESHOLD_MAP_H
+
+#include "range_estimation.h"
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 随距离变化的逐像素温度阈值 ---
+// 远处火源经大气衰减、且可能只占像素的一部分，测得的表观温度低于真实温度。
+// 阈值图假设 FIRE_TEMPERATURE_THRESHOLD_CELSIUS 是在参考距离处整定的表观温度，
+// 先反推对应的火焰真实温度，再计算同一火焰在每个像素 (由距离模型给出斜距) 处的表观温度：
+//
+//   w(d) = (火焰发射率 / 相机发射率) * exp(-消光系数 * d) * min(1, (火焰尺寸 / 像素足迹)^2)
+//   L(T) = (T + 273.15)^n
+//   T_app(d) = L^-1( w(d) * L(T_flame) + (1 - w(d)) * L(T_ambient) )
+//
+// 结果截断到 [THRESHOLD_MAP_MIN_CELSIUS, THRESHOLD_MAP_MAX_CELSIUS]。
+// T_app 只依赖斜距，按 THRESHOLD_MAP_RANGE_STEP_METERS 间隔预先制表；逐像素的视线长度 |(x', y', 1)| 也只算一次。
+// 距离模型随俯仰角变化时重建阈值图只需每像素一次乘法 (深度 * 视线长度) 和一次查表插值。
+// 检测时在候选掩码的 SIMD 遍历中逐像素比较，代价与标量阈值相同。
+
+struct ThresholdMapConfig
+{
+    bool enabled = false;
+    float atmospheric_extinction_per_meter = 0.01f;
+    float flame_emissivity = 0.9f;
+    float camera_emissivity = 0.95f;          // 相机测温设置的发射率
+    float reference_flame_size_meters = 0.3f; // 需要检出的最小火焰尺寸
+    float ambient_temperature_celsius = 20.0f;
+    float reference_range_meters = ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS; // 标量阈值的整定距离
+};
+
+/**
+ * @brief 从参数文件读取阈值图配置
+ *
+ * @param filename 参数文件路径
+ * @param config 输出配置，缺失项保持默认值
+ * @return 文件打开成功返回 true
+ */
+bool loadThresholdMapConfig(const std::string &filename, ThresholdMapConfig &config);
+
+class ThresholdMapBuilder
+{
+public:
+    /**
+     * @brief 设置相机与大气参数，计算逐像素视线长度；清空斜距表
+     *
+     * @param camera_matrix 相机内参矩阵
+     * @param image_size 温度矩阵尺寸
+     * @param config 大气与发射率参数
+     */
+    void configure(const cv::Mat &camera_matrix, const cv::Size &image_size, const ThresholdMapConfig &config);
+
+    /**
+     * @brief 计算逐像素温度阈值图
+     *
+     * @param range_provider 距离模型 (使用其当前深度图)
+     * @param base_threshold 参考距离处的表观温度阈值，变化时重新制表
+     * @param threshold_map 输出 CV_32FC1 阈值图
+     */
+    void build(const RangeProvider &range_provider, float base_threshold, cv::Mat &threshold_map);
+
+private:
+    double apparentThreshold(double slant_range) const;
+    void extendTable(float max_slant_range);
+
+    ThresholdMapConfig config_;
+    cv::Size image_size_;
+    double focal_ = 1.0;
+    double ambient_radiance_ = 0.0;
+    double flame_radiance_ = 0.0;
+    float base_threshold_ = -1.0f;
+    cv::Mat ray_norm_;                  // CV_32FC1 逐像素斜距/深度比
+    float max_ray_norm_ = 1.0f;
+    std::vector<float> slant_table_;    // 第 i 项为斜距 i * THRESHOLD_MAP_RANGE_STEP_METERS 处的表观阈值
+    cv::Mat depth_;
+};
+
+#endif // THRESHOLD_MAP_H
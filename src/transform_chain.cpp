@@ -0,0 +1,195 @@
+// src/transform_chain.cpp
+#include "transform_chain.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+    // 相机光学坐标系 (X右, Y下, Z前) 到机器人坐标系 (X前, Y左, Z上) 的轴置换
+    const cv::Matx33d OPTICAL_TO_BODY(0.0, 0.0, 1.0,
+                                      -1.0, 0.0, 0.0,
+                                      0.0, -1.0, 0.0);
+
+    bool readVec3(const cv::FileStorage &fs, const std::string &key, cv::Vec3d &out)
+    {
+        cv::Mat m;
+        fs[key] >> m;
+        if (m.empty() || m.total() != 3)
+        {
+            std::cout << "Warning: " << key << " not found or not 3 elements, using zero." << std::endl;
+            return false;
+        }
+        m.convertTo(m, CV_64F);
+        out = cv::Vec3d(m.at<double>(0), m.at<double>(1), m.at<double>(2));
+        return true;
+    }
+}
+
+RigidTransform RigidTransform::operator*(const RigidTransform &other) const
+{
+    return RigidTransform(R * other.R, R * other.t + t);
+}
+
+cv::Vec3d RigidTransform::apply(const cv::Vec3d &p) const
+{
+    return R * p + t;
+}
+
+RigidTransform RigidTransform::fromYawPitchRoll(double yaw_deg, double pitch_deg, double roll_deg,
+                                                const cv::Vec3d &translation)
+{
+    const double k = CV_PI / 180.0;
+    double cy = std::cos(yaw_deg * k), sy = std::sin(yaw_deg * k);
+    double cp = std::cos(pitch_deg * k), sp = std::sin(pitch_deg * k);
+    double cr = std::cos(roll_deg * k), sr = std::sin(roll_deg * k);
+
+    cv::Matx33d Rz(cy, -sy, 0.0,
+                   sy, cy, 0.0,
+                   0.0, 0.0, 1.0);
+    cv::Matx33d Ry(cp, 0.0, sp,
+                   0.0, 1.0, 0.0,
+                   -sp, 0.0, cp);
+    cv::Matx33d Rx(1.0, 0.0, 0.0,
+                   0.0, cr, -sr,
+                   0.0, sr, cr);
+    return RigidTransform(Rz * Ry * Rx, translation);
+}
+
+TransformChain::TransformChain()
+    : inv_intrinsics_(cv::Matx33d::eye()),
+      camera_to_gimbal_(OPTICAL_TO_BODY, cv::Vec3d(0.0, 0.0, 0.0)),
+      pixel_to_world_rotation_(cv::Matx33d::eye()),
+      dirty_(true)
+{
+}
+
+void TransformChain::setIntrinsics(const cv::Mat &camera_matrix)
+{
+    if (camera_matrix.empty() || camera_matrix.at<double>(0, 0) == 0 || camera_matrix.at<double>(1, 1) == 0)
+    {
+        std::cerr << "Error: Invalid camera matrix for transform chain." << std::endl;
+        return;
+    }
+    double fx = camera_matrix.at<double>(0, 0);
+    double fy = camera_matrix.at<double>(1, 1);
+    double cx = camera_matrix.at<double>(0, 2);
+    double cy = camera_matrix.at<double>(1, 2);
+    inv_intrinsics_ = cv::Matx33d(1.0 / fx, 0.0, -cx / fx,
+                                  0.0, 1.0 / fy, -cy / fy,
+                                  0.0, 0.0, 1.0);
+    dirty_ = true;
+}
+
+void TransformChain::setCameraToGimbal(const RigidTransform &camera_to_gimbal)
+{
+    camera_to_gimbal_ = camera_to_gimbal;
+    dirty_ = true;
+}
+
+void TransformChain::setGimbalMount(const RigidTransform &gimbal_mount_in_base)
+{
+    gimbal_mount_ = gimbal_mount_in_base;
+    dirty_ = true;
+}
+
+void TransformChain::setGimbalAngles(float azimuth_degrees, float pitch_degrees)
+{
+    // 回转角向右为正 => 绕 Z(向上) 轴负方向旋转；俯仰角向下为正 => 绕 Y(向左) 轴正方向旋转
+    gimbal_rotation_ = RigidTransform::fromYawPitchRoll(-azimuth_degrees, pitch_degrees, 0.0);
+    dirty_ = true;
+}
+
+void TransformChain::setOdometry(double x_meters, double y_meters, double yaw_degrees)
+{
+    base_to_world_ = RigidTransform::fromYawPitchRoll(yaw_degrees, 0.0, 0.0, cv::Vec3d(x_meters, y_meters, 0.0));
+    dirty_ = true;
+}
+
+void TransformChain::recompose()
+{
+    camera_to_world_ = base_to_world_ * gimbal_mount_ * gimbal_rotation_ * camera_to_gimbal_;
+    pixel_to_world_rotation_ = camera_to_world_.R * inv_intrinsics_;
+    dirty_ = false;
+}
+
+const RigidTransform &TransformChain::cameraToWorld()
+{
+    if (dirty_)
+        recompose();
+    return camera_to_world_;
+}
+
+void TransformChain::projectToWorld(const std::vector<cv::Point2f> &pixels,
+                                   const std::vector<float> &depths,
+                                   std::vector<cv::Point3f> &world_points)
+{
+    if (dirty_)
+        recompose();
+
+    const size_t n = std::min(pixels.size(), depths.size());
+    world_points.resize(n);
+
+    // world = depth * (R * K^-1) * [u, v, 1]^T + t
+    const cv::Matx33d &A = pixel_to_world_rotation_;
+    const cv::Vec3d &t = camera_to_world_.t;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double d = depths[i];
+        if (d <= 0.0)
+        {
+            world_points[i] = cv::Point3f(0.0f, 0.0f, 0.0f);
+            continue;
+        }
+        const double u = pixels[i].x;
+        const double v = pixels[i].y;
+        world_points[i].x = static_cast<float>(d * (A(0, 0) * u + A(0, 1) * v + A(0, 2)) + t[0]);
+        world_points[i].y = static_cast<float>(d * (A(1, 0) * u + A(1, 1) * v + A(1, 2)) + t[1]);
+        world_points[i].z = static_cast<float>(d * (A(2, 0) * u + A(2, 1) * v + A(2, 2)) + t[2]);
+    }
+}
+
+void TransformChain::projectHotspots(std::vector<HotSpot> &hot_spots)
+{
+    std::vector<cv::Point2f> pixels;
+    std::vector<float> depths;
+    pixels.reserve(hot_spots.size());
+    depths.reserve(hot_spots.size());
+    for (const auto &spot : hot_spots)
+    {
+        pixels.push_back(spot.pixel_centroid);
+        depths.push_back(spot.range_meters);
+    }
+
+    std::vector<cv::Point3f> world_points;
+    projectToWorld(pixels, depths, world_points);
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+        hot_spots[i].world_frame_position = world_points[i];
+}
+
+bool loadTransformChainParameters(const std::string &filename,
+                                  const cv::Mat &camera_matrix,
+                                  TransformChain &chain)
+{
+    chain.setIntrinsics(camera_matrix);
+
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        std::cerr << "Using identity extrinsics for transform chain." << std::endl;
+        return false;
+    }
+
+    cv::Vec3d cam_t(0.0, 0.0, 0.0), cam_rpy(0.0, 0.0, 0.0), mount_t(0.0, 0.0, 0.0);
+    readVec3(fs, "camera_to_gimbal_translation", cam_t);
+    readVec3(fs, "camera_to_gimbal_rpy_degrees", cam_rpy);
+    readVec3(fs, "gimbal_to_base_translation", mount_t);
+    fs.release();
+
+    // 标定得到的小角度安装误差叠加在光学->机体轴置换之后
+    RigidTransform mount_error = RigidTransform::fromYawPitchRoll(cam_rpy[2], cam_rpy[1], cam_rpy[0], cam_t);
+    chain.setCameraToGimbal(mount_error * RigidTransform(OPTICAL_TO_BODY, cv::Vec3d(0.0, 0.0, 0.0)));
+    chain.setGimbalMount(RigidTransform(cv::Matx33d::eye(), mount_t));
+    return true;
+}
@@ -0,0 +1,100 @@
+// src/transform_chain.h
+#ifndef TRANSFORM_CHAIN_H
+#define TRANSFORM_CHAIN_H
+
+#include "utils.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include <vector>
+
+// --- 坐标变换链 ---
+// 相机(像素) -> 云台 -> 机器人底盘 -> 世界(里程计) 的 SE(3) 变换链。
+//
+// 坐标系约定：
+//   相机坐标系：OpenCV 约定，X 向右、Y 向下、Z 沿光轴向前
+//   云台/底盘/世界坐标系：X 向前、Y 向左、Z 向上
+//   云台角度：与 calculateGimbalAngles 一致，回转角向右为正，俯仰角向下为正
+
+/**
+ * @brief 刚体变换 (旋转 + 平移)，p_dst = R * p_src + t
+ */
+struct RigidTransform
+{
+    cv::Matx33d R;
+    cv::Vec3d t;
+
+    RigidTransform() : R(cv::Matx33d::eye()), t(0.0, 0.0, 0.0) {}
+    RigidTransform(const cv::Matx33d &rotation, const cv::Vec3d &translation) : R(rotation), t(translation) {}
+
+    // 复合变换：(*this) * other 表示先施加 other 再施加 *this
+    RigidTransform operator*(const RigidTransform &other) const;
+    cv::Vec3d apply(const cv::Vec3d &p) const;
+
+    // 按 Z-Y-X (yaw-pitch-roll) 顺序由欧拉角(度)构造
+    static RigidTransform fromYawPitchRoll(double yaw_deg, double pitch_deg, double roll_deg,
+                                           const cv::Vec3d &translation = cv::Vec3d(0.0, 0.0, 0.0));
+};
+
+/**
+ * @brief 缓存的相机到世界坐标变换链
+ *
+ * 各环节在其输入变化时标记失效，cameraToWorld() 每帧最多重新复合一次；
+ * projectToWorld() 将内参的逆与旋转预先合并，一次调用批量投影全部热点射线。
+ */
+class TransformChain
+{
+public:
+    TransformChain();
+
+    void setIntrinsics(const cv::Mat &camera_matrix);
+    void setCameraToGimbal(const RigidTransform &camera_to_gimbal);
+    void setGimbalMount(const RigidTransform &gimbal_mount_in_base);
+    void setGimbalAngles(float azimuth_degrees, float pitch_degrees);
+    void setOdometry(double x_meters, double y_meters, double yaw_degrees);
+
+    const RigidTransform &cameraToWorld();
+
+    /**
+     * @brief 批量将像素射线投影到世界坐标系
+     *
+     * @param pixels 像素坐标
+     * @param depths 对应像素在相机坐标系下的深度 Z (米)，<=0 的点输出为 (0,0,0)
+     * @param world_points 输出的世界坐标
+     */
+    void projectToWorld(const std::vector<cv::Point2f> &pixels,
+                        const std::vector<float> &depths,
+                        std::vector<cv::Point3f> &world_points);
+
+    // 便捷接口：用热点质心和 range_meters 填充 world_frame_position
+    void projectHotspots(std::vector<HotSpot> &hot_spots);
+
+private:
+    void recompose();
+
+    cv::Matx33d inv_intrinsics_;
+    RigidTransform camera_to_gimbal_;
+    RigidTransform gimbal_mount_;
+    RigidTransform gimbal_rotation_;
+    RigidTransform base_to_world_;
+
+    RigidTransform camera_to_world_;
+    cv::Matx33d pixel_to_world_rotation_; // camera_to_world.R * K^-1
+    bool dirty_;
+};
+
+/**
+ * @brief 从参数文件加载变换链外参
+ *
+ * @param filename 参数文件路径
+ * @param camera_matrix 相机内参矩阵
+ * @param chain 输出的变换链
+ * @return 成功打开文件返回 true；缺失的外参使用单位变换并输出警告
+ *
+ * 读取 camera_to_gimbal_translation / camera_to_gimbal_rpy_degrees / gimbal_to_base_translation。
+ */
+bool loadTransformChainParameters(const std::string &filename,
+                                  const cv::Mat &camera_matrix,
+                                  TransformChain &chain);
+
+#endif // TRANSFORM_CHAIN_H
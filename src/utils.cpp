@@ -0,0 +1,46 @@
+// src/utils.cpp
+// utils.h 中声明的辅助函数实现
+#include "utils.h"
+#include <cfloat>
+
+/**
+ * @brief 将像素坐标转换为近似的世界坐标
+ *
+ * @param pixel_coord 像素坐标
+ * @param cam_matrix 相机内参矩阵
+ * @param distance_to_plane 到平面的距离
+ * @return 返回近似的世界坐标
+ *
+ * 此函数根据相机内参和像素坐标，计算出近似的世界坐标。如果相机内参为空或焦距为0，则直接返回像素坐标。
+ */
+cv::Point3f pixelToApproxWorld(const cv::Point2f &pixel_coord, const cv::Mat &cam_matrix, float distance_to_plane)
+{
+    if (cam_matrix.empty() || cam_matrix.at<double>(0, 0) == 0)
+    {
+        return cv::Point3f(pixel_coord.x, pixel_coord.y, 0.0f);
+    }
+    double fx = cam_matrix.at<double>(0, 0);
+    double fy = cam_matrix.at<double>(1, 1);
+    double cx = cam_matrix.at<double>(0, 2);
+    double cy = cam_matrix.at<double>(1, 2);
+
+    double X = (pixel_coord.x - cx) * distance_to_plane / fx;
+    double Y = (pixel_coord.y - cy) * distance_to_plane / fy;
+    return cv::Point3f(static_cast<float>(X), static_cast<float>(Y), distance_to_plane);
+}
+
+/**
+ * @brief 算两点在真实世界中的距离
+ *
+ * @param p1 第一个点的世界坐标
+ * @param p2 第二个点的世界坐标
+ * @return 返回两点之间的距离，如果任一点的z坐标为0，则返回最大浮点数
+ *
+ * 此函数计算两个三维点在真实世界中的欧氏距离。如果任一点的z坐标为0，则表示该点无效，函数返回最大浮点数。
+ */
+float calculateRealWorldDistance(const cv::Point3f &p1, const cv::Point3f &p2)
+{
+    if (p1.z == 0.0f || p2.z == 0.0f)
+        return FLT_MAX;
+    return std::sqrt(std::pow(p1.x - p2.x, 2) + std::pow(p1.y - p2.y, 2) + std::pow(p1.z - p2.z, 2));
+}
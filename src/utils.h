@@ -2,7 +2,8 @@
 #ifndef UTILS_H
 #define UTILS_H
 
-#include <opencv2/opencv.hpp>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 #include <vector>
 #include <string>
 #include <cmath> // For fmod if needed for angle normalization
@@ -10,8 +11,44 @@
 // --- 配置参数 ---
 const float FIRE_TEMPERATURE_THRESHOLD_CELSIUS = 250.0f;
 const double MIN_HOTSPOT_AREA_PIXELS = 30.0;
+const int MORPHOLOGY_KERNEL_SIZE = 5;                      // 候选掩码开/闭运算的椭圆核边长
+const int MAX_CONTOURS_EXAMINED = 256;                     // 每帧做温度统计/拆分的轮廓数上限 (超出时保留面积最大的)
+const int MAX_HOTSPOTS_KEPT = 64;                          // 每帧输出的热点数上限 (超出时淘汰严重度最低的)
 const float MAX_GROUPING_DISTANCE_METERS = 1.0f;
-const float ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS = 8.0f; // !!! 强假设 !!!
+const float ASSUMED_DISTANCE_TO_FIRE_PLANE_METERS = 8.0f; // 仅作为 FixedRangeProvider 的默认距离 (见 range_estimation.h)
+const float GROUND_PLANE_PITCH_TOLERANCE_DEGREES = 0.1f;   // 云台俯仰角变化超过该值时重建地平面深度表与阈值图
+const float RATE_OF_RISE_THRESHOLD_C_PER_SECOND = 5.0f;   // 升温速率阈值，超过即作为候选热点
+const float RATE_OF_RISE_MIN_TEMPERATURE_CELSIUS = 60.0f;  // 升温速率判定的最低温度
+const float RATE_OF_RISE_PROJECTION_SECONDS = 10.0f;       // 严重度按该时间后的预测温度计算
+const float TEMPORAL_EMA_ALPHA = 0.3f;                     // 逐像素温度 EMA 系数
+const float TEMPORAL_SLOPE_ALPHA = 0.2f;                   // 逐像素升温速率平滑系数
+const float TEMPORAL_DENOISE_MIN_GAIN = 0.3f;              // 时域降噪：静止像素的 IIR 增益
+const float TEMPORAL_DENOISE_MOTION_CELSIUS = 10.0f;       // 时域降噪：帧差达到该值时直接跟随当前帧
+const int REGION_TRACKING_DISCOVERY_INTERVAL_FRAMES = 10;  // 区域跟踪检测：每隔该帧数强制整帧检测
+const int REGION_TRACKING_MARGIN_PIXELS = 8;               // 区域跟踪检测：上一帧热点外接矩形的外扩量
+const float EGO_MOTION_BUDGET_MS = 1.0f;                   // 自运动估计的单帧耗时预算 (stress_detection 检查)
+const float BACKGROUND_LEARNING_RATE = 0.005f;             // 背景温度学习率 (每帧)
+const int BACKGROUND_WARMUP_FRAMES = 200;                  // 背景学习帧数不足时不做剔除
+const float BACKGROUND_STABLE_TOLERANCE_CELSIUS = 8.0f;    // 与背景差值及背景波动均小于该值视为稳定高温物体
+const int FLICKER_WINDOW_SAMPLES = 32;                     // 闪烁分析滑动窗口长度 (样本数)
+const float FLICKER_BAND_MIN_HZ = 1.0f;                    // 火焰闪烁频带下限
+const float FLICKER_BAND_MAX_HZ = 15.0f;                   // 火焰闪烁频带上限
+const float FLICKER_MIN_AMPLITUDE_CELSIUS = 3.0f;          // 温度波动标准差低于该值时按比例降低闪烁得分
+const float FLICKER_CONFIRM_SCORE = 0.3f;                  // 闪烁得分达到该值的目标确认为火焰
+const float BLOB_CLASSIFIER_CONFIRM_PROBABILITY = 0.8f;     // 分类器概率达到该值的目标也视为已确认
+const float UNCONFIRMED_AIM_TIMEOUT_SECONDS = 5.0f;        // 目标持续该时间仍未确认时，回退为瞄准最严重的未确认目标
+const double BLOB_CLASSIFIER_BUDGET_MICROSECONDS = 100.0;  // 每帧批量推理的时间预算
+const float THRESHOLD_MAP_MIN_CELSIUS = 100.0f;            // 逐像素阈值图下限 (远处火源)
+const float THRESHOLD_MAP_MAX_CELSIUS = 400.0f;            // 逐像素阈值图上限 (近处火源)
+const float THRESHOLD_MAP_RADIANCE_EXPONENT = 4.0f;        // 辐亮度 ~ T^n 的近似指数 (热力学温度)
+const float THRESHOLD_MAP_RANGE_STEP_METERS = 0.05f;       // 表观阈值斜距表的采样间隔 (表项间线性插值)
+const float THRESHOLD_MAP_MAX_RANGE_METERS = 200.0f;       // 斜距表上限，更远的像素取表尾阈值
+const float MAX_TREE_STEP_CELSIUS = 1.0f;                  // 最大树温度量化步长
+const float FIRE_MAP_RESOLUTION_METERS = 0.1f;  // 火情地图栅格边长
+const size_t FIRE_MAP_MAX_TILES = 4096;          // 火情地图块数上限 (每块 16x16 栅格，约 3KB)
+const float FIRE_MAP_MAX_AGE_SECONDS = 30.0f;    // 规划时只考虑该时间内观测到的火情
+const float SPRAY_SUPPRESSION_RADIUS_METERS = 0.5f; // 喷射覆盖半径：控制器报告喷射完成后该半径内的栅格标记为已处置
+const float FIRE_REIGNITION_HOLD_SECONDS = 5.0f;    // 已处置栅格至少该时间未观测到火情后再次出现才计为复燃
 
 // --- 相机内参和FOV (理想情况下从 camera_params.xml 或专门的相机配置文件加载) ---
 extern cv::Mat CAMERA_MATRIX;
@@ -27,26 +64,42 @@ extern float NOZZLE_OFFSET_PITCH_DEGREES;   // 喷嘴相对相机的俯仰角偏
 // --- 结构体定义 ---
 struct HotSpot {
     int id;
+    int track_id; // 跨帧稳定的轨迹编号 (由 HotspotTracker 分配)，-1 表示未跟踪
     cv::Point2f pixel_centroid;
     cv::Point3f world_coord_approx;
+    cv::Point3f world_frame_position; // 世界坐标系 (里程计) 下的位置，由 TransformChain 填充
+    float range_meters; // 该热点使用的深度 (由 RangeProvider 给出)
     double area_pixels;
     float max_temperature;
+    float mean_temperature;
+    float temperature_stddev;
+    float rate_of_rise; // 区域内最大升温速率 (°C/s)，无时域模型时为 0
+    float flicker_score; // 火焰闪烁得分 [0,1] (由 HotspotTracker 填充)，-1 表示尚无法判定
+    float area_growth_rate; // 面积相对增长率 (1/s，由 HotspotTracker 填充)
+    float fire_probability; // 分类器给出的火焰概率 [0,1]，-1 表示未加载分类器
+    int zone_id; // 质心所在的测量区域下标 (ZoneMap)，-1 表示不在任何区域内
     std::vector<cv::Point> contour_pixels;
     bool grouped = false;
 
-    HotSpot() : id(-1), area_pixels(0.0), max_temperature(0.0f), grouped(false) {}
+    HotSpot() : id(-1), track_id(-1), range_meters(0.0f), area_pixels(0.0), max_temperature(0.0f), mean_temperature(0.0f), temperature_stddev(0.0f),
+                rate_of_rise(0.0f), flicker_score(-1.0f), area_growth_rate(0.0f), fire_probability(-1.0f), zone_id(-1), grouped(false) {}
 };
 
 struct SprayTarget {
     int id;
     cv::Point2f final_pixel_aim_point;
     cv::Point3f final_world_aim_point_approx;
+    cv::Point3f final_world_frame_aim_point; // 世界坐标系下的瞄准点
     std::vector<int> source_hotspot_ids;
     float estimated_severity;
+    bool confirmed; // 至少一个来源热点的闪烁得分或分类器概率达到确认阈值
 
-    SprayTarget() : id(-1), estimated_severity(0.0f) {}
+    SprayTarget() : id(-1), estimated_severity(0.0f), confirmed(false) {}
 
+    // 已确认的目标排在前面，其次按严重度降序
     bool operator<(const SprayTarget& other) const {
+        if (confirmed != other.confirmed)
+            return confirmed;
         return estimated_severity > other.estimated_severity;
     }
 };
@@ -2,63 +2,299 @@
 #include "vision_processing.h"
 #include <iostream>
 #include <algorithm>
+#include <climits>
 #include <cmath> // For std::abs, fmod
 
 // detectAndFilterHotspots, determineSprayTargets, visualizeResults 函数实现保持不变
 
+// 开运算去除孤立噪声点，闭运算填补火焰内部空洞。
+// mask 可以是子矩阵：BORDER_ISOLATED 保证不读取区域外 (未初始化) 的像素，整帧时与默认边界一致。
+static void cleanCandidateMask(cv::Mat &mask, int kernel_size)
+{
+    if (kernel_size <= 1)
+        return;
+    const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(kernel_size, kernel_size));
+    const int border = cv::BORDER_CONSTANT | cv::BORDER_ISOLATED;
+    cv::morphologyEx(mask, mask, cv::MORPH_OPEN, kernel, cv::Point(-1, -1), 1, border, cv::morphologyDefaultBorderValue());
+    cv::morphologyEx(mask, mask, cv::MORPH_CLOSE, kernel, cv::Point(-1, -1), 1, border, cv::morphologyDefaultBorderValue());
+}
+
+// 严重度：面积 x 预测温度。快速升温的火源按 RATE_OF_RISE_PROJECTION_SECONDS 后的温度计，
+// 因此 150°C 且快速升温的火源可以排在稳定的 260°C 排气管之前。
+// 再乘以闪烁权重：闪烁得分达到确认阈值为 1，完全不闪烁为 0.25，尚无法判定为 0.5；
+// 加载了分类器时再乘以火焰概率。
+static float hotspotSeverity(const HotSpot &spot)
+{
+    float projected_temperature = spot.max_temperature + spot.rate_of_rise * RATE_OF_RISE_PROJECTION_SECONDS;
+    float flicker_weight = 0.5f;
+    if (spot.flicker_score >= 0.0f)
+        flicker_weight = 0.25f + 0.75f * std::min(spot.flicker_score / FLICKER_CONFIRM_SCORE, 1.0f);
+    float classifier_weight = spot.fire_probability >= 0.0f ? spot.fire_probability : 1.0f;
+    return static_cast<float>(spot.area_pixels * projected_temperature * flicker_weight * classifier_weight);
+}
+
+// 闪烁得分或分类器概率任一达到阈值即确认为火焰
+static bool isConfirmedFire(const HotSpot &spot)
+{
+    return spot.flicker_score >= FLICKER_CONFIRM_SCORE || spot.fire_probability >= BLOB_CLASSIFIER_CONFIRM_PROBABILITY;
+}
+
+// 跟踪帧：只在已知区域内重新生长热点。区域外出现新的高温像素或热点扩展出区域时返回 false，由调用方整帧检测。
+// binary_mask 只有各区域内的像素有效，后续只在轮廓外接矩形内读取。
+static bool detectInTrackedRegions(const cv::Mat &temp_matrix,
+                                   const DetectionAuxInputs &aux_inputs,
+                                   cv::Mat &binary_mask,
+                                   std::vector<std::vector<cv::Point>> &contours)
+{
+    const RegionTracker *tracker = aux_inputs.region_tracker;
+    if (!tracker->trackingFrame() || aux_inputs.mask_inputs.zone_stats)
+        return false;
+
+    // 阈值图被截断在 THRESHOLD_MAP_MIN_CELSIUS 以上，用它作为保守的发现阈值
+    const cv::Size size = temp_matrix.size();
+    const bool has_threshold_map = aux_inputs.mask_inputs.threshold_map.size() == size;
+    const float discovery_threshold = has_threshold_map ? THRESHOLD_MAP_MIN_CELSIUS : aux_inputs.params.temperature_threshold;
+    if (hasHotPixelsOutside(temp_matrix, discovery_threshold, aux_inputs.mask_inputs, tracker->regions()))
+        return false;
+
+    binary_mask.create(size, CV_8UC1);
+    contours.clear();
+    std::vector<std::vector<cv::Point>> region_contours;
+    for (const auto &region : tracker->regions())
+    {
+        cv::Mat region_mask = binary_mask(region);
+        computeCandidateMask(temp_matrix(region), aux_inputs.params.temperature_threshold,
+                             cropCandidateMaskInputs(aux_inputs.mask_inputs, size, region), region_mask);
+        cleanCandidateMask(region_mask, aux_inputs.params.morphology_kernel_size);
+        cv::findContours(region_mask, region_contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, region.tl());
+        for (auto &contour : region_contours)
+        {
+            const cv::Rect box = cv::boundingRect(contour);
+            const bool touches_left = box.x <= region.x && region.x > 0;
+            const bool touches_top = box.y <= region.y && region.y > 0;
+            const bool touches_right = box.x + box.width >= region.x + region.width && region.x + region.width < size.width;
+            const bool touches_bottom = box.y + box.height >= region.y + region.height && region.y + region.height < size.height;
+            if (touches_left || touches_top || touches_right || touches_bottom)
+                return false;
+            contours.push_back(std::move(contour));
+        }
+    }
+    return true;
+}
+
 std::vector<HotSpot> detectAndFilterHotspots(
     const cv::Mat &temp_matrix,
     const cv::Mat &camera_matrix_param,
     float assumed_distance_to_fire_plane_param)
+{
+    FixedRangeProvider fixed_range(assumed_distance_to_fire_plane_param);
+    return detectAndFilterHotspots(temp_matrix, camera_matrix_param, fixed_range);
+}
+
+std::vector<HotSpot> detectAndFilterHotspots(
+    const cv::Mat &temp_matrix,
+    const cv::Mat &camera_matrix_param,
+    const RangeProvider &range_provider,
+    const DetectionAuxInputs &aux_inputs)
 {
     std::vector<HotSpot> detected_spots;
-    if (temp_matrix.empty() || temp_matrix.type() != CV_32FC1)
+    if (!isTemperatureMatrix(temp_matrix))
     {
-        std::cerr << "Error: Temperature matrix is empty or not CV_32FC1 type." << std::endl;
+        std::cerr << "Error: Temperature matrix is empty or not CV_32FC1/CV_16SC1 type." << std::endl;
         return detected_spots;
     }
 
+    // 温度阈值 (标量或逐像素阈值图)、升温候选、静态屏蔽和稳定背景剔除在一次遍历中完成；
+    // 跟踪帧中只在已知热点区域内进行，失败时退回整帧检测
+    DetectionStageTimes *times = aux_inputs.stage_times;
+    int64 stage_start = times ? cv::getTickCount() : 0;
+    auto stage_ms = [&]()
+    {
+        const int64 now = cv::getTickCount();
+        const double ms = (now - stage_start) * 1000.0 / cv::getTickFrequency();
+        stage_start = now;
+        return ms;
+    };
+    if (times)
+        *times = DetectionStageTimes();
+
     cv::Mat binary_mask;
-    cv::threshold(temp_matrix, binary_mask, FIRE_TEMPERATURE_THRESHOLD_CELSIUS, 255.0, cv::THRESH_BINARY);
-    binary_mask.convertTo(binary_mask, CV_8U);
+    std::vector<std::vector<cv::Point>> contours;
+    const bool full_discovery = !aux_inputs.region_tracker ||
+                                !detectInTrackedRegions(temp_matrix, aux_inputs, binary_mask, contours);
+    if (full_discovery)
+    {
+        // 跟踪帧失败后退回整帧检测时，失败的区域内检测耗时也计入候选掩码阶段
+        computeCandidateMask(temp_matrix, aux_inputs.params.temperature_threshold, aux_inputs.mask_inputs, binary_mask);
+        if (times)
+            times->mask_ms = stage_ms();
+        cleanCandidateMask(binary_mask, aux_inputs.params.morphology_kernel_size);
+        if (times)
+            times->morphology_ms = stage_ms();
+        cv::findContours(binary_mask, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+    }
+    else if (times)
+    {
+        times->mask_ms = stage_ms();
+    }
+
+    // 先按面积筛选；轮廓过多时只保留面积最大的 max_contours_examined 个，后续逐轮廓统计的总耗时因此有上界
+    std::vector<std::pair<double, size_t>> candidates;
+    for (size_t i = 0; i < contours.size(); ++i)
+    {
+        const double area = cv::contourArea(contours[i]);
+        if (area >= aux_inputs.params.min_area_pixels)
+            candidates.emplace_back(area, i);
+    }
+    const size_t max_examined = static_cast<size_t>(std::max(aux_inputs.params.max_contours_examined, 0));
+    if (candidates.size() > max_examined)
+    {
+        std::nth_element(candidates.begin(), candidates.begin() + max_examined, candidates.end(),
+                         [](const std::pair<double, size_t> &a, const std::pair<double, size_t> &b) { return a.first > b.first; });
+        candidates.resize(max_examined);
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const std::pair<double, size_t> &a, const std::pair<double, size_t> &b) { return a.second < b.second; });
+    }
+    if (times)
+    {
+        times->contours_ms = stage_ms();
+        times->contours_found = static_cast<int>(contours.size());
+        times->contours_examined = static_cast<int>(candidates.size());
+    }
 
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-    cv::morphologyEx(binary_mask, binary_mask, cv::MORPH_OPEN, kernel, cv::Point(-1, -1), 1);
-    cv::morphologyEx(binary_mask, binary_mask, cv::MORPH_CLOSE, kernel, cv::Point(-1, -1), 1);
+    const bool has_rise_rate = !aux_inputs.rise_rate.empty() && aux_inputs.rise_rate.size() == temp_matrix.size();
+    const cv::Mat &threshold_map = aux_inputs.mask_inputs.threshold_map;
+    const bool has_threshold_map = threshold_map.size() == temp_matrix.size() && isTemperatureMatrix(threshold_map);
+    // 定点矩阵的统计值按单位换算回摄氏度
+    const double unit = temperatureUnitCelsius(temp_matrix);
+    const cv::Mat &zone_ids = aux_inputs.mask_inputs.zone_ids;
+    const bool has_zones = zone_ids.size() == temp_matrix.size() && zone_ids.type() == CV_16UC1;
 
-    std::vector<std::vector<cv::Point>> contours;
-    cv::findContours(binary_mask.clone(), contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
 
     int spot_id_counter = 0;
-    for (const auto &contour : contours)
+    auto append_hotspot = [&](const std::vector<cv::Point> &contour, double area)
     {
-        double area = cv::contourArea(contour);
-        if (area < MIN_HOTSPOT_AREA_PIXELS)
-            continue;
-
         cv::Moments M = cv::moments(contour);
         if (M.m00 == 0)
-            continue;
+            return;
         cv::Point2f centroid(static_cast<float>(M.m10 / M.m00), static_cast<float>(M.m01 / M.m00));
 
+        // 只在外接矩形内生成区域掩码并统计，避免每个轮廓分配整帧掩码
         cv::Rect bounding_box = cv::boundingRect(contour);
-        cv::Mat spot_roi_mask = cv::Mat::zeros(temp_matrix.size(), CV_8U);
-        cv::drawContours(spot_roi_mask, std::vector<std::vector<cv::Point>>{contour}, -1, cv::Scalar(255), cv::FILLED);
+        cv::Mat spot_roi_mask = cv::Mat::zeros(bounding_box.size(), CV_8U);
+        cv::drawContours(spot_roi_mask, std::vector<std::vector<cv::Point>>{contour}, -1, cv::Scalar(255), cv::FILLED,
+                         cv::LINE_8, cv::noArray(), INT_MAX, -bounding_box.tl());
         double min_temp, max_temp_in_roi;
-        cv::minMaxLoc(temp_matrix, &min_temp, &max_temp_in_roi, nullptr, nullptr, spot_roi_mask);
+        cv::minMaxLoc(temp_matrix(bounding_box), &min_temp, &max_temp_in_roi, nullptr, nullptr, spot_roi_mask);
+        cv::Scalar mean_temp_in_roi, stddev_temp_in_roi;
+        cv::meanStdDev(temp_matrix(bounding_box), mean_temp_in_roi, stddev_temp_in_roi, spot_roi_mask);
+        double max_rise_rate = 0.0;
+        if (has_rise_rate)
+            cv::minMaxLoc(aux_inputs.rise_rate(bounding_box), nullptr, &max_rise_rate, nullptr, nullptr, spot_roi_mask);
 
         HotSpot spot;
         spot.id = spot_id_counter++;
         spot.pixel_centroid = centroid;
         spot.area_pixels = area;
-        spot.max_temperature = static_cast<float>(max_temp_in_roi);
+        spot.max_temperature = static_cast<float>(max_temp_in_roi * unit);
+        spot.mean_temperature = static_cast<float>(mean_temp_in_roi[0] * unit);
+        spot.temperature_stddev = static_cast<float>(stddev_temp_in_roi[0] * unit);
+        spot.rate_of_rise = static_cast<float>(std::max(max_rise_rate, 0.0));
         spot.contour_pixels = contour;
-        spot.world_coord_approx = pixelToApproxWorld(centroid, camera_matrix_param, assumed_distance_to_fire_plane_param);
+        if (has_zones)
+        {
+            const cv::Point c(std::min(std::max(cvRound(centroid.x), 0), temp_matrix.cols - 1),
+                              std::min(std::max(cvRound(centroid.y), 0), temp_matrix.rows - 1));
+            spot.zone_id = static_cast<int>(zone_ids.at<ushort>(c)) - 1;
+        }
+        // 在热点底边中点 (火源与地面的接触点) 查询深度，地平面模型下比质心更准确
+        cv::Point2f ground_contact(centroid.x, static_cast<float>(bounding_box.y + bounding_box.height - 1));
+        // 温度统计与区域归属按原始图像完成后，再把几何量稀疏校正为无畸变坐标
+        if (aux_inputs.undistortion && aux_inputs.undistortion->isEnabled())
+        {
+            aux_inputs.undistortion->undistortHotspot(spot);
+            std::vector<cv::Point2f> contact{ground_contact};
+            aux_inputs.undistortion->undistortPoints(contact);
+            ground_contact = contact[0];
+        }
+        spot.range_meters = range_provider.depthAt(ground_contact);
+        spot.world_coord_approx = pixelToApproxWorld(spot.pixel_centroid, camera_matrix_param, spot.range_meters);
         detected_spots.push_back(spot);
+    };
+
+    std::vector<std::vector<cv::Point>> sub_contours;
+    std::vector<cv::Rect> blob_regions;
+    for (const auto &candidate : candidates)
+    {
+        const double area = candidate.first;
+        const std::vector<cv::Point> &contour = contours[candidate.second];
+        if (aux_inputs.region_tracker)
+            blob_regions.push_back(cv::boundingRect(contour));
+
+        // 大轮廓可能是闭运算粘连的多个火源，按温度峰值拆分
+        if (aux_inputs.split.enabled && area >= aux_inputs.split.min_blob_area_pixels)
+        {
+            cv::Rect bounding_box = cv::boundingRect(contour);
+            cv::Mat blob_mask = cv::Mat::zeros(bounding_box.size(), CV_8U);
+            cv::drawContours(blob_mask, std::vector<std::vector<cv::Point>>{contour}, -1, cv::Scalar(255), cv::FILLED,
+                             cv::LINE_8, cv::noArray(), INT_MAX, -bounding_box.tl());
+            blob_mask &= binary_mask(bounding_box);
+            // 有阈值图时峰值门限取该热点范围内的最低阈值
+            double split_threshold = aux_inputs.params.temperature_threshold;
+            if (has_threshold_map)
+            {
+                cv::minMaxLoc(threshold_map(bounding_box), &split_threshold, nullptr, nullptr, nullptr, blob_mask);
+                split_threshold *= temperatureUnitCelsius(threshold_map);
+            }
+            if (splitMergedBlob(temp_matrix, bounding_box, blob_mask, static_cast<float>(split_threshold), aux_inputs.split, sub_contours))
+            {
+                for (const auto &sub_contour : sub_contours)
+                {
+                    double sub_area = cv::contourArea(sub_contour);
+                    if (sub_area >= aux_inputs.params.min_area_pixels)
+                        append_hotspot(sub_contour, sub_area);
+                }
+                continue;
+            }
+        }
+        append_hotspot(contour, area);
     }
+    if (aux_inputs.region_tracker)
+        aux_inputs.region_tracker->record(blob_regions, full_discovery);
+
+    if (times)
+        times->statistics_ms = stage_ms();
     return detected_spots;
 }
 
+int evictLeastSevereHotspots(std::vector<HotSpot> &hot_spots, int max_kept_param)
+{
+    const size_t max_kept = static_cast<size_t>(std::max(max_kept_param, 0));
+    if (hot_spots.size() <= max_kept)
+        return 0;
+
+    std::vector<float> severities(hot_spots.size());
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+        severities[i] = hotspotSeverity(hot_spots[i]);
+    std::vector<size_t> order(hot_spots.size());
+    for (size_t i = 0; i < order.size(); ++i)
+        order[i] = i;
+    std::nth_element(order.begin(), order.begin() + max_kept, order.end(),
+                     [&](size_t a, size_t b) { return severities[a] > severities[b]; });
+    std::vector<bool> keep(hot_spots.size(), false);
+    for (size_t i = 0; i < max_kept; ++i)
+        keep[order[i]] = true;
+    size_t kept = 0;
+    for (size_t i = 0; i < hot_spots.size(); ++i)
+    {
+        if (keep[i])
+            hot_spots[kept++] = std::move(hot_spots[i]);
+    }
+    const int evicted = static_cast<int>(hot_spots.size() - kept);
+    hot_spots.resize(kept);
+    return evicted;
+}
+
 std::vector<SprayTarget> determineSprayTargets(
     std::vector<HotSpot> &hot_spots,
     float max_grouping_distance_param)
@@ -79,11 +315,13 @@ std::vector<SprayTarget> determineSprayTargets(
         SprayTarget current_target;
         current_target.id = target_id_counter++;
         current_target.source_hotspot_ids.push_back(hot_spots[i].id);
+        current_target.confirmed = isConfirmedFire(hot_spots[i]);
         hot_spots[i].grouped = true;
 
         cv::Point2f sum_pixel_centroids = hot_spots[i].pixel_centroid;
         cv::Point3f sum_world_centroids_approx = hot_spots[i].world_coord_approx;
-        float total_severity_metric = static_cast<float>(hot_spots[i].area_pixels * hot_spots[i].max_temperature);
+        cv::Point3f sum_world_frame_positions = hot_spots[i].world_frame_position;
+        float total_severity_metric = hotspotSeverity(hot_spots[i]);
         int num_in_group = 1;
 
         for (size_t j = i + 1; j < hot_spots.size(); ++j)
@@ -96,7 +334,9 @@ std::vector<SprayTarget> determineSprayTargets(
                 current_target.source_hotspot_ids.push_back(hot_spots[j].id);
                 sum_pixel_centroids += hot_spots[j].pixel_centroid;
                 sum_world_centroids_approx += hot_spots[j].world_coord_approx;
-                total_severity_metric += static_cast<float>(hot_spots[j].area_pixels * hot_spots[j].max_temperature);
+                sum_world_frame_positions += hot_spots[j].world_frame_position;
+                total_severity_metric += hotspotSeverity(hot_spots[j]);
+                current_target.confirmed = current_target.confirmed || isConfirmedFire(hot_spots[j]);
                 num_in_group++;
             }
         }
@@ -110,6 +350,7 @@ std::vector<SprayTarget> determineSprayTargets(
         {
             current_target.final_world_aim_point_approx = cv::Point3f(0, 0, 0);
         }
+        current_target.final_world_frame_aim_point = sum_world_frame_positions * (1.0f / num_in_group);
         current_target.estimated_severity = total_severity_metric;
         final_targets.push_back(current_target);
     }
@@ -132,7 +373,9 @@ void visualizeResults(
     int target_rank = 1;
     for (const auto &target : spray_targets)
     {
-        cv::circle(display_image, target.final_pixel_aim_point, 8, cv::Scalar(255, 0, 255), 2);
+        // 未经闪烁确认的目标用灰色标出
+        cv::Scalar target_color = target.confirmed ? cv::Scalar(255, 0, 255) : cv::Scalar(128, 128, 128);
+        cv::circle(display_image, target.final_pixel_aim_point, 8, target_color, 2);
         cv::putText(display_image, "T" + std::to_string(target_rank++),
                     target.final_pixel_aim_point + cv::Point2f(10, 0),
                     cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 0), 2);
@@ -185,14 +428,5 @@ CloudGimbalAngles calculateGimbalAngles(
     // if (angles.target_pitch_degrees > 45.0f) angles.target_pitch_degrees = 45.0f;
     // if (angles.target_pitch_degrees < -45.0f) angles.target_pitch_degrees = -45.0f;
 
-    // 调试信息
-    std::cout << "Target Pixel: (" << target_pixel_coords.x << ", " << target_pixel_coords.y << ")" << std::endl;
-    std::cout << "Image Center: (" << cx << ", " << cy << ")" << std::endl;
-    std::cout << "Delta Pixels (Az, P): (" << delta_azimuth_pixels << ", " << delta_pitch_pixels << ")" << std::endl;
-    std::cout << "Delta Degrees (Az, P): (" << delta_azimuth_degrees << ", " << delta_pitch_degrees << ")" << std::endl;
-    std::cout << "Nozzle Offset (Az, P): (" << nozzle_offset_azimuth_degrees << ", " << nozzle_offset_pitch_degrees << ")" << std::endl;
-    std::cout << "Current Cloud (Az, P): (" << current_cloud_azimuth_degrees << ", " << current_cloud_pitch_degrees << ")" << std::endl;
-    std::cout << "Calculated Target Cloud (Az, P): (" << angles.target_azimuth_degrees << ", " << angles.target_pitch_degrees << ")" << std::endl;
-
     return angles;
 }
\ No newline at end of file
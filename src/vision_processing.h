@@ -3,11 +3,49 @@
 #define VISION_PROCESSING_H
 
 #include "utils.h"
-#include <opencv2/opencv.hpp>
+#include "range_estimation.h"
+#include "candidate_mask.h"
+#include "blob_splitting.h"
+#include "lens_undistortion.h"
+#include "region_tracking.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 #include <vector>
 
 // --- 核心视觉处理函数声明 ---
 
+// 检测参数，默认为 utils.h 中的常量；参数扫描工具 (tools/parameter_sweep.cpp) 在运行时逐组设置
+struct DetectionParameters
+{
+    float temperature_threshold = FIRE_TEMPERATURE_THRESHOLD_CELSIUS; // 未提供阈值图时的标量阈值
+    double min_area_pixels = MIN_HOTSPOT_AREA_PIXELS;
+    int morphology_kernel_size = MORPHOLOGY_KERNEL_SIZE;
+    int max_contours_examined = MAX_CONTOURS_EXAMINED; // 保证病态场景 (大量碎片、棋盘格) 下的单帧耗时有上界
+};
+
+// 单帧检测的分阶段耗时 (ms) 与计数，由压力测试工具 (tools/stress_detection.cpp) 读取
+struct DetectionStageTimes
+{
+    double mask_ms = 0.0;       // 候选掩码 (跟踪帧中含区域内的形态学与轮廓提取)
+    double morphology_ms = 0.0; // 开/闭运算
+    double contours_ms = 0.0;   // 轮廓提取与面积筛选
+    double statistics_ms = 0.0; // 逐热点温度统计、拆分与测距
+    int contours_found = 0;
+    int contours_examined = 0;
+};
+
+// 热点检测的可选输入，字段为空时跳过对应处理
+struct DetectionAuxInputs
+{
+    DetectionParameters params;
+    CandidateMaskInputs mask_inputs; // 升温候选、静态屏蔽、背景模型，在标记前一次性融合 (见 candidate_mask.h)
+    cv::Mat rise_rate;               // 逐像素升温速率 (CV_32FC1, °C/s)，用于填充 HotSpot::rate_of_rise
+    BlobSplitConfig split;           // 粘连热点拆分，默认关闭 (见 blob_splitting.h)
+    const LensUndistortion *undistortion = nullptr; // 非空时热点几何 (质心、轮廓、测距点) 转换为无畸变像素坐标
+    RegionTracker *region_tracker = nullptr;        // 非空时在跟踪帧中只在已知热点区域内检测，并记录本帧热点区域
+    DetectionStageTimes *stage_times = nullptr;     // 非空时记录分阶段耗时
+};
+
 /**
  * @brief 检测并过滤热点区域
  *
@@ -22,6 +60,34 @@ std::vector<HotSpot> detectAndFilterHotspots(
     const cv::Mat &camera_matrix,
     float assumed_distance_to_fire_plane);
 
+/**
+ * @brief 检测并过滤热点区域 (逐热点距离估计)
+ *
+ * @param temp_matrix 温度矩阵，包含每个像素的温度信息
+ * @param camera_matrix 相机内参矩阵
+ * @param range_provider 距离估计模型，按每个热点的接地点查询深度
+ * @param aux_inputs 可选输入 (升温候选掩码、静态屏蔽、背景模型等)
+ *
+ * @return 返回过滤后的热点区域向量
+ */
+std::vector<HotSpot> detectAndFilterHotspots(
+    const cv::Mat &temp_matrix,
+    const cv::Mat &camera_matrix,
+    const RangeProvider &range_provider,
+    const DetectionAuxInputs &aux_inputs = DetectionAuxInputs());
+
+/**
+ * @brief 热点数超过上限时淘汰严重度最低的热点，其余保持原顺序
+ *
+ * 严重度包含闪烁得分与分类器概率 (见 HotSpot)，因此应在跟踪与分类之后、分组之前调用。
+ *
+ * @param hot_spots 热点区域向量，原地删除被淘汰的热点
+ * @param max_kept 保留的热点数上限
+ *
+ * @return 淘汰的热点数
+ */
+int evictLeastSevereHotspots(std::vector<HotSpot> &hot_spots, int max_kept = MAX_HOTSPOTS_KEPT);
+
 /**
  * @brief 确定喷射目标
  *
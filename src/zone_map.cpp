@@ -0,0 +1,90 @@
+// src/zone_map.cpp
+#include "zone_map.h"
+#include <iostream>
+
+bool ZoneMap::load(const std::string &filename, const cv::Size &image_size)
+{
+    zones_.clear();
+    zone_ids_.release();
+    allow_mask_.release();
+
+    cv::FileStorage fs(filename, cv::FileStorage::READ);
+    if (!fs.isOpened())
+    {
+        std::cerr << "Error: Could not open parameters file: " << filename << std::endl;
+        return false;
+    }
+
+    cv::FileNode zones_node = fs["zones"];
+    if (zones_node.isNone())
+    {
+        std::cout << "Warning: zones not found in " << filename << std::endl;
+        return false;
+    }
+    if (!zones_node.isSeq())
+        return false; // 空的 <zones></zones> 表示未配置区域
+
+    for (cv::FileNodeIterator it = zones_node.begin(); it != zones_node.end(); ++it)
+    {
+        cv::FileNode node = *it;
+        ZoneDefinition zone;
+        node["name"] >> zone.name;
+        std::string type;
+        node["type"] >> type;
+        zone.type = (type == "exclusion") ? ZoneType::Exclusion : ZoneType::Measurement;
+        if (node["alarm_temperature"].isReal() || node["alarm_temperature"].isInt())
+            node["alarm_temperature"] >> zone.alarm_temperature;
+
+        std::vector<int> points;
+        node["points"] >> points;
+        for (size_t i = 0; i + 1 < points.size(); i += 2)
+            zone.polygon.emplace_back(points[i], points[i + 1]);
+        if (zone.polygon.size() < 3 || cv::contourArea(zone.polygon) < 1.0)
+        {
+            std::cout << "Warning: zone '" << zone.name << "' needs at least 3 points enclosing a non-empty area, skipped." << std::endl;
+            continue;
+        }
+        zones_.push_back(zone);
+    }
+    fs.release();
+
+    if (zones_.empty())
+        return false;
+    if (zones_.size() > 65535)
+    {
+        std::cout << "Warning: more than 65535 zones defined, extra zones ignored." << std::endl;
+        zones_.resize(65535);
+    }
+
+    // 光栅化：编号图按定义顺序填充，后定义的区域覆盖重叠部分
+    zone_ids_ = cv::Mat::zeros(image_size, CV_16UC1);
+    bool has_exclusion = false;
+    for (size_t i = 0; i < zones_.size(); ++i)
+    {
+        cv::fillPoly(zone_ids_, std::vector<std::vector<cv::Point>>{zones_[i].polygon}, cv::Scalar(static_cast<double>(i + 1)));
+        has_exclusion = has_exclusion || zones_[i].type == ZoneType::Exclusion;
+    }
+    if (has_exclusion)
+    {
+        allow_mask_.create(image_size, CV_8UC1);
+        allow_mask_.setTo(cv::Scalar(255));
+        for (const auto &zone : zones_)
+        {
+            if (zone.type == ZoneType::Exclusion)
+                cv::fillPoly(allow_mask_, std::vector<std::vector<cv::Point>>{zone.polygon}, cv::Scalar(0));
+        }
+    }
+
+    std::cout << "Loaded " << zones_.size() << " zones." << std::endl;
+    return true;
+}
+
+int ZoneMap::zoneAt(const cv::Point2f &pixel) const
+{
+    if (zone_ids_.empty())
+        return -1;
+    const int x = cvRound(pixel.x), y = cvRound(pixel.y);
+    if (x < 0 || y < 0 || x >= zone_ids_.cols || y >= zone_ids_.rows)
+        return -1;
+    return static_cast<int>(zone_ids_.at<ushort>(y, x)) - 1;
+}
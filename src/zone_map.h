@@ -0,0 +1,74 @@
+// src/zone_map.h
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <cfloat>
+#include <string>
+#include <vector>
+
+// --- 多边形测量区域与禁喷区域 ---
+// 区域在参数文件中以像素坐标多边形定义，加载时一次性光栅化：
+//   * 区域编号图 (CV_16UC1)：0 表示不属于任何区域，i+1 表示第 i 个区域，重叠部分由后定义的区域覆盖
+//   * 允许检测掩码 (CV_8UC1)：禁喷区域为 0，与静态屏蔽掩码合并后在候选掩码的 SIMD 遍历中按位与
+// 每帧的区域归属和统计只是按编号图查表，与区域数量无关。
+
+enum class ZoneType
+{
+    Measurement, // 测量/报警区域
+    Exclusion    // 禁喷区域 (如配电柜)，区域内不产生候选像素
+};
+
+struct ZoneDefinition
+{
+    std::string name;
+    ZoneType type = ZoneType::Measurement;
+    std::vector<cv::Point> polygon;
+    float alarm_temperature = 0.0f; // 区域最高温度超过该值时报警，0 表示不报警
+};
+
+// 单个区域一帧的统计 (由 computeCandidateMask 在掩码遍历中累积)
+struct ZoneFrameStats
+{
+    int pixel_count = 0;
+    int candidate_pixels = 0; // 区域内的候选 (高温) 像素数
+    float max_temperature = -FLT_MAX;
+    double temperature_sum = 0.0;
+
+    float meanTemperature() const { return pixel_count > 0 ? static_cast<float>(temperature_sum / pixel_count) : 0.0f; }
+};
+
+class ZoneMap
+{
+public:
+    /**
+     * @brief 从参数文件读取区域定义并光栅化
+     *
+     * @param filename 参数文件路径
+     * @param image_size 温度矩阵尺寸
+     * @return 至少定义了一个有效区域时返回 true
+     *
+     * 读取 zones 序列，每项包含 name、type (measure / exclusion)、points (x0 y0 x1 y1 ...) 和可选的 alarm_temperature。
+     */
+    bool load(const std::string &filename, const cv::Size &image_size);
+
+    /**
+     * @brief 查询像素所属区域
+     *
+     * @return 区域下标，不属于任何区域时返回 -1
+     */
+    int zoneAt(const cv::Point2f &pixel) const;
+
+    const std::vector<ZoneDefinition> &zones() const { return zones_; }
+    const cv::Mat &zoneIds() const { return zone_ids_; }
+    const cv::Mat &allowMask() const { return allow_mask_; } // 无禁喷区域时为空
+    bool empty() const { return zones_.empty(); }
+
+private:
+    std::vector<ZoneDefinition> zones_;
+    cv::Mat zone_ids_;
+    cv::Mat allow_mask_;
+};
+
+#endif // ZONE_MAP_H
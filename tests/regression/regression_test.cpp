@@ -0,0 +1,403 @@
+// tests/regression/regression_test.cpp
+// 检测/分组回归测试：结果正确性与耗时基线一次运行
+//
+// 用法：
+//   regression_test <语料目录> [--update] [--baseline 文件] [--update-baseline] [--repeat N] [--max-slowdown R]
+//
+// 语料目录下的 corpus.yml 列出测试用例：
+//   synthetic  按参数生成的温度场：背景 + 确定性纹理 + 若干圆形热源 (边缘温度到峰值温度的抛物线分布)，
+//              可在任意平台上逐位复现，不依赖二进制数据文件
+//   recorded   录制的热成像帧 (image 相对语料目录，缩放到 width x height (默认 384x288) 后按 min/max_temperature 线性映射)
+// 每个用例的期望输出保存在 golden/<name>.yml：热点 (质心、面积、最高/平均温度) 与喷射目标 (瞄准点、来源热点数)。
+// 检测流程对每个用例分别以 CV_32FC1 和 CV_16SC1 温度矩阵运行，两种格式都必须与期望输出一致 (容差见 corpus.yml)。
+//
+// 耗时：每个用例重复 --repeat 次 (默认 20)，取检测 + 分组耗时的中位数，与 --baseline 文件 (默认为当前目录下
+// regression_baseline.yml，即每台机器、每个构建目录一份) 比较并输出加速比。基线不存在时自动记录。
+// 总耗时比基线慢超过 --max-slowdown (默认 0.5，即 50%) 时测试失败。
+//
+// --update 用当前输出重写期望文件 (确认结果变化符合预期后使用)；--update-baseline 重写耗时基线。
+// 返回值：0 通过，1 结果不一致或性能退化，2 参数或语料错误。
+
+#include "range_estimation.h"
+#include "sequence_io.h"
+#include "temperature_conversion.h"
+#include "vision_processing.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string corpus_dir;
+        std::string baseline_file = "regression_baseline.yml";
+        bool update_golden = false;
+        bool update_baseline = false;
+        int repeat = 20;
+        double max_slowdown = 0.5;
+    };
+
+    bool parseArguments(int argc, char **argv, Options &options)
+    {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--update")
+                options.update_golden = true;
+            else if (arg == "--update-baseline")
+                options.update_baseline = true;
+            else if (arg == "--baseline" && i + 1 < argc)
+                options.baseline_file = argv[++i];
+            else if (arg == "--repeat" && i + 1 < argc)
+                options.repeat = std::atoi(argv[++i]);
+            else if (arg == "--max-slowdown" && i + 1 < argc)
+                options.max_slowdown = std::atof(argv[++i]);
+            else
+                positional.push_back(arg);
+        }
+        if (positional.size() != 1 || options.repeat <= 0 || options.max_slowdown < 0.0)
+            return false;
+        options.corpus_dir = positional[0];
+        return true;
+    }
+
+    struct Tolerances
+    {
+        double centroid_pixels = 0.5;
+        double area_ratio = 0.02;
+        double temperature_celsius = 0.1;
+    };
+
+    struct TestCase
+    {
+        std::string name;
+        cv::Mat temperature; // CV_32FC1
+    };
+
+    // 合成温度场：纹理只加在背景上，幅值远低于阈值，热源边界像素由整数坐标的 d^2 <= r^2 决定，与浮点舍入无关
+    cv::Mat synthesizeFrame(const cv::FileNode &node)
+    {
+        const int width = static_cast<int>(node["width"]);
+        const int height = static_cast<int>(node["height"]);
+        const float background = static_cast<float>(node["background"]);
+        const float texture = static_cast<float>(node["texture_amplitude"]);
+        cv::Mat sources; // N x 5: x y radius edge_temperature peak_temperature
+        node["sources"] >> sources;
+
+        cv::Mat temperature(height, width, CV_32FC1);
+        for (int y = 0; y < height; ++y)
+        {
+            float *t = temperature.ptr<float>(y);
+            for (int x = 0; x < width; ++x)
+                t[x] = background + texture * std::sin(0.7f * x) * std::cos(1.3f * y);
+        }
+        for (int i = 0; i < sources.rows; ++i)
+        {
+            const double *s = sources.ptr<double>(i);
+            const int cx = cvRound(s[0]), cy = cvRound(s[1]), r = cvRound(s[2]);
+            const float edge = static_cast<float>(s[3]), peak = static_cast<float>(s[4]);
+            for (int y = std::max(cy - r, 0); y <= std::min(cy + r, height - 1); ++y)
+            {
+                float *t = temperature.ptr<float>(y);
+                for (int x = std::max(cx - r, 0); x <= std::min(cx + r, width - 1); ++x)
+                {
+                    const int d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+                    if (d2 <= r * r)
+                        t[x] = std::max(t[x], edge + (peak - edge) * (1.0f - static_cast<float>(d2) / static_cast<float>(r * r)));
+                }
+            }
+        }
+        return temperature;
+    }
+
+    bool loadCorpus(const std::string &corpus_dir, std::vector<TestCase> &cases, Tolerances &tolerances)
+    {
+        const std::string corpus_file = corpus_dir + "/corpus.yml";
+        cv::FileStorage fs(corpus_file, cv::FileStorage::READ);
+        if (!fs.isOpened())
+        {
+            std::cerr << "Error: Could not open corpus file: " << corpus_file << std::endl;
+            return false;
+        }
+        if (fs["centroid_tolerance_pixels"].isReal())
+            fs["centroid_tolerance_pixels"] >> tolerances.centroid_pixels;
+        if (fs["area_tolerance_ratio"].isReal())
+            fs["area_tolerance_ratio"] >> tolerances.area_ratio;
+        if (fs["temperature_tolerance_celsius"].isReal())
+            fs["temperature_tolerance_celsius"] >> tolerances.temperature_celsius;
+
+        for (const auto &node : fs["cases"])
+        {
+            TestCase test_case;
+            node["name"] >> test_case.name;
+            const std::string type = static_cast<std::string>(node["type"]);
+            if (type == "synthetic")
+            {
+                test_case.temperature = synthesizeFrame(node);
+            }
+            else if (type == "recorded")
+            {
+                // 与主程序相同的读取路径：灰度读取、缩放到检测分辨率 (默认 384x288)、线性映射为温度
+                const std::string image_path = corpus_dir + "/" + static_cast<std::string>(node["image"]);
+                const cv::Size target_size(node["width"].isInt() ? static_cast<int>(node["width"]) : 384,
+                                           node["height"].isInt() ? static_cast<int>(node["height"]) : 288);
+                if (!getThermalImageAsTemperatureMatrix(image_path, test_case.temperature, static_cast<float>(node["min_temperature"]),
+                                                        static_cast<float>(node["max_temperature"]), target_size))
+                    return false;
+            }
+            else
+            {
+                std::cerr << "Error: Unknown case type '" << type << "' for " << test_case.name << std::endl;
+                return false;
+            }
+            cases.push_back(test_case);
+        }
+        return !cases.empty();
+    }
+
+    // 热点: cx cy area max_temperature mean_temperature；目标: x y source_count
+    struct CaseOutput
+    {
+        cv::Mat hotspots;
+        cv::Mat targets;
+    };
+
+    const cv::Mat &regressionCameraMatrix()
+    {
+        static const cv::Mat camera_matrix = (cv::Mat_<double>(3, 3) << 500.0, 0.0, 192.0, 0.0, 500.0, 144.0, 0.0, 0.0, 1.0);
+        return camera_matrix;
+    }
+
+    CaseOutput runPipeline(const cv::Mat &temperature)
+    {
+        FixedRangeProvider range_provider;
+        DetectionAuxInputs detection_inputs;
+        std::vector<HotSpot> hot_spots = detectAndFilterHotspots(temperature, regressionCameraMatrix(), range_provider, detection_inputs);
+        std::vector<SprayTarget> targets = determineSprayTargets(hot_spots, MAX_GROUPING_DISTANCE_METERS);
+
+        CaseOutput output;
+        output.hotspots.create(static_cast<int>(hot_spots.size()), 5, CV_64F);
+        for (size_t i = 0; i < hot_spots.size(); ++i)
+        {
+            double *row = output.hotspots.ptr<double>(static_cast<int>(i));
+            row[0] = hot_spots[i].pixel_centroid.x;
+            row[1] = hot_spots[i].pixel_centroid.y;
+            row[2] = hot_spots[i].area_pixels;
+            row[3] = hot_spots[i].max_temperature;
+            row[4] = hot_spots[i].mean_temperature;
+        }
+        output.targets.create(static_cast<int>(targets.size()), 3, CV_64F);
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            double *row = output.targets.ptr<double>(static_cast<int>(i));
+            row[0] = targets[i].final_pixel_aim_point.x;
+            row[1] = targets[i].final_pixel_aim_point.y;
+            row[2] = static_cast<double>(targets[i].source_hotspot_ids.size());
+        }
+        return output;
+    }
+
+    bool readGolden(const std::string &file, CaseOutput &golden)
+    {
+        cv::FileStorage fs(file, cv::FileStorage::READ);
+        if (!fs.isOpened())
+            return false;
+        const int hotspot_count = static_cast<int>(fs["hotspot_count"]);
+        const int target_count = static_cast<int>(fs["target_count"]);
+        golden.hotspots = cv::Mat(0, 5, CV_64F);
+        golden.targets = cv::Mat(0, 3, CV_64F);
+        if (hotspot_count > 0)
+            fs["hotspots"] >> golden.hotspots;
+        if (target_count > 0)
+            fs["targets"] >> golden.targets;
+        return golden.hotspots.rows == hotspot_count && golden.targets.rows == target_count;
+    }
+
+    void writeGolden(const std::string &file, const CaseOutput &output)
+    {
+        cv::FileStorage fs(file, cv::FileStorage::WRITE);
+        fs << "hotspot_count" << output.hotspots.rows;
+        fs << "target_count" << output.targets.rows;
+        if (output.hotspots.rows > 0)
+            fs << "hotspots" << output.hotspots;
+        if (output.targets.rows > 0)
+            fs << "targets" << output.targets;
+    }
+
+    // 按质心/瞄准点就近一一匹配 (输出顺序不属于契约)，返回首个不一致的描述，一致时返回空串
+    std::string compareRows(const cv::Mat &expected, const cv::Mat &actual, const char *what, const Tolerances &tol, bool is_hotspot)
+    {
+        if (expected.rows != actual.rows)
+            return std::string(what) + " count " + std::to_string(actual.rows) + " != expected " + std::to_string(expected.rows);
+
+        std::vector<bool> used(actual.rows, false);
+        for (int i = 0; i < expected.rows; ++i)
+        {
+            const double *e = expected.ptr<double>(i);
+            int best = -1;
+            double best_distance = tol.centroid_pixels;
+            for (int j = 0; j < actual.rows; ++j)
+            {
+                const double *a = actual.ptr<double>(j);
+                const double distance = std::hypot(a[0] - e[0], a[1] - e[1]);
+                if (!used[j] && distance <= best_distance)
+                {
+                    best = j;
+                    best_distance = distance;
+                }
+            }
+            const std::string label = std::string(what) + " at (" + std::to_string(e[0]) + ", " + std::to_string(e[1]) + ")";
+            if (best < 0)
+                return label + ": no match within " + std::to_string(tol.centroid_pixels) + " px";
+            used[best] = true;
+
+            const double *a = actual.ptr<double>(best);
+            if (is_hotspot)
+            {
+                if (std::fabs(a[2] - e[2]) > tol.area_ratio * std::max(e[2], 1.0))
+                    return label + ": area " + std::to_string(a[2]) + " != " + std::to_string(e[2]);
+                if (std::fabs(a[3] - e[3]) > tol.temperature_celsius || std::fabs(a[4] - e[4]) > tol.temperature_celsius)
+                    return label + ": temperature (" + std::to_string(a[3]) + ", " + std::to_string(a[4]) + ") != (" +
+                           std::to_string(e[3]) + ", " + std::to_string(e[4]) + ")";
+            }
+            else if (a[2] != e[2])
+            {
+                return label + ": source count " + std::to_string(a[2]) + " != " + std::to_string(e[2]);
+            }
+        }
+        return std::string();
+    }
+
+    double medianPipelineMs(const cv::Mat &temperature, int repeat)
+    {
+        std::vector<double> samples;
+        for (int i = 0; i < repeat; ++i)
+        {
+            const int64 start = cv::getTickCount();
+            runPipeline(temperature);
+            samples.push_back((cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency());
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: regression_test <corpus_dir> [--update] [--baseline file] [--update-baseline]"
+                  << " [--repeat N] [--max-slowdown R]" << std::endl;
+        return 2;
+    }
+
+    std::vector<TestCase> cases;
+    Tolerances tolerances;
+    if (!loadCorpus(options.corpus_dir, cases, tolerances))
+        return 2;
+
+    // 定点格式的温度量化为 0.1 °C，温度容差额外放宽半个量化步长
+    Tolerances compact_tolerances = tolerances;
+    compact_tolerances.temperature_celsius += 0.5 / DECI_CELSIUS_PER_DEGREE;
+
+    if (options.update_golden)
+        std::filesystem::create_directories(options.corpus_dir + "/golden");
+
+    int failures = 0;
+    for (const auto &test_case : cases)
+    {
+        const std::string golden_file = options.corpus_dir + "/golden/" + test_case.name + ".yml";
+        const CaseOutput output = runPipeline(test_case.temperature);
+        if (options.update_golden)
+        {
+            writeGolden(golden_file, output);
+            std::cout << "[UPDATED] " << test_case.name << ": " << output.hotspots.rows << " hotspots, "
+                      << output.targets.rows << " targets" << std::endl;
+            continue;
+        }
+
+        CaseOutput golden;
+        if (!readGolden(golden_file, golden))
+        {
+            std::cout << "[FAIL] " << test_case.name << ": missing or invalid golden file " << golden_file
+                      << " (run 'RegressionTest " << options.corpus_dir << " --update' and commit golden/)" << std::endl;
+            ++failures;
+            continue;
+        }
+
+        cv::Mat compact;
+        convertTemperatureFormat(test_case.temperature, compact, CV_16SC1);
+        const CaseOutput compact_output = runPipeline(compact);
+        std::string error = compareRows(golden.hotspots, output.hotspots, "hotspot", tolerances, true);
+        if (error.empty())
+            error = compareRows(golden.targets, output.targets, "target", tolerances, false);
+        if (error.empty())
+            error = compareRows(golden.hotspots, compact_output.hotspots, "hotspot (CV_16SC1)", compact_tolerances, true);
+        if (error.empty())
+            error = compareRows(golden.targets, compact_output.targets, "target (CV_16SC1)", compact_tolerances, false);
+
+        if (error.empty())
+        {
+            std::cout << "[PASS] " << test_case.name << std::endl;
+        }
+        else
+        {
+            std::cout << "[FAIL] " << test_case.name << ": " << error << std::endl;
+            ++failures;
+        }
+    }
+    if (options.update_golden)
+        return 0;
+
+    // 耗时与基线比较
+    cv::FileStorage baseline_in(options.baseline_file, cv::FileStorage::READ);
+    const bool has_baseline = baseline_in.isOpened() && !options.update_baseline;
+    cv::FileStorage baseline_out;
+    if (!has_baseline)
+        baseline_out.open(options.baseline_file, cv::FileStorage::WRITE);
+
+    double total_ms = 0.0, total_baseline_ms = 0.0;
+    for (const auto &test_case : cases)
+    {
+        const double ms = medianPipelineMs(test_case.temperature, options.repeat);
+        total_ms += ms;
+        if (has_baseline && baseline_in[test_case.name].isReal())
+        {
+            const double baseline_ms = static_cast<double>(baseline_in[test_case.name]);
+            total_baseline_ms += baseline_ms;
+            std::cout << "[TIME] " << test_case.name << ": " << ms << " ms (baseline " << baseline_ms << " ms, "
+                      << (baseline_ms > 0.0 ? 100.0 * (baseline_ms - ms) / baseline_ms : 0.0) << "% faster)" << std::endl;
+        }
+        else
+        {
+            std::cout << "[TIME] " << test_case.name << ": " << ms << " ms" << std::endl;
+            if (baseline_out.isOpened())
+                baseline_out << test_case.name << ms;
+        }
+    }
+
+    if (has_baseline && total_baseline_ms > 0.0)
+    {
+        const double speedup = (total_baseline_ms - total_ms) / total_baseline_ms;
+        std::cout << "Total: " << total_ms << " ms vs baseline " << total_baseline_ms << " ms (" << 100.0 * speedup << "% faster)" << std::endl;
+        if (-speedup > options.max_slowdown)
+        {
+            std::cout << "[FAIL] Performance regression beyond " << 100.0 * options.max_slowdown << "%" << std::endl;
+            ++failures;
+        }
+    }
+    else
+    {
+        std::cout << "Timing baseline recorded in " << options.baseline_file << " (" << total_ms << " ms total)" << std::endl;
+    }
+
+    std::cout << (failures == 0 ? "All regression cases passed." : "Regression failures: " + std::to_string(failures)) << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,360 @@
+// tools/batch_analyze.cpp
+// 录制数据离线批量分析工具
+//
+// 用法：
+//   batch_analyze <序列目录 | 序列列表文件> [--out 输出前缀] [--format csv|json] [--threads N]
+//                 [--chunk N] [--warmup N] [--params params.xml]
+//
+// 输入为目录时作为单个录制序列 (格式见 src/sequence_io.h)，为文件时按序列列表读取 (每行一个序列目录)。
+// 每个序列按 --chunk 帧切分为若干工作块，由 --threads 个工作线程并行处理 (默认为 CPU 核数)。
+// 每个工作线程持有一个按 --params 配置的 FirePipeline (与主程序完全相同的流程，含区域、NUC、阈值图、
+// 镜头畸变、变换链与火情地图)，每块开始前清空时域状态；云台角度取 sequence.yml 中逐帧录制的 gimbal_angles
+// (未录制时按云台零位处理)，录制序列没有里程计数据，按底盘静止处理。
+// 时域模型 (升温速率、背景、跟踪/闪烁) 需要连续帧，每块先处理前 --warmup 帧作为预热，预热帧不输出。
+//
+// 输出：
+//   csv：<前缀>_hotspots.csv 与 <前缀>_targets.csv，每行一个热点/目标
+//   json：<前缀>.jsonl，每行一帧 {"sequence", "frame", "hotspots": [...], "targets": [...]}
+// 结果按序列、帧顺序写出，已完成的连续工作块即时写入并释放，内存占用与数据量无关。
+// 结束时输出总帧数、墙钟时间、吞吐量 (帧/秒)、单帧处理耗时的均值与最大值，以及热点分类器超出推理预算的帧数。
+
+#include "fire_pipeline.h"
+#include "sequence_io.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string input;
+        std::string output_prefix = "batch_results";
+        std::string params_file = "../config/params.xml";
+        bool json = false;
+        int threads = 0;
+        int chunk_frames = 300;
+        int warmup_frames = 30;
+    };
+
+    bool parseArguments(int argc, char **argv, Options &options)
+    {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--out" && i + 1 < argc)
+                options.output_prefix = argv[++i];
+            else if (arg == "--format" && i + 1 < argc)
+            {
+                const std::string format = argv[++i];
+                if (format != "csv" && format != "json")
+                    return false;
+                options.json = format == "json";
+            }
+            else if (arg == "--threads" && i + 1 < argc)
+                options.threads = std::atoi(argv[++i]);
+            else if (arg == "--chunk" && i + 1 < argc)
+                options.chunk_frames = std::atoi(argv[++i]);
+            else if (arg == "--warmup" && i + 1 < argc)
+                options.warmup_frames = std::atoi(argv[++i]);
+            else if (arg == "--params" && i + 1 < argc)
+                options.params_file = argv[++i];
+            else
+                positional.push_back(arg);
+        }
+        if (positional.size() != 1 || options.chunk_frames <= 0 || options.warmup_frames < 0 || options.threads < 0)
+            return false;
+        options.input = positional[0];
+        if (options.threads == 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        return true;
+    }
+
+    // 一个工作块：序列 sequence_index 的 [warmup_begin, end) 帧，其中 [begin, end) 输出结果
+    struct WorkItem
+    {
+        int sequence_index;
+        int warmup_begin;
+        int begin;
+        int end;
+    };
+
+    struct ChunkResult
+    {
+        std::string hotspot_rows; // csv 热点行，或 json 帧行
+        std::string target_rows;  // csv 目标行
+        int frames = 0;
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+        bool done = false;
+    };
+
+    void appendHotspotCsv(std::ostringstream &out, const std::string &sequence, int frame, const HotSpot &spot)
+    {
+        out << sequence << ',' << frame << ',' << spot.id << ',' << spot.track_id << ','
+            << spot.pixel_centroid.x << ',' << spot.pixel_centroid.y << ',' << spot.area_pixels << ','
+            << spot.max_temperature << ',' << spot.mean_temperature << ',' << spot.rate_of_rise << ','
+            << spot.flicker_score << ',' << spot.fire_probability << ',' << spot.range_meters << ','
+            << spot.world_coord_approx.x << ',' << spot.world_coord_approx.y << ',' << spot.world_coord_approx.z << '\n';
+    }
+
+    void appendTargetCsv(std::ostringstream &out, const std::string &sequence, int frame, const SprayTarget &target,
+                         const CloudGimbalAngles &angles)
+    {
+        out << sequence << ',' << frame << ',' << target.id << ',' << (target.confirmed ? 1 : 0) << ','
+            << target.estimated_severity << ',' << target.final_pixel_aim_point.x << ',' << target.final_pixel_aim_point.y << ','
+            << target.final_world_aim_point_approx.x << ',' << target.final_world_aim_point_approx.y << ','
+            << target.final_world_aim_point_approx.z << ',' << angles.target_azimuth_degrees << ','
+            << angles.target_pitch_degrees << ',' << target.source_hotspot_ids.size() << '\n';
+    }
+
+    // 序列目录名只含路径字符，JSON 中只需转义反斜杠与引号
+    std::string jsonString(const std::string &s)
+    {
+        std::string escaped = "\"";
+        for (char c : s)
+        {
+            if (c == '\\' || c == '"')
+                escaped += '\\';
+            escaped += c;
+        }
+        return escaped + "\"";
+    }
+
+    void appendFrameJson(std::ostringstream &out, const std::string &sequence, int frame, float timestamp,
+                         const std::vector<HotSpot> &hot_spots, const std::vector<SprayTarget> &targets,
+                         const std::vector<CloudGimbalAngles> &angles)
+    {
+        out << "{\"sequence\":" << jsonString(sequence) << ",\"frame\":" << frame << ",\"timestamp\":" << timestamp << ",\"hotspots\":[";
+        for (size_t i = 0; i < hot_spots.size(); ++i)
+        {
+            const HotSpot &spot = hot_spots[i];
+            out << (i ? "," : "") << "{\"id\":" << spot.id << ",\"track_id\":" << spot.track_id
+                << ",\"x\":" << spot.pixel_centroid.x << ",\"y\":" << spot.pixel_centroid.y
+                << ",\"area\":" << spot.area_pixels << ",\"max_temperature\":" << spot.max_temperature
+                << ",\"mean_temperature\":" << spot.mean_temperature << ",\"rate_of_rise\":" << spot.rate_of_rise
+                << ",\"flicker_score\":" << spot.flicker_score << ",\"fire_probability\":" << spot.fire_probability
+                << ",\"range\":" << spot.range_meters << "}";
+        }
+        out << "],\"targets\":[";
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            const SprayTarget &target = targets[i];
+            out << (i ? "," : "") << "{\"id\":" << target.id << ",\"confirmed\":" << (target.confirmed ? "true" : "false")
+                << ",\"severity\":" << target.estimated_severity
+                << ",\"x\":" << target.final_pixel_aim_point.x << ",\"y\":" << target.final_pixel_aim_point.y
+                << ",\"azimuth\":" << angles[i].target_azimuth_degrees << ",\"pitch\":" << angles[i].target_pitch_degrees << "}";
+        }
+        out << "]}\n";
+    }
+
+    // 用工作线程的 FirePipeline 跑一个工作块
+    void processChunk(const RecordedSequence &sequence, const WorkItem &item, FirePipeline &pipeline, bool json, ChunkResult &result)
+    {
+        pipeline.reset();
+        pipeline.gray_min_temperature = sequence.min_temperature;
+        pipeline.gray_max_temperature = sequence.max_temperature;
+        const CameraParams &camera = pipeline.cameraParams();
+        GimbalState gimbal;
+        const OdometryState odometry;
+        cv::Mat frame;
+        FrameResult frame_result;
+        std::ostringstream hotspot_out, target_out;
+
+        for (int f = item.warmup_begin; f < item.end; ++f)
+        {
+            const int64 start = cv::getTickCount();
+            const float timestamp = f * sequence.frame_interval_seconds;
+            sequence.gimbalAnglesForFrame(f, gimbal.azimuth_degrees, gimbal.pitch_degrees);
+            if (!readThermalFrame(sequence.frame_paths[f], frame) ||
+                !pipeline.processFrame(frame, gimbal, odometry, timestamp, frame_result))
+                continue;
+
+            const std::vector<HotSpot> &hot_spots = frame_result.hot_spots;
+            const std::vector<SprayTarget> &targets = frame_result.spray_targets;
+            std::vector<CloudGimbalAngles> angles;
+            for (const auto &target : targets)
+            {
+                angles.push_back(calculateGimbalAngles(target.final_pixel_aim_point, frame_result.temperature_matrix.cols,
+                                                       frame_result.temperature_matrix.rows, camera.hfov_degrees, camera.vfov_degrees,
+                                                       gimbal.azimuth_degrees, gimbal.pitch_degrees,
+                                                       camera.nozzle_azimuth_offset, camera.nozzle_pitch_offset));
+            }
+
+            const double elapsed_ms = (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+            if (f < item.begin)
+                continue; // 预热帧只用于建立时域状态
+            result.frames++;
+            result.total_ms += elapsed_ms;
+            result.max_ms = std::max(result.max_ms, elapsed_ms);
+
+            if (json)
+            {
+                appendFrameJson(hotspot_out, sequence.directory, f, timestamp, hot_spots, targets, angles);
+            }
+            else
+            {
+                for (const auto &spot : hot_spots)
+                    appendHotspotCsv(hotspot_out, sequence.directory, f, spot);
+                for (size_t i = 0; i < targets.size(); ++i)
+                    appendTargetCsv(target_out, sequence.directory, f, targets[i], angles[i]);
+            }
+        }
+        result.hotspot_rows = hotspot_out.str();
+        result.target_rows = target_out.str();
+    }
+
+    bool loadSequences(const std::string &input, std::vector<RecordedSequence> &sequences)
+    {
+        std::vector<std::string> directories;
+        if (std::filesystem::is_directory(input))
+            directories.push_back(input);
+        else if (!readSequenceList(input, directories))
+            return false;
+
+        for (const auto &directory : directories)
+        {
+            RecordedSequence sequence;
+            if (loadRecordedSequence(directory, sequence))
+                sequences.push_back(sequence);
+        }
+        return !sequences.empty();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: batch_analyze <sequence_dir | sequence_list> [--out prefix] [--format csv|json]"
+                  << " [--threads N] [--chunk N] [--warmup N] [--params params.xml]" << std::endl;
+        return 1;
+    }
+
+    std::vector<RecordedSequence> sequences;
+    if (!loadSequences(options.input, sequences))
+    {
+        std::cerr << "Error: No recorded sequences found in " << options.input << std::endl;
+        return 1;
+    }
+
+    std::vector<WorkItem> work;
+    size_t total_frames = 0;
+    for (size_t s = 0; s < sequences.size(); ++s)
+    {
+        const int frame_count = static_cast<int>(sequences[s].frame_paths.size());
+        total_frames += frame_count;
+        for (int begin = 0; begin < frame_count; begin += options.chunk_frames)
+        {
+            WorkItem item;
+            item.sequence_index = static_cast<int>(s);
+            item.begin = begin;
+            item.end = std::min(begin + options.chunk_frames, frame_count);
+            item.warmup_begin = std::max(0, begin - options.warmup_frames);
+            work.push_back(item);
+        }
+    }
+    std::cout << "Processing " << sequences.size() << " sequences, " << total_frames << " frames in " << work.size()
+              << " chunks with " << options.threads << " threads." << std::endl;
+
+    std::ofstream hotspot_file, target_file;
+    if (options.json)
+    {
+        hotspot_file.open(options.output_prefix + ".jsonl");
+    }
+    else
+    {
+        hotspot_file.open(options.output_prefix + "_hotspots.csv");
+        target_file.open(options.output_prefix + "_targets.csv");
+        hotspot_file << "sequence,frame,id,track_id,x,y,area,max_temperature,mean_temperature,rate_of_rise,"
+                        "flicker_score,fire_probability,range,world_x,world_y,world_z\n";
+        target_file << "sequence,frame,id,confirmed,severity,x,y,world_x,world_y,world_z,azimuth,pitch,hotspot_count\n";
+    }
+    if (!hotspot_file.is_open() || (!options.json && !target_file.is_open()))
+    {
+        std::cerr << "Error: Could not open output files with prefix " << options.output_prefix << std::endl;
+        return 1;
+    }
+
+    // OpenCV 内部并行与工作线程叠加会造成过度订阅，工作线程内统一单线程执行
+    cv::setNumThreads(1);
+
+    std::vector<ChunkResult> results(work.size());
+    std::atomic<size_t> next_item(0);
+    std::mutex output_mutex;
+    size_t next_to_write = 0;
+    int written_frames = 0;
+    double total_frame_ms = 0.0, max_frame_ms = 0.0;
+    int classified_frames = 0, classifier_overruns = 0;
+    double max_inference_us = 0.0;
+
+    const int64 wall_start = cv::getTickCount();
+    auto worker = [&]()
+    {
+        // 每个工作线程配置一次流程，工作块之间只清空时域状态
+        FirePipeline pipeline;
+        {
+            std::lock_guard<std::mutex> lock(output_mutex);
+            pipeline.configure(options.params_file);
+        }
+        for (size_t i = next_item++; i < work.size(); i = next_item++)
+        {
+            ChunkResult result;
+            processChunk(sequences[work[i].sequence_index], work[i], pipeline, options.json, result);
+
+            // 按工作块顺序写出已完成的连续结果
+            std::lock_guard<std::mutex> lock(output_mutex);
+            results[i] = std::move(result);
+            results[i].done = true;
+            while (next_to_write < results.size() && results[next_to_write].done)
+            {
+                ChunkResult &ready = results[next_to_write];
+                hotspot_file << ready.hotspot_rows;
+                if (!options.json)
+                    target_file << ready.target_rows;
+                written_frames += ready.frames;
+                total_frame_ms += ready.total_ms;
+                max_frame_ms = std::max(max_frame_ms, ready.max_ms);
+                ready = ChunkResult();
+                ready.done = true;
+                ++next_to_write;
+            }
+        }
+
+        const BlobClassifier &classifier = pipeline.blobClassifier();
+        std::lock_guard<std::mutex> lock(output_mutex);
+        classified_frames += classifier.classifiedFrames();
+        classifier_overruns += classifier.budgetOverrunFrames();
+        max_inference_us = std::max(max_inference_us, classifier.maxInferenceMicroseconds());
+    };
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; ++t)
+        threads.emplace_back(worker);
+    for (auto &thread : threads)
+        thread.join();
+    const double wall_seconds = (cv::getTickCount() - wall_start) / cv::getTickFrequency();
+
+    std::cout << "Frames processed: " << written_frames << std::endl;
+    std::cout << "Wall time: " << wall_seconds << " s, throughput: "
+              << (wall_seconds > 0.0 ? written_frames / wall_seconds : 0.0) << " frames/s" << std::endl;
+    std::cout << "Per-frame pipeline time: mean " << (written_frames > 0 ? total_frame_ms / written_frames : 0.0)
+              << " ms, max " << max_frame_ms << " ms" << std::endl;
+    if (classified_frames > 0)
+    {
+        std::cout << "Blob classifier: max " << max_inference_us << " us, " << classifier_overruns << "/" << classified_frames
+                  << " frames over budget (" << BLOB_CLASSIFIER_BUDGET_MICROSECONDS << " us, includes warmup frames)" << std::endl;
+    }
+    std::cout << "Results written with prefix " << options.output_prefix << std::endl;
+    return 0;
+}
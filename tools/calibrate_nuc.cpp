@@ -0,0 +1,116 @@
+// tools/calibrate_nuc.cpp
+// 非均匀性校正 (NUC) 标定工具
+//
+// 用法：
+//   calibrate_nuc <冷面源帧目录> <热面源帧目录> <输出校正表.yml> [--max-deviation R] [--max-noise K]
+//
+// 两个目录分别存放镜头对准低温、高温均匀面源 (黑体或挡片) 时录制的若干帧 (格式见 src/sequence_io.h)。
+// 帧按主程序相同的方式读取 (16 位原始计数保持 16 位，否则为 8 位灰度)，不做缩放：
+// 校正表为探测器原生分辨率，与运行时在缩放之前所做的校正一致。逐像素求平均和时域标准差，然后：
+//   * 响应 (热 - 冷) 偏离中位数超过 R (默认 0.3) 或时域噪声超过中位数 K 倍 (默认 5) 的像素判为坏点
+//   * 其余像素计算两点校正系数，坏点指定最近的正常像素作为替换
+// 输出文件在 params.xml 的 nuc_calibration_file 中引用。
+
+#include "nuc_correction.h"
+#include "sequence_io.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // 读取目录中全部帧 (原生分辨率)，输出平均帧与逐像素时域标准差 (原始计数或灰度)
+    bool averageFrames(const std::string &directory, cv::Mat &mean, cv::Mat &stddev, int &frame_type)
+    {
+        RecordedSequence sequence;
+        if (!loadRecordedSequence(directory, sequence))
+            return false;
+
+        cv::Mat sum, sqsum, raw, frame;
+        int count = 0;
+        for (const auto &path : sequence.frame_paths)
+        {
+            if (!readThermalFrame(path, raw))
+                continue;
+            if (count == 0)
+            {
+                sum = cv::Mat::zeros(raw.size(), CV_64FC1);
+                sqsum = cv::Mat::zeros(raw.size(), CV_64FC1);
+                frame_type = raw.type();
+            }
+            else if (raw.size() != sum.size() || raw.type() != frame_type)
+            {
+                std::cerr << "Error: " << path << " differs in size or bit depth from the first frame, skipped." << std::endl;
+                continue;
+            }
+            raw.convertTo(frame, CV_64FC1);
+            sum += frame;
+            sqsum += frame.mul(frame);
+            ++count;
+        }
+        if (count == 0)
+            return false;
+
+        cv::Mat mean64 = sum / count;
+        cv::Mat variance = sqsum / count - mean64.mul(mean64);
+        cv::max(variance, 0.0, variance);
+        cv::sqrt(variance, variance);
+        mean64.convertTo(mean, CV_32FC1);
+        variance.convertTo(stddev, CV_32FC1);
+        std::cout << directory << ": " << count << " frames " << sum.cols << "x" << sum.rows
+                  << (frame_type == CV_16UC1 ? " (16-bit raw)" : " (8-bit gray)") << ", mean level " << cv::mean(mean)[0] << std::endl;
+        return true;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<std::string> positional;
+    float max_response_deviation = 0.3f;
+    float max_noise_ratio = 5.0f;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--max-deviation" && i + 1 < argc)
+            max_response_deviation = static_cast<float>(std::atof(argv[++i]));
+        else if (arg == "--max-noise" && i + 1 < argc)
+            max_noise_ratio = static_cast<float>(std::atof(argv[++i]));
+        else
+            positional.push_back(arg);
+    }
+    if (positional.size() != 3 || max_response_deviation <= 0.0f || max_noise_ratio <= 0.0f)
+    {
+        std::cerr << "Usage: calibrate_nuc <cold_frames_dir> <hot_frames_dir> <output.yml> "
+                  << "[--max-deviation R] [--max-noise K]" << std::endl;
+        return 1;
+    }
+
+    cv::Mat cold_mean, cold_noise, hot_mean, hot_noise;
+    int cold_type = -1, hot_type = -1;
+    if (!averageFrames(positional[0], cold_mean, cold_noise, cold_type) || !averageFrames(positional[1], hot_mean, hot_noise, hot_type))
+        return 1;
+    if (cold_type != hot_type)
+    {
+        std::cerr << "Error: Cold and hot reference frames must have the same bit depth." << std::endl;
+        return 1;
+    }
+
+    // 两组参考帧的噪声取较大者，任一温度下闪烁的像素都判为坏点
+    cv::Mat temporal_noise;
+    cv::max(cold_noise, hot_noise, temporal_noise);
+
+    NonUniformityCorrection nuc;
+    if (!computeTwoPointCorrection(cold_mean, hot_mean, temporal_noise, max_response_deviation, max_noise_ratio, nuc))
+        return 1;
+
+    double min_gain, max_gain;
+    cv::minMaxLoc(nuc.gain, &min_gain, &max_gain);
+    std::cout << "Gain range: [" << min_gain << ", " << max_gain << "], bad pixels: " << nuc.bad_pixels.rows
+              << " (" << 100.0 * nuc.bad_pixels.rows / nuc.gain.total() << "%)" << std::endl;
+
+    if (!writeNonUniformityCorrection(positional[2], nuc))
+        return 1;
+    std::cout << "NUC calibration written to " << positional[2] << std::endl;
+    return 0;
+}
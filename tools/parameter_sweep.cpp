@@ -0,0 +1,351 @@
+// tools/parameter_sweep.cpp
+// 检测/分组参数扫描工具
+//
+// 用法：
+//   parameter_sweep <序列列表> [--thresholds a,b,..] [--min-areas a,b,..] [--kernels a,b,..] [--grouping a,b,..]
+//                   [--random N] [--seed N] [--threads N] [--out sweep.csv] [--params params.xml]
+//
+// 序列列表每行一个带火焰标注框的录制序列目录 (格式见 src/sequence_io.h)。
+// 所有帧只读取、转换一次：按 --params 配置的 FirePipeline::prepareFrame (降噪、NUC、LUT/Planck 定标或灰度映射、
+// 帧间运动、升温速率) 生成与检测参数无关的中间结果，在内存中共享；各参数组用自己的流程只重跑 detectFrame，
+// 因此静态/区域掩码、阈值图、分类器、轨迹剔除、背景模型 (参数文件中启用时) 与瞄准选择都与正式流程一致。
+// 默认对各列表做网格搜索 (列表缺省时使用 utils.h 中的当前常量)；--random N 时在各列表的最小、最大值之间均匀采样 N 组
+// (核尺寸取奇数)。参数组由 --threads 个工作线程并行评估。
+//
+// 每组参数输出 (标注框在原始图像坐标中，热点质心与瞄准点先映射回原始坐标再比较)：
+//   precision  质心落在标注框内的热点占全部热点的比例
+//   recall     被至少一个热点质心覆盖的标注框占全部标注框的比例
+//   aim error  有标注框且流程选定瞄准目标的帧中，瞄准点到最近标注框中心的平均像素距离
+//   cost       单帧 detectFrame (检测到瞄准) 的平均耗时 (并行运行时受内存带宽影响，用于相对比较)
+// 结果按 F1 降序打印，并写入 CSV。
+
+#include "fire_pipeline.h"
+#include "sequence_io.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string sequence_list;
+        std::string output_file = "sweep.csv";
+        std::string params_file = "../config/params.xml";
+        std::vector<float> thresholds{FIRE_TEMPERATURE_THRESHOLD_CELSIUS};
+        std::vector<float> min_areas{static_cast<float>(MIN_HOTSPOT_AREA_PIXELS)};
+        std::vector<float> kernels{static_cast<float>(MORPHOLOGY_KERNEL_SIZE)};
+        std::vector<float> grouping{MAX_GROUPING_DISTANCE_METERS};
+        int random_samples = 0;
+        int seed = 12345;
+        int threads = 0;
+    };
+
+    bool parseList(const std::string &text, std::vector<float> &values)
+    {
+        values.clear();
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+        {
+            if (!item.empty())
+                values.push_back(static_cast<float>(std::atof(item.c_str())));
+        }
+        return !values.empty();
+    }
+
+    bool parseArguments(int argc, char **argv, Options &options)
+    {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            bool ok = true;
+            if (arg == "--thresholds" && i + 1 < argc)
+                ok = parseList(argv[++i], options.thresholds);
+            else if (arg == "--min-areas" && i + 1 < argc)
+                ok = parseList(argv[++i], options.min_areas);
+            else if (arg == "--kernels" && i + 1 < argc)
+                ok = parseList(argv[++i], options.kernels);
+            else if (arg == "--grouping" && i + 1 < argc)
+                ok = parseList(argv[++i], options.grouping);
+            else if (arg == "--random" && i + 1 < argc)
+                options.random_samples = std::atoi(argv[++i]);
+            else if (arg == "--seed" && i + 1 < argc)
+                options.seed = std::atoi(argv[++i]);
+            else if (arg == "--threads" && i + 1 < argc)
+                options.threads = std::atoi(argv[++i]);
+            else if (arg == "--out" && i + 1 < argc)
+                options.output_file = argv[++i];
+            else if (arg == "--params" && i + 1 < argc)
+                options.params_file = argv[++i];
+            else
+                positional.push_back(arg);
+            if (!ok)
+                return false;
+        }
+        if (positional.size() != 1 || options.random_samples < 0 || options.threads < 0)
+            return false;
+        options.sequence_list = positional[0];
+        if (options.threads == 0)
+            options.threads = std::max(1u, std::thread::hardware_concurrency());
+        return true;
+    }
+
+    // 与参数无关、所有参数组共享的逐帧中间结果
+    struct PreparedFrame
+    {
+        FrameInputs inputs; // prepareFrame 输出 (矩阵已深拷贝)
+        GimbalState gimbal;
+        std::vector<cv::Rect> fire_boxes;
+    };
+
+    struct PreparedSequence
+    {
+        std::string directory;
+        std::vector<PreparedFrame> frames;
+    };
+
+    bool prepareSequences(const std::string &list_file, const std::string &params_file, std::vector<PreparedSequence> &prepared)
+    {
+        std::vector<std::string> directories;
+        if (!readSequenceList(list_file, directories))
+            return false;
+
+        FirePipeline pipeline;
+        if (!pipeline.configure(params_file))
+            return false;
+
+        size_t bytes = 0;
+        cv::Mat frame;
+        FrameInputs inputs;
+        for (const auto &directory : directories)
+        {
+            RecordedSequence sequence;
+            if (!loadRecordedSequence(directory, sequence))
+                continue;
+            std::cout << "Loading " << directory << " (" << sequence.frame_paths.size() << " frames)" << std::endl;
+
+            pipeline.reset();
+            pipeline.gray_min_temperature = sequence.min_temperature;
+            pipeline.gray_max_temperature = sequence.max_temperature;
+            PreparedSequence seq;
+            seq.directory = directory;
+            for (int f = 0; f < static_cast<int>(sequence.frame_paths.size()); ++f)
+            {
+                PreparedFrame prepared_frame;
+                sequence.gimbalAnglesForFrame(f, prepared_frame.gimbal.azimuth_degrees, prepared_frame.gimbal.pitch_degrees);
+                if (!readThermalFrame(sequence.frame_paths[f], frame) ||
+                    !pipeline.prepareFrame(frame, prepared_frame.gimbal, f * sequence.frame_interval_seconds, inputs))
+                    continue;
+                prepared_frame.inputs = inputs;
+                prepared_frame.inputs.temperature_matrix = inputs.temperature_matrix.clone();
+                prepared_frame.inputs.rising_mask = inputs.rising_mask.clone();
+                prepared_frame.inputs.rise_rate = inputs.rise_rate.clone();
+                prepared_frame.fire_boxes = sequence.fireBoxesForFrame(f);
+                for (const cv::Mat *m : {&prepared_frame.inputs.temperature_matrix, &prepared_frame.inputs.rising_mask,
+                                         &prepared_frame.inputs.rise_rate})
+                    bytes += m->total() * m->elemSize();
+                seq.frames.push_back(std::move(prepared_frame));
+            }
+            if (!seq.frames.empty())
+                prepared.push_back(std::move(seq));
+        }
+        std::cout << "Prepared frames use " << bytes / (1024.0 * 1024.0) << " MB." << std::endl;
+        return !prepared.empty();
+    }
+
+    struct ParameterSet
+    {
+        DetectionParameters detection;
+        float grouping_distance;
+    };
+
+    struct SweepResult
+    {
+        ParameterSet params;
+        int true_hotspots = 0;
+        int false_hotspots = 0;
+        int boxes = 0;
+        int boxes_found = 0;
+        double aim_error_sum = 0.0;
+        int aimed_frames = 0;
+        double total_ms = 0.0;
+        int frames = 0;
+
+        double precision() const { return true_hotspots + false_hotspots > 0 ? static_cast<double>(true_hotspots) / (true_hotspots + false_hotspots) : 0.0; }
+        double recall() const { return boxes > 0 ? static_cast<double>(boxes_found) / boxes : 0.0; }
+        double f1() const
+        {
+            const double p = precision(), r = recall();
+            return p + r > 0.0 ? 2.0 * p * r / (p + r) : 0.0;
+        }
+        double aimError() const { return aimed_frames > 0 ? aim_error_sum / aimed_frames : -1.0; }
+        double frameMs() const { return frames > 0 ? total_ms / frames : 0.0; }
+    };
+
+    std::vector<ParameterSet> buildParameterSets(const Options &options)
+    {
+        std::vector<ParameterSet> sets;
+        auto make = [](float threshold, float min_area, float kernel, float grouping)
+        {
+            ParameterSet set;
+            set.detection.temperature_threshold = threshold;
+            set.detection.min_area_pixels = min_area;
+            set.detection.morphology_kernel_size = std::max(1, static_cast<int>(kernel) | 1); // 核尺寸取奇数
+            set.grouping_distance = grouping;
+            return set;
+        };
+
+        if (options.random_samples > 0)
+        {
+            cv::RNG rng(options.seed);
+            auto sample = [&rng](const std::vector<float> &values)
+            {
+                const auto range = std::minmax_element(values.begin(), values.end());
+                return rng.uniform(*range.first, std::nextafter(*range.second, std::numeric_limits<float>::max()));
+            };
+            for (int i = 0; i < options.random_samples; ++i)
+                sets.push_back(make(sample(options.thresholds), sample(options.min_areas), sample(options.kernels), sample(options.grouping)));
+            return sets;
+        }
+
+        for (float threshold : options.thresholds)
+            for (float min_area : options.min_areas)
+                for (float kernel : options.kernels)
+                    for (float grouping : options.grouping)
+                        sets.push_back(make(threshold, min_area, kernel, grouping));
+        return sets;
+    }
+
+    // 检测结果在无畸变坐标中，标注框在原始图像坐标中
+    cv::Point toRawPixel(const FirePipeline &pipeline, const cv::Point2f &point)
+    {
+        std::vector<cv::Point2f> points{point};
+        pipeline.lensUndistortion().distortPoints(points);
+        return cv::Point(cvRound(points[0].x), cvRound(points[0].y));
+    }
+
+    void evaluate(const std::vector<PreparedSequence> &sequences, FirePipeline &pipeline, SweepResult &result)
+    {
+        pipeline.setDetectionParameters(result.params.detection, result.params.grouping_distance);
+        const OdometryState odometry;
+        FrameResult frame_result;
+        for (const auto &sequence : sequences)
+        {
+            pipeline.reset(); // 跟踪、背景与火情地图状态随参数组变化，每个序列重新开始
+            for (const auto &frame : sequence.frames)
+            {
+                const int64 start = cv::getTickCount();
+                pipeline.detectFrame(frame.inputs, frame.gimbal, odometry, frame_result);
+                result.total_ms += (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+                result.frames++;
+
+                std::vector<cv::Point> centroids;
+                for (const auto &spot : frame_result.hot_spots)
+                    centroids.push_back(toRawPixel(pipeline, spot.pixel_centroid));
+                for (const auto &c : centroids)
+                {
+                    bool inside = false;
+                    for (const auto &box : frame.fire_boxes)
+                        inside = inside || box.contains(c);
+                    (inside ? result.true_hotspots : result.false_hotspots)++;
+                }
+                for (const auto &box : frame.fire_boxes)
+                {
+                    result.boxes++;
+                    if (std::any_of(centroids.begin(), centroids.end(), [&box](const cv::Point &c) { return box.contains(c); }))
+                        result.boxes_found++;
+                }
+                if (!frame.fire_boxes.empty() && frame_result.aim_target_index >= 0)
+                {
+                    const cv::Point2f aim = toRawPixel(pipeline, frame_result.spray_targets[frame_result.aim_target_index].final_pixel_aim_point);
+                    double best = std::numeric_limits<double>::max();
+                    for (const auto &box : frame.fire_boxes)
+                    {
+                        const cv::Point2f center(box.x + 0.5f * box.width, box.y + 0.5f * box.height);
+                        best = std::min(best, static_cast<double>(cv::norm(aim - center)));
+                    }
+                    result.aim_error_sum += best;
+                    result.aimed_frames++;
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: parameter_sweep <sequence_list> [--thresholds a,b,..] [--min-areas a,b,..] [--kernels a,b,..]"
+                  << " [--grouping a,b,..] [--random N] [--seed N] [--threads N] [--out sweep.csv] [--params params.xml]" << std::endl;
+        return 1;
+    }
+
+    std::vector<PreparedSequence> sequences;
+    if (!prepareSequences(options.sequence_list, options.params_file, sequences))
+    {
+        std::cerr << "Error: No labeled sequences loaded from " << options.sequence_list << std::endl;
+        return 1;
+    }
+    std::vector<ParameterSet> sets = buildParameterSets(options);
+    std::vector<SweepResult> results(sets.size());
+    for (size_t i = 0; i < sets.size(); ++i)
+        results[i].params = sets[i];
+    std::cout << "Evaluating " << sets.size() << " parameter sets with " << options.threads << " threads." << std::endl;
+
+    // 参数组之间并行，组内逐帧顺序执行 (跟踪需要连续帧)
+    cv::setNumThreads(1);
+    std::atomic<size_t> next_set(0);
+    std::mutex configure_mutex;
+    auto worker = [&]()
+    {
+        // 每个工作线程配置一次流程，参数组之间只替换检测参数并清空时域状态
+        FirePipeline pipeline;
+        {
+            std::lock_guard<std::mutex> lock(configure_mutex);
+            pipeline.configure(options.params_file);
+        }
+        for (size_t i = next_set++; i < results.size(); i = next_set++)
+            evaluate(sequences, pipeline, results[i]);
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < options.threads; ++t)
+        threads.emplace_back(worker);
+    for (auto &thread : threads)
+        thread.join();
+
+    std::sort(results.begin(), results.end(), [](const SweepResult &a, const SweepResult &b) { return a.f1() > b.f1(); });
+
+    std::ofstream out(options.output_file);
+    if (out.is_open())
+        out << "threshold,min_area,kernel,grouping,precision,recall,f1,aim_error_px,frame_ms\n";
+    else
+        std::cerr << "Error: Could not open output file " << options.output_file << std::endl;
+    std::cout << "threshold  min_area  kernel  grouping  precision  recall  f1  aim_error_px  frame_ms" << std::endl;
+    for (const auto &r : results)
+    {
+        std::ostringstream row;
+        row << r.params.detection.temperature_threshold << ',' << r.params.detection.min_area_pixels << ','
+            << r.params.detection.morphology_kernel_size << ',' << r.params.grouping_distance << ','
+            << r.precision() << ',' << r.recall() << ',' << r.f1() << ',' << r.aimError() << ',' << r.frameMs();
+        if (out.is_open())
+            out << row.str() << '\n';
+        std::string line = row.str();
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::cout << line << std::endl;
+    }
+    std::cout << "Results written to " << options.output_file << std::endl;
+    return 0;
+}
@@ -0,0 +1,406 @@
+// tools/stress_detection.cpp
+// 检测流程最坏情况压力测试
+//
+// 用法：
+//   stress_detection [--size WxH] [--repeat N] [--fuzz N] [--seed N] [--compact] [--split] [--no-caps] [--budget-ms X]
+//
+// 生成病态温度帧，逐阶段 (含自运动估计) 记录最坏/中位耗时与进程峰值内存：
+//   embers           数千个孤立的单像素高温点 (开运算全部去除)
+//   ember_grid       规则排列的小热块，轮廓数远超 MAX_CONTOURS_EXAMINED
+//   checkerboard_1px 单像素棋盘格
+//   checkerboard_8px 8 像素棋盘格 (对角相接的热块)
+//   full_frame       整帧高温并带多个温度峰 (单个巨大轮廓，--split 时触发拆分)
+//   saturated_plateau 两个大面积饱和 (削顶) 火源连成一个轮廓，--split 时每个平台只应产生一个峰值候选
+//   noise            均匀随机温度
+//   fuzz             --fuzz 次随机组合 (圆盘、矩形、散点、噪声)，报告其中最慢的一帧
+// --compact 时温度矩阵以 CV_16SC1 (0.1 °C) 运行，--split 时启用粘连热点拆分，
+// --no-caps 时取消轮廓/热点数上限 (MAX_CONTOURS_EXAMINED、MAX_HOTSPOTS_KEPT)，用于对比上限的作用；
+// 热点数上限与主流程一样在检测之后应用 (见 evictLeastSevereHotspots)，计入 group 阶段。
+// 每帧检查热点数不超过上限；指定 --budget-ms 时任一场景的最坏单帧耗时超出预算、
+// 或自运动估计最坏耗时超出 EGO_MOTION_BUDGET_MS 即返回 1。
+
+#include "ego_motion.h"
+#include "range_estimation.h"
+#include "temperature_conversion.h"
+#include "vision_processing.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+    struct Options
+    {
+        cv::Size frame_size{384, 288};
+        int repeat = 20;
+        int fuzz_iterations = 200;
+        int seed = 12345;
+        bool compact = false;
+        bool split = false;
+        bool caps = true;
+        int max_hotspots_kept = MAX_HOTSPOTS_KEPT;
+        double budget_ms = 0.0; // 0 表示不检查
+    };
+
+    bool parseArguments(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            const bool has_value = i + 1 < argc;
+            if (arg == "--size" && has_value)
+            {
+                if (std::sscanf(argv[++i], "%dx%d", &options.frame_size.width, &options.frame_size.height) != 2)
+                    return false;
+            }
+            else if (arg == "--repeat" && has_value)
+                options.repeat = std::atoi(argv[++i]);
+            else if (arg == "--fuzz" && has_value)
+                options.fuzz_iterations = std::atoi(argv[++i]);
+            else if (arg == "--seed" && has_value)
+                options.seed = std::atoi(argv[++i]);
+            else if (arg == "--budget-ms" && has_value)
+                options.budget_ms = std::atof(argv[++i]);
+            else if (arg == "--compact")
+                options.compact = true;
+            else if (arg == "--split")
+                options.split = true;
+            else if (arg == "--no-caps")
+                options.caps = false;
+            else
+                return false;
+        }
+        return options.frame_size.width > 0 && options.frame_size.height > 0 && options.repeat > 0 && options.fuzz_iterations >= 0;
+    }
+
+    // 进程峰值常驻内存 (字节)，单调不减；每个场景结束后读取，增量即该场景新增的峰值
+    size_t peakResidentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+            return counters.PeakWorkingSetSize;
+        return 0;
+#else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0)
+            return 0;
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+    }
+
+    const float BACKGROUND_CELSIUS = 25.0f;
+    const float HOT_CELSIUS = 450.0f;
+
+    cv::Mat backgroundFrame(const cv::Size &size)
+    {
+        return cv::Mat(size, CV_32FC1, cv::Scalar(BACKGROUND_CELSIUS));
+    }
+
+    cv::Mat embersFrame(const cv::Size &size, cv::RNG &rng)
+    {
+        cv::Mat frame = backgroundFrame(size);
+        const int count = size.area() / 20;
+        for (int i = 0; i < count; ++i)
+            frame.at<float>(rng.uniform(0, size.height), rng.uniform(0, size.width)) = HOT_CELSIUS;
+        return frame;
+    }
+
+    // 8x8 热块间隔 6 像素：间隔大于闭运算核，热块不会合并，面积 (49) 高于 MIN_HOTSPOT_AREA_PIXELS
+    cv::Mat emberGridFrame(const cv::Size &size)
+    {
+        cv::Mat frame = backgroundFrame(size);
+        for (int y = 2; y + 8 <= size.height; y += 14)
+            for (int x = 2; x + 8 <= size.width; x += 14)
+                frame(cv::Rect(x, y, 8, 8)).setTo(HOT_CELSIUS);
+        return frame;
+    }
+
+    cv::Mat checkerboardFrame(const cv::Size &size, int cell)
+    {
+        cv::Mat frame = backgroundFrame(size);
+        for (int y = 0; y < size.height; ++y)
+        {
+            float *t = frame.ptr<float>(y);
+            for (int x = 0; x < size.width; ++x)
+                if (((x / cell) + (y / cell)) % 2 == 0)
+                    t[x] = HOT_CELSIUS;
+        }
+        return frame;
+    }
+
+    cv::Mat fullFrameBlob(const cv::Size &size)
+    {
+        cv::Mat frame(size, CV_32FC1);
+        for (int y = 0; y < size.height; ++y)
+        {
+            float *t = frame.ptr<float>(y);
+            for (int x = 0; x < size.width; ++x)
+                t[x] = 350.0f + 150.0f * std::sin(0.08f * x) * std::sin(0.08f * y);
+        }
+        return frame;
+    }
+
+    // 热区内两个削顶到同一饱和温度的大圆盘，之间的温度低于平台，拆分时应得到两个峰值
+    cv::Mat saturatedPlateauFrame(const cv::Size &size)
+    {
+        const float SATURATED_CELSIUS = 650.0f;
+        cv::Mat frame = backgroundFrame(size);
+        const cv::Point center(size.width / 2, size.height / 2);
+        const int radius = std::max(1, std::min(size.width, size.height) / 4);
+        cv::ellipse(frame, center, cv::Size(size.width * 2 / 5, size.height / 3), 0.0, 0.0, 360.0, cv::Scalar(300.0), cv::FILLED);
+        cv::circle(frame, center - cv::Point(size.width / 5, 0), radius, cv::Scalar(SATURATED_CELSIUS), cv::FILLED);
+        cv::circle(frame, center + cv::Point(size.width / 5, 0), radius, cv::Scalar(SATURATED_CELSIUS), cv::FILLED);
+        return frame;
+    }
+
+    cv::Mat noiseFrame(const cv::Size &size, cv::RNG &rng)
+    {
+        cv::Mat frame(size, CV_32FC1);
+        rng.fill(frame, cv::RNG::UNIFORM, 0.0, 600.0);
+        return frame;
+    }
+
+    cv::Mat fuzzFrame(const cv::Size &size, cv::RNG &rng)
+    {
+        cv::Mat frame = backgroundFrame(size);
+        const int shapes = rng.uniform(0, 400);
+        for (int i = 0; i < shapes; ++i)
+        {
+            const cv::Point center(rng.uniform(0, size.width), rng.uniform(0, size.height));
+            const double temperature = rng.uniform(100.0, 800.0);
+            switch (rng.uniform(0, 3))
+            {
+            case 0:
+                cv::circle(frame, center, rng.uniform(1, 40), cv::Scalar(temperature), cv::FILLED);
+                break;
+            case 1:
+                cv::rectangle(frame, cv::Rect(center, cv::Size(rng.uniform(1, 60), rng.uniform(1, 60))), cv::Scalar(temperature), cv::FILLED);
+                break;
+            default:
+                frame.at<float>(center) = static_cast<float>(temperature);
+                break;
+            }
+        }
+        if (rng.uniform(0, 2) == 1)
+        {
+            cv::Mat noise(size, CV_32FC1);
+            rng.fill(noise, cv::RNG::NORMAL, 0.0, rng.uniform(1.0, 100.0));
+            frame += noise;
+        }
+        return frame;
+    }
+
+    enum Stage
+    {
+        STAGE_CONVERT,
+        STAGE_MOTION,
+        STAGE_MASK,
+        STAGE_MORPHOLOGY,
+        STAGE_CONTOURS,
+        STAGE_STATISTICS,
+        STAGE_GROUPING,
+        STAGE_TOTAL,
+        STAGE_COUNT
+    };
+    const char *const STAGE_NAMES[STAGE_COUNT] = {"convert", "motion", "mask", "morph", "contours", "stats", "group", "total"};
+
+    struct ScenarioResult
+    {
+        std::string name;
+        std::vector<double> samples[STAGE_COUNT];
+        int max_contours_found = 0;
+        int max_contours_examined = 0;
+        int max_hotspots = 0;
+        int max_evicted = 0;
+        size_t peak_bytes = 0;
+        bool cap_violated = false;
+
+        double worst(int stage) const { return samples[stage].empty() ? 0.0 : *std::max_element(samples[stage].begin(), samples[stage].end()); }
+        double median(int stage) const
+        {
+            if (samples[stage].empty())
+                return 0.0;
+            std::vector<double> sorted = samples[stage];
+            std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+            return sorted[sorted.size() / 2];
+        }
+    };
+
+    double elapsedMs(int64 start)
+    {
+        return (cv::getTickCount() - start) * 1000.0 / cv::getTickFrequency();
+    }
+
+    void runFrame(const cv::Mat &frame, const Options &options, const DetectionAuxInputs &base_inputs,
+                  EgoMotionEstimator &ego_motion, ScenarioResult &result)
+    {
+        const cv::Mat camera_matrix = (cv::Mat_<double>(3, 3) << 500.0, 0.0, frame.cols / 2.0, 0.0, 500.0, frame.rows / 2.0, 0.0, 0.0, 1.0);
+        FixedRangeProvider range_provider;
+        DetectionStageTimes times;
+        DetectionAuxInputs detection_inputs = base_inputs;
+        detection_inputs.stage_times = &times;
+
+        const int64 total_start = cv::getTickCount();
+        cv::Mat temperature = frame;
+        if (options.compact)
+            convertTemperatureFormat(frame, temperature, CV_16SC1);
+        const double convert_ms = elapsedMs(total_start);
+        const FrameMotion motion = ego_motion.estimate(temperature);
+
+        std::vector<HotSpot> hot_spots = detectAndFilterHotspots(temperature, camera_matrix, range_provider, detection_inputs);
+        const int64 grouping_start = cv::getTickCount();
+        const int evicted = evictLeastSevereHotspots(hot_spots, options.max_hotspots_kept);
+        determineSprayTargets(hot_spots, MAX_GROUPING_DISTANCE_METERS);
+        const double grouping_ms = elapsedMs(grouping_start);
+
+        result.samples[STAGE_CONVERT].push_back(convert_ms);
+        result.samples[STAGE_MOTION].push_back(motion.estimate_ms);
+        result.samples[STAGE_MASK].push_back(times.mask_ms);
+        result.samples[STAGE_MORPHOLOGY].push_back(times.morphology_ms);
+        result.samples[STAGE_CONTOURS].push_back(times.contours_ms);
+        result.samples[STAGE_STATISTICS].push_back(times.statistics_ms);
+        result.samples[STAGE_GROUPING].push_back(grouping_ms);
+        result.samples[STAGE_TOTAL].push_back(elapsedMs(total_start));
+        result.max_contours_found = std::max(result.max_contours_found, times.contours_found);
+        result.max_contours_examined = std::max(result.max_contours_examined, times.contours_examined);
+        result.max_hotspots = std::max(result.max_hotspots, static_cast<int>(hot_spots.size()));
+        result.max_evicted = std::max(result.max_evicted, evicted);
+        if (times.contours_examined > base_inputs.params.max_contours_examined ||
+            static_cast<int>(hot_spots.size()) > options.max_hotspots_kept)
+            result.cap_violated = true;
+    }
+
+    void printResult(const ScenarioResult &result, size_t previous_peak_bytes)
+    {
+        std::cout << std::left << std::setw(18) << result.name << std::right << std::fixed << std::setprecision(2);
+        for (int stage = 0; stage < STAGE_COUNT; ++stage)
+            std::cout << std::setw(9) << result.worst(stage) << '/' << std::setw(7) << std::left << result.median(stage) << std::right;
+        std::cout << std::setw(8) << result.max_contours_found << std::setw(6) << result.max_contours_examined
+                  << std::setw(6) << result.max_hotspots << std::setw(6) << result.max_evicted
+                  << std::setw(10) << std::setprecision(1) << result.peak_bytes / (1024.0 * 1024.0)
+                  << " (+" << (result.peak_bytes - std::min(result.peak_bytes, previous_peak_bytes)) / 1024.0 << " KB)" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: stress_detection [--size WxH] [--repeat N] [--fuzz N] [--seed N] [--compact] [--split]"
+                  << " [--no-caps] [--budget-ms X]" << std::endl;
+        return 2;
+    }
+    cv::setNumThreads(1); // 测量单线程最坏耗时
+
+    DetectionAuxInputs base_inputs;
+    base_inputs.split.enabled = options.split;
+    if (!options.caps)
+    {
+        base_inputs.params.max_contours_examined = INT_MAX;
+        options.max_hotspots_kept = INT_MAX;
+    }
+
+    cv::RNG rng(options.seed);
+    struct Scenario
+    {
+        std::string name;
+        cv::Mat frame;
+    };
+    const std::vector<Scenario> scenarios = {
+        {"embers", embersFrame(options.frame_size, rng)},
+        {"ember_grid", emberGridFrame(options.frame_size)},
+        {"checkerboard_1px", checkerboardFrame(options.frame_size, 1)},
+        {"checkerboard_8px", checkerboardFrame(options.frame_size, 8)},
+        {"full_frame", fullFrameBlob(options.frame_size)},
+        {"saturated_plateau", saturatedPlateauFrame(options.frame_size)},
+        {"noise", noiseFrame(options.frame_size, rng)},
+    };
+
+    std::cout << "Frame " << options.frame_size.width << "x" << options.frame_size.height
+              << (options.compact ? ", CV_16SC1" : ", CV_32FC1") << (options.split ? ", split" : "")
+              << (options.caps ? ", caps " + std::to_string(MAX_CONTOURS_EXAMINED) + "/" + std::to_string(MAX_HOTSPOTS_KEPT) : ", no caps")
+              << "; per stage: worst/median ms" << std::endl;
+    std::cout << std::left << std::setw(18) << "scenario" << std::right;
+    for (int stage = 0; stage < STAGE_COUNT; ++stage)
+        std::cout << std::setw(17) << STAGE_NAMES[stage];
+    std::cout << std::setw(8) << "found" << std::setw(6) << "exam" << std::setw(6) << "kept" << std::setw(6) << "evict"
+              << std::setw(10) << "peak MB" << std::endl;
+
+    std::vector<ScenarioResult> results;
+    size_t previous_peak_bytes = peakResidentBytes();
+    for (const auto &scenario : scenarios)
+    {
+        ScenarioResult result;
+        result.name = scenario.name;
+        EgoMotionEstimator ego_motion;
+        for (int i = 0; i < options.repeat; ++i)
+            runFrame(scenario.frame, options, base_inputs, ego_motion, result);
+        result.peak_bytes = peakResidentBytes();
+        printResult(result, previous_peak_bytes);
+        previous_peak_bytes = result.peak_bytes;
+        results.push_back(result);
+    }
+
+    if (options.fuzz_iterations > 0)
+    {
+        ScenarioResult fuzz;
+        fuzz.name = "fuzz";
+        double slowest_ms = -1.0;
+        int slowest_iteration = -1;
+        EgoMotionEstimator ego_motion;
+        for (int i = 0; i < options.fuzz_iterations; ++i)
+        {
+            runFrame(fuzzFrame(options.frame_size, rng), options, base_inputs, ego_motion, fuzz);
+            if (fuzz.samples[STAGE_TOTAL].back() > slowest_ms)
+            {
+                slowest_ms = fuzz.samples[STAGE_TOTAL].back();
+                slowest_iteration = i;
+            }
+        }
+        fuzz.peak_bytes = peakResidentBytes();
+        printResult(fuzz, previous_peak_bytes);
+        std::cout << "Slowest fuzz frame: iteration " << slowest_iteration << " (seed " << options.seed << ")" << std::endl;
+        results.push_back(fuzz);
+    }
+
+    int failures = 0;
+    for (const auto &result : results)
+    {
+        if (result.cap_violated)
+        {
+            std::cout << "[FAIL] " << result.name << ": contour/hotspot cap exceeded" << std::endl;
+            ++failures;
+        }
+        if (options.budget_ms > 0.0 && result.worst(STAGE_TOTAL) > options.budget_ms)
+        {
+            std::cout << "[FAIL] " << result.name << ": worst frame " << result.worst(STAGE_TOTAL) << " ms exceeds budget "
+                      << options.budget_ms << " ms" << std::endl;
+            ++failures;
+        }
+        if (options.budget_ms > 0.0 && result.worst(STAGE_MOTION) > EGO_MOTION_BUDGET_MS)
+        {
+            std::cout << "[FAIL] " << result.name << ": worst ego motion estimate " << result.worst(STAGE_MOTION)
+                      << " ms exceeds budget " << EGO_MOTION_BUDGET_MS << " ms" << std::endl;
+            ++failures;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,335 @@
+// tools/train_blob_classifier.cpp
+// 热点分类器离线训练/评估工具
+//
+// 用法：
+//   train_blob_classifier <序列列表> <输出模型.yml> [--hidden N] [--epochs N] [--params params.xml]
+//   train_blob_classifier --eval <模型.yml> <序列列表> [--params params.xml]
+//
+// 序列列表每行一个录制序列目录 (格式见 src/sequence_io.h)。每个序列用一个 FirePipeline 处理
+// (与主程序完全相同的流程，含自运动估计、升温速率、跟踪/闪烁分析)，质心落在标注火焰框内的热点为正样本。
+// 按序列划分验证集 (每 5 个序列取 1 个；不足 5 个时取最后一个)，同一序列的相邻帧不会同时出现在训练集和验证集中。
+// 训练后输出验证集的准确率、精确率、召回率和每帧推理耗时。
+
+#include "blob_classifier.h"
+#include "fire_pipeline.h"
+#include "sequence_io.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Dataset
+    {
+        cv::Mat features;            // N x D
+        std::vector<float> labels;   // 0/1
+        std::vector<int> frame_keys; // 样本所属帧 (用于按帧统计推理耗时)
+        std::vector<int> sequence_ids; // 样本所属序列 (用于按序列划分验证集)
+        int sequence_count = 0;
+    };
+
+    struct Options
+    {
+        std::string sequence_list;
+        std::string model_file;
+        std::string params_file = "../config/params.xml";
+        bool eval_only = false;
+        int hidden_units = 16;
+        int epochs = 400;
+    };
+
+    bool parseArguments(int argc, char **argv, Options &options)
+    {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            if (arg == "--eval")
+                options.eval_only = true;
+            else if (arg == "--hidden" && i + 1 < argc)
+                options.hidden_units = std::atoi(argv[++i]);
+            else if (arg == "--epochs" && i + 1 < argc)
+                options.epochs = std::atoi(argv[++i]);
+            else if (arg == "--params" && i + 1 < argc)
+                options.params_file = argv[++i];
+            else
+                positional.push_back(arg);
+        }
+        if (positional.size() != 2 || options.hidden_units <= 0 || options.epochs <= 0)
+            return false;
+        if (options.eval_only)
+        {
+            options.model_file = positional[0];
+            options.sequence_list = positional[1];
+        }
+        else
+        {
+            options.sequence_list = positional[0];
+            options.model_file = positional[1];
+        }
+        return true;
+    }
+
+    // 用与主程序相同的 FirePipeline 跑一遍序列，提取每个热点的特征与标签
+    void collectSequence(const RecordedSequence &sequence, const std::string &params_file, int sequence_index, Dataset &dataset)
+    {
+        FirePipeline pipeline;
+        pipeline.gray_min_temperature = sequence.min_temperature;
+        pipeline.gray_max_temperature = sequence.max_temperature;
+        pipeline.configure(params_file);
+
+        // 录制序列没有云台/里程计数据，按静止处理，帧间运动由图像配准估计
+        const GimbalState gimbal;
+        const OdometryState odometry;
+        cv::Mat frame;
+        FrameResult result;
+        for (int f = 0; f < static_cast<int>(sequence.frame_paths.size()); ++f)
+        {
+            if (!readThermalFrame(sequence.frame_paths[f], frame) ||
+                !pipeline.processFrame(frame, gimbal, odometry, f * sequence.frame_interval_seconds, result))
+                continue;
+
+            const std::vector<cv::Rect> fire_boxes = sequence.fireBoxesForFrame(f);
+            for (const auto &spot : result.hot_spots)
+            {
+                cv::Mat row(1, BLOB_FEATURE_COUNT, CV_32FC1);
+                computeBlobFeatures(spot, row.ptr<float>());
+                bool is_fire = false;
+                for (const auto &box : fire_boxes)
+                    is_fire = is_fire || box.contains(cv::Point(cvRound(spot.pixel_centroid.x), cvRound(spot.pixel_centroid.y)));
+                dataset.features.push_back(row);
+                dataset.labels.push_back(is_fire ? 1.0f : 0.0f);
+                dataset.frame_keys.push_back(sequence_index * 1000000 + f);
+                dataset.sequence_ids.push_back(sequence_index);
+            }
+        }
+    }
+
+    bool collectDataset(const Options &options, Dataset &dataset)
+    {
+        std::vector<std::string> directories;
+        if (!readSequenceList(options.sequence_list, directories))
+            return false;
+        dataset.sequence_count = static_cast<int>(directories.size());
+        for (size_t i = 0; i < directories.size(); ++i)
+        {
+            RecordedSequence sequence;
+            if (!loadRecordedSequence(directories[i], sequence))
+                continue;
+            std::cout << "Processing " << directories[i] << " (" << sequence.frame_paths.size() << " frames)" << std::endl;
+            collectSequence(sequence, options.params_file, static_cast<int>(i), dataset);
+        }
+        std::cout << "Collected " << dataset.features.rows << " hotspot samples." << std::endl;
+        return dataset.features.rows > 0;
+    }
+
+    // 同一序列的帧高度相关，按样本交错划分会把近乎相同的样本同时放进训练集和验证集，因此按序列划分
+    bool isValidationSequence(int sequence_index, int sequence_count)
+    {
+        if (sequence_count < 2)
+            return false;
+        if (sequence_count < 5)
+            return sequence_index == sequence_count - 1;
+        return sequence_index % 5 == 4;
+    }
+
+    void splitDataset(const Dataset &all, Dataset &train, Dataset &validation)
+    {
+        if (all.sequence_count < 2)
+            std::cout << "Warning: Only one sequence, no validation set." << std::endl;
+        for (int i = 0; i < all.features.rows; ++i)
+        {
+            Dataset &target = isValidationSequence(all.sequence_ids[i], all.sequence_count) ? validation : train;
+            target.features.push_back(all.features.row(i));
+            target.labels.push_back(all.labels[i]);
+            target.frame_keys.push_back(all.frame_keys[i]);
+            target.sequence_ids.push_back(all.sequence_ids[i]);
+        }
+    }
+
+    // Adam 优化器状态
+    struct AdamParameter
+    {
+        cv::Mat value, m, v;
+
+        explicit AdamParameter(const cv::Mat &init) : value(init.clone()), m(cv::Mat::zeros(init.size(), CV_32F)), v(cv::Mat::zeros(init.size(), CV_32F)) {}
+
+        void step(const cv::Mat &gradient, float learning_rate, int t)
+        {
+            const float beta1 = 0.9f, beta2 = 0.999f, eps = 1e-8f;
+            m = beta1 * m + (1.0f - beta1) * gradient;
+            v = beta2 * v + (1.0f - beta2) * gradient.mul(gradient);
+            cv::Mat m_hat = m / (1.0f - std::pow(beta1, static_cast<float>(t)));
+            cv::Mat v_hat = v / (1.0f - std::pow(beta2, static_cast<float>(t)));
+            cv::Mat denom;
+            cv::sqrt(v_hat, denom);
+            value -= learning_rate * m_hat / (denom + eps);
+        }
+    };
+
+    // 单隐层 MLP，加权二元交叉熵 (正负样本等权)，全批量 Adam
+    void trainClassifier(const Dataset &train, const Options &options, BlobClassifier &classifier)
+    {
+        cv::Scalar mean, stddev;
+        cv::Mat feature_mean(1, BLOB_FEATURE_COUNT, CV_32F), feature_scale(1, BLOB_FEATURE_COUNT, CV_32F);
+        for (int j = 0; j < BLOB_FEATURE_COUNT; ++j)
+        {
+            cv::meanStdDev(train.features.col(j), mean, stddev);
+            feature_mean.at<float>(0, j) = static_cast<float>(mean[0]);
+            feature_scale.at<float>(0, j) = stddev[0] > 1e-6 ? static_cast<float>(1.0 / stddev[0]) : 1.0f;
+        }
+
+        const int n = train.features.rows;
+        cv::Mat x(train.features.size(), CV_32F);
+        for (int i = 0; i < n; ++i)
+            x.row(i) = (train.features.row(i) - feature_mean).mul(feature_scale);
+        cv::Mat y(n, 1, CV_32F, const_cast<float *>(train.labels.data()));
+
+        double positives = cv::sum(y)[0];
+        float w_pos = positives > 0.0 ? static_cast<float>(0.5 * n / positives) : 1.0f;
+        float w_neg = positives < n ? static_cast<float>(0.5 * n / (n - positives)) : 1.0f;
+        cv::Mat sample_weight(n, 1, CV_32F);
+        for (int i = 0; i < n; ++i)
+            sample_weight.at<float>(i) = train.labels[i] > 0.5f ? w_pos : w_neg;
+
+        cv::RNG rng(12345);
+        const int h = options.hidden_units;
+        cv::Mat w1_init(h, BLOB_FEATURE_COUNT, CV_32F), w2_init(1, h, CV_32F);
+        rng.fill(w1_init, cv::RNG::NORMAL, 0.0, std::sqrt(2.0 / BLOB_FEATURE_COUNT));
+        rng.fill(w2_init, cv::RNG::NORMAL, 0.0, std::sqrt(1.0 / h));
+        AdamParameter w1(w1_init), b1(cv::Mat::zeros(1, h, CV_32F));
+        AdamParameter w2(w2_init), b2(cv::Mat::zeros(1, 1, CV_32F));
+
+        const float learning_rate = 0.01f;
+        for (int epoch = 1; epoch <= options.epochs; ++epoch)
+        {
+            // 前向
+            cv::Mat hidden = x * w1.value.t() + cv::repeat(b1.value, n, 1);
+            cv::Mat active = hidden > 0;
+            hidden.setTo(0.0f, ~active);
+            cv::Mat logits = hidden * w2.value.t() + b2.value.at<float>(0);
+            cv::Mat prob;
+            cv::exp(-logits, prob);
+            prob = 1.0f / (1.0f + prob);
+
+            // 反向
+            cv::Mat dlogits = (prob - y).mul(sample_weight) / static_cast<float>(n);
+            cv::Mat dw2 = dlogits.t() * hidden;
+            cv::Mat db2(1, 1, CV_32F, cv::Scalar(cv::sum(dlogits)[0]));
+            cv::Mat dhidden = dlogits * w2.value;
+            dhidden.setTo(0.0f, ~active);
+            cv::Mat dw1 = dhidden.t() * x;
+            cv::Mat db1;
+            cv::reduce(dhidden, db1, 0, cv::REDUCE_SUM);
+
+            w1.step(dw1, learning_rate, epoch);
+            b1.step(db1, learning_rate, epoch);
+            w2.step(dw2, learning_rate, epoch);
+            b2.step(db2, learning_rate, epoch);
+
+            if (epoch % 100 == 0 || epoch == options.epochs)
+            {
+                cv::Mat log_p, log_q;
+                cv::log(prob + 1e-7f, log_p);
+                cv::log(1.0f - prob + 1e-7f, log_q);
+                double loss = -cv::sum((y.mul(log_p) + (1.0f - y).mul(log_q)).mul(sample_weight))[0] / n;
+                std::cout << "Epoch " << epoch << ", loss " << loss << std::endl;
+            }
+        }
+
+        std::vector<BlobClassifier::Layer> layers(2);
+        layers[0].weights = w1.value;
+        layers[0].bias = b1.value.t();
+        layers[1].weights = w2.value;
+        layers[1].bias = b2.value;
+        classifier.setModel(feature_mean, feature_scale, layers);
+    }
+
+    void evaluate(const BlobClassifier &classifier, const Dataset &data, const char *name)
+    {
+        if (data.features.empty())
+            return;
+
+        // 按帧分批推理，与主程序每帧一次批量调用的方式一致
+        cv::Mat probabilities;
+        int true_pos = 0, false_pos = 0, false_neg = 0, correct = 0, frames = 0;
+        double total_us = 0.0, max_us = 0.0;
+        int begin = 0;
+        while (begin < data.features.rows)
+        {
+            int end = begin;
+            while (end < data.features.rows && data.frame_keys[end] == data.frame_keys[begin])
+                ++end;
+            int64 start = cv::getTickCount();
+            classifier.predict(data.features.rowRange(begin, end), probabilities);
+            double us = (cv::getTickCount() - start) * 1e6 / cv::getTickFrequency();
+            total_us += us;
+            max_us = std::max(max_us, us);
+            ++frames;
+
+            for (int i = begin; i < end; ++i)
+            {
+                bool predicted = probabilities.at<float>(i - begin, 0) >= 0.5f;
+                bool actual = data.labels[i] > 0.5f;
+                correct += (predicted == actual);
+                true_pos += (predicted && actual);
+                false_pos += (predicted && !actual);
+                false_neg += (!predicted && actual);
+            }
+            begin = end;
+        }
+
+        const int n = data.features.rows;
+        double precision = true_pos + false_pos > 0 ? static_cast<double>(true_pos) / (true_pos + false_pos) : 0.0;
+        double recall = true_pos + false_neg > 0 ? static_cast<double>(true_pos) / (true_pos + false_neg) : 0.0;
+        std::cout << name << ": " << n << " samples, accuracy " << static_cast<double>(correct) / n
+                  << ", precision " << precision << ", recall " << recall << std::endl;
+        std::cout << name << ": inference " << total_us / frames << " us/frame (max " << max_us
+                  << " us, budget " << BLOB_CLASSIFIER_BUDGET_MICROSECONDS << " us)" << std::endl;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseArguments(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " <sequence_list> <model_out.yml> [--hidden N] [--epochs N] [--params params.xml]" << std::endl;
+        std::cerr << "       " << argv[0] << " --eval <model.yml> <sequence_list> [--params params.xml]" << std::endl;
+        return 1;
+    }
+
+    Dataset all;
+    if (!collectDataset(options, all))
+    {
+        std::cerr << "Error: No training samples collected." << std::endl;
+        return 1;
+    }
+
+    BlobClassifier classifier;
+    if (options.eval_only)
+    {
+        if (!classifier.load(options.model_file))
+            return 1;
+        evaluate(classifier, all, "Evaluation");
+        return 0;
+    }
+
+    Dataset train, validation;
+    splitDataset(all, train, validation);
+    if (train.features.empty())
+    {
+        std::cerr << "Error: No training samples after the validation split." << std::endl;
+        return 1;
+    }
+    trainClassifier(train, options, classifier);
+    evaluate(classifier, train, "Training");
+    evaluate(classifier, validation, "Validation");
+
+    if (!classifier.save(options.model_file))
+        return 1;
+    std::cout << "Model saved to " << options.model_file << std::endl;
+    return 0;
+}